@@ -0,0 +1,409 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+#include <sys/resource.h>
+
+/*
+ * Headless benchmark of the zoning pipeline: MS model, conformal model (grammar),
+ * zoning, SD-analysis of all zoned designs, stabilization, topology optimisation
+ * and (optionally) BP-simulation. For each stage the wall time, the peak resident
+ * set size of the process up to the end of the stage (ru_maxrss, which never decreases,
+ * so it is the peak of all stages and cases so far, not of the stage itself) and the
+ * number and size of the allocations are written as JSON.
+ *
+ * usage: benchmark [options]
+ *   --ms <file>          benchmark an MS input file (repeatable)
+ *   --synthetic <NxMxK>  benchmark a block of NxMxK spaces of 3x3x3 m (repeatable)
+ *   --bp <file>          add a BP-simulation stage of the given BP input file
+ *   --threads <n>        threads for the zoned SD-analyses (0: one per hardware thread)
+ *   --stab_rounds <n>    maximum number of stabilization rounds (default 50)
+ *   --topopt_tol <t>     convergence tolerance of the topology optimisation (default 0.05, 0: skip)
+ *   --topopt_loops <n>   maximum number of topology optimisation iterations (default 50)
+ *   --out <file>         JSON output file (default benchmark.json)
+ *
+ * Without --ms or --synthetic the bundled designs 1 to 4 and the synthetic blocks 3x3x2,
+ * 4x4x2 and 6x6x2 (72 spaces) are run; the 6x6x2 block dominates the run time.
+ * The BP-simulation needs a BP input file and its weather files, which are not bundled,
+ * so without --bp it is skipped, which is stated in the JSON output.
+ * The grammar reads its settings from files_zoning/ and files_stabilization/, which must
+ * be present in the working directory.
+ */
+
+// allocation counters, counted by the replaced global operator new (allocations made
+// through malloc directly, e.g. by Eigen's aligned allocator, are not counted)
+static std::atomic<unsigned long long> alloc_count(0);
+static std::atomic<unsigned long long> alloc_bytes(0);
+
+void* operator new(std::size_t size)
+{
+    alloc_count++;
+    alloc_bytes += size;
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+} // operator new()
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+} // operator delete()
+
+#include <BSO/Spatial_Design/Movable_Sizable.hpp>
+#include <BSO/Spatial_Design/Conformation.hpp>
+#include <BSO/Spatial_Design/Zoning.hpp>
+#include <BSO/Structural_Design/SD_Analysis.hpp>
+#include <AEI Grammar/Grammar_zoning.hpp>
+#include <BSO/Building_Physics/BP_Simulation.hpp>
+#include <BSO/Structural_Design/Stabilization/Stabilize.hpp>
+#include <BSO/Structural_Design/Topology_Optimisation/topopt_SIMP.hpp>
+#include <BSO/Performance_Indexing.hpp>
+
+struct Stage_Result
+{
+    std::string m_name;
+    double m_wall_ms;
+    long m_process_peak_rss_kb; // of the whole process up to the end of the stage, including all earlier stages and cases
+    unsigned long long m_allocations;
+    unsigned long long m_allocated_bytes;
+}; // Stage_Result
+
+struct Case_Result
+{
+    std::string m_name;
+    unsigned int m_space_count;
+    unsigned int m_zoned_designs;
+    double m_min_compliance;
+    unsigned int m_stab_rounds;
+    unsigned int m_free_dof_points; // left after stabilization
+    double m_heating_energy;
+    double m_cooling_energy;
+    std::vector<Stage_Result> m_stages;
+}; // Case_Result
+
+class Stage_Timer
+{ // measures one stage from construction until stop()
+private:
+    std::vector<Stage_Result>* m_stages;
+    std::string m_name;
+    std::chrono::steady_clock::time_point m_start;
+    unsigned long long m_count;
+    unsigned long long m_bytes;
+public:
+    Stage_Timer(std::vector<Stage_Result>* stages, std::string name)
+    {
+        m_stages = stages;
+        m_name = name;
+        m_count = alloc_count;
+        m_bytes = alloc_bytes;
+        m_start = std::chrono::steady_clock::now();
+    } // ctor
+
+    void stop()
+    {
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        Stage_Result result;
+        result.m_name = m_name;
+        result.m_wall_ms = std::chrono::duration<double, std::milli>(end - m_start).count();
+        result.m_process_peak_rss_kb = usage.ru_maxrss;
+        result.m_allocations = alloc_count - m_count;
+        result.m_allocated_bytes = alloc_bytes - m_bytes;
+        m_stages->push_back(result);
+    } // stop()
+}; // Stage_Timer
+
+BSO::Spatial_Design::MS_Building synthetic_building(unsigned int nx, unsigned int ny, unsigned int nz)
+{ // a block of nx by ny by nz spaces of 3000x3000x3000 mm
+    BSO::Spatial_Design::MS_Building MS;
+    int ID = 0;
+    for (unsigned int k = 0; k < nz; k++)
+    {
+        for (unsigned int j = 0; j < ny; j++)
+        {
+            for (unsigned int i = 0; i < nx; i++)
+            {
+                BSO::Spatial_Design::MS_Space space;
+                space.ID = ++ID;
+                space.width = 3000;
+                space.depth = 3000;
+                space.height = 3000;
+                space.x = 3000*i;
+                space.y = 3000*j;
+                space.z = 3000*k;
+                space.surfaces_given = false;
+                space.space_type_given = false;
+                MS.add_space(space);
+            }
+        }
+    }
+    return MS;
+} // synthetic_building()
+
+Case_Result run_case(std::string name, std::string synthetic,
+                     std::string bp_file, unsigned int n_threads, unsigned int max_rounds, double topopt_tol, unsigned int topopt_loops)
+{
+    Case_Result result;
+    result.m_name = name;
+    result.m_zoned_designs = 0;
+    result.m_min_compliance = 0;
+    result.m_stab_rounds = 0;
+    result.m_free_dof_points = 0;
+    result.m_heating_energy = 0;
+    result.m_cooling_energy = 0;
+
+    // MS model
+    Stage_Timer load_timer(&result.m_stages, "load");
+    BSO::Spatial_Design::MS_Building MS;
+    if (synthetic.empty())
+    {
+        MS = BSO::Spatial_Design::MS_Building(name);
+    }
+    else
+    {
+        unsigned int nx = 0, ny = 0, nz = 0;
+        if (std::sscanf(synthetic.c_str(), "%ux%ux%u", &nx, &ny, &nz) != 3 || nx*ny*nz == 0)
+        {
+            std::cerr << "Error, invalid synthetic building size \"" << synthetic
+                      << "\", exiting now... (Benchmark/main.cpp)" << std::endl;
+            exit(1);
+        }
+        MS = synthetic_building(nx, ny, nz);
+    }
+    load_timer.stop();
+    result.m_space_count = MS.obtain_space_count();
+
+    // conformal model
+    Stage_Timer conformal_timer(&result.m_stages, "conformal");
+    BSO::Spatial_Design::MS_Conformal CF(MS, &(BSO::Grammar::grammar_zoning));
+    CF.make_conformal();
+    conformal_timer.stop();
+
+    // zoning
+    Stage_Timer zoning_timer(&result.m_stages, "zoning");
+    BSO::Spatial_Design::Zoning::Zoned_Design Zoned(&CF);
+    Zoned.make_zoning();
+    zoning_timer.stop();
+
+    // SD-analysis of all zoned designs
+    Stage_Timer sd_timer(&result.m_stages, "sd_zoned");
+    std::vector<BSO::Spatial_Design::Zoning::Zoned_SD_Results> zoned_results = Zoned.analyse_zoned_designs(n_threads);
+    sd_timer.stop();
+    result.m_zoned_designs = zoned_results.size();
+
+    unsigned int best = 0;
+    for (unsigned int i = 1; i < zoned_results.size(); i++)
+    {
+        if (zoned_results[i].m_total_compliance < zoned_results[best].m_total_compliance)
+        {
+            best = i;
+        }
+    }
+    if (!zoned_results.empty())
+    {
+        result.m_min_compliance = zoned_results[best].m_total_compliance;
+    }
+
+    // stabilization of the best zoned design (or the unzoned design if no zoned designs were found)
+    Stage_Timer stab_timer(&result.m_stages, "stabilization");
+    Zoned.reset_SD_model();
+    if (zoned_results.empty())
+    {
+        Zoned.prepare_unzoned_SD_model();
+    }
+    else
+    {
+        Zoned.prepare_zoned_SD_model(best);
+    }
+    BSO::Structural_Design::SD_Analysis SD_Building(CF);
+    unsigned int mesh_division = SD_Building.m_mesh_division; // get_points_with_free_dofs() meshes in one division
+    std::map<BSO::Structural_Design::Components::Point*, std::vector<unsigned int> > free_dofs =
+        SD_Building.get_points_with_free_dofs(2);
+    if (!free_dofs.empty())
+    {
+        BSO::Structural_Design::Stabilization::Stabilize Stab(&SD_Building, &CF);
+        while (!free_dofs.empty() && result.m_stab_rounds < max_rounds)
+        {
+            result.m_stab_rounds++;
+            Stab.update_free_dofs(free_dofs);
+            Stab.stabilize_free_dofs(0);
+            SD_Building.remesh();
+            free_dofs = SD_Building.get_points_with_free_dofs(2);
+        }
+    }
+    result.m_free_dof_points = free_dofs.size();
+    SD_Building.mesh(mesh_division);
+    SD_Building.analyse();
+    stab_timer.stop();
+
+    // topology optimisation of the stabilized design
+    if (topopt_tol > 0)
+    {
+        Stage_Timer topopt_timer(&result.m_stages, "topopt");
+        BSO::Structural_Design::topopt_SIMP(SD_Building.get_FEA_ptr(), 0.5, 1000, 3, 0.2, topopt_tol, topopt_loops);
+        topopt_timer.stop();
+    }
+
+    // BP-simulation
+    if (!bp_file.empty())
+    {
+        Stage_Timer bp_timer(&result.m_stages, "bp");
+        BSO::Building_Physics::BP_Simulation BP_Building(bp_file);
+        BP_Building.sim_period();
+        BSO::Building_Physics::BP_Building_Results bp_results = BP_Building.get_results();
+        bp_timer.stop();
+        result.m_heating_energy = bp_results.m_total_heating_energy;
+        result.m_cooling_energy = bp_results.m_total_cooling_energy;
+    }
+
+    return result;
+} // run_case()
+
+std::string json_string(std::string s)
+{ // quotes s and escapes backslashes and quotes
+    std::string quoted = "\"";
+    for (unsigned int i = 0; i < s.size(); i++)
+    {
+        if (s[i] == '"' || s[i] == '\\')
+        {
+            quoted += '\\';
+        }
+        quoted += s[i];
+    }
+    return quoted + "\"";
+} // json_string()
+
+void write_json(std::string file_name, const std::vector<Case_Result>& cases, unsigned int n_threads, std::string bp_file)
+{
+    std::ofstream output(file_name.c_str());
+    if (!output)
+    {
+        std::cerr << "Error, could not open \"" << file_name << "\", exiting now... (Benchmark/main.cpp)" << std::endl;
+        exit(1);
+    }
+    output.precision(10);
+
+    output << "{" << std::endl
+           << "  \"benchmark\": \"zoning pipeline\"," << std::endl
+           << "  \"threads\": " << n_threads << "," << std::endl
+           << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << "," << std::endl
+           << "  \"bp_simulation\": " << (bp_file.empty() ? "\"skipped, no BP input given (--bp)\"" : json_string(bp_file)) << "," << std::endl
+           << "  \"cases\": [" << std::endl;
+    for (unsigned int i = 0; i < cases.size(); i++)
+    {
+        const Case_Result& c = cases[i];
+        output << "    {" << std::endl
+               << "      \"name\": " << json_string(c.m_name) << "," << std::endl
+               << "      \"spaces\": " << c.m_space_count << "," << std::endl
+               << "      \"zoned_designs\": " << c.m_zoned_designs << "," << std::endl
+               << "      \"min_compliance\": " << c.m_min_compliance << "," << std::endl
+               << "      \"stabilization_rounds\": " << c.m_stab_rounds << "," << std::endl
+               << "      \"free_dof_points\": " << c.m_free_dof_points << "," << std::endl;
+        if (bp_file.empty())
+        { // no BP-simulation was run, so there are no energies
+            output << "      \"heating_energy\": null," << std::endl
+                   << "      \"cooling_energy\": null," << std::endl;
+        }
+        else
+        {
+            output << "      \"heating_energy\": " << c.m_heating_energy << "," << std::endl
+                   << "      \"cooling_energy\": " << c.m_cooling_energy << "," << std::endl;
+        }
+        output << "      \"stages\": [" << std::endl;
+        for (unsigned int j = 0; j < c.m_stages.size(); j++)
+        {
+            const Stage_Result& s = c.m_stages[j];
+            output << "        {\"stage\": " << json_string(s.m_name)
+                   << ", \"wall_ms\": " << s.m_wall_ms
+                   << ", \"process_peak_rss_kb\": " << s.m_process_peak_rss_kb
+                   << ", \"allocations\": " << s.m_allocations
+                   << ", \"allocated_bytes\": " << s.m_allocated_bytes << "}"
+                   << ((j + 1 < c.m_stages.size()) ? "," : "") << std::endl;
+        }
+        output << "      ]" << std::endl
+               << "    }" << ((i + 1 < cases.size()) ? "," : "") << std::endl;
+    }
+    output << "  ]" << std::endl
+           << "}" << std::endl;
+} // write_json()
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> ms_files;
+    std::vector<std::string> synthetic_sizes;
+    std::string bp_file;
+    std::string out_file = "benchmark.json";
+    unsigned int n_threads = 0;
+    unsigned int max_rounds = 50;
+    double topopt_tol = 0.05;
+    unsigned int topopt_loops = 50;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Error, missing value after \"" << arg << "\", exiting now... (Benchmark/main.cpp)" << std::endl;
+            exit(1);
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--ms") ms_files.push_back(value);
+        else if (arg == "--synthetic") synthetic_sizes.push_back(value);
+        else if (arg == "--bp") bp_file = value;
+        else if (arg == "--threads") n_threads = std::atoi(value.c_str());
+        else if (arg == "--stab_rounds") max_rounds = std::atoi(value.c_str());
+        else if (arg == "--topopt_tol") topopt_tol = std::atof(value.c_str());
+        else if (arg == "--topopt_loops") topopt_loops = std::atoi(value.c_str());
+        else if (arg == "--out") out_file = value;
+        else
+        {
+            std::cerr << "Error, unknown argument \"" << arg << "\", exiting now... (Benchmark/main.cpp)" << std::endl;
+            exit(1);
+        }
+    }
+
+    if (ms_files.empty() && synthetic_sizes.empty())
+    { // the bundled designs and three scaled-up synthetic buildings
+        ms_files.push_back("../Zoning_1_W/MS_Input.txt");
+        ms_files.push_back("../Zoning_2_6m_W/MS_Input.txt");
+        ms_files.push_back("../Zoning_2_9m_W/MS_Input.txt");
+        ms_files.push_back("../Zoning_3_W/MS_Input.txt");
+        ms_files.push_back("../Zoning_4_W/MS_Input.txt");
+        synthetic_sizes.push_back("3x3x2");
+        synthetic_sizes.push_back("4x4x2");
+        synthetic_sizes.push_back("6x6x2");
+    }
+
+    if (bp_file.empty())
+    {
+        std::cout << "No BP input given (--bp), the BP-simulation is skipped" << std::endl;
+    }
+
+    std::vector<Case_Result> cases;
+    for (unsigned int i = 0; i < ms_files.size(); i++)
+    {
+        cases.push_back(run_case(ms_files[i], "", bp_file, n_threads, max_rounds, topopt_tol, topopt_loops));
+    }
+    for (unsigned int i = 0; i < synthetic_sizes.size(); i++)
+    {
+        cases.push_back(run_case("synthetic_" + synthetic_sizes[i], synthetic_sizes[i], bp_file, n_threads, max_rounds, topopt_tol, topopt_loops));
+    }
+
+    write_json(out_file, cases, n_threads, bp_file);
+    std::cout << std::endl << "Wrote benchmark results to " << out_file << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,435 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <cstdlib>
+
+/*
+ * Scaling benchmark and check of the space and cluster ordering of the heuristics
+ * (select_worst_spaces() and rank_clusters() in Heuristics.hpp) on synthetic buildings
+ * of thousands of spaces.
+ *
+ * For each building size and seed the selection of each scale_and_subdivide heuristic
+ * is compared to the ordering of the previous implementation (insertion into an ordered
+ * list, then walking it until the first space beyond the tolerance), and the cluster
+ * ranking to the previous repeated search for the furthest cluster. The selections are
+ * written as text and must be byte-identical. The scores are quantised, so that there
+ * are many equal scores and many scores within the tolerance of each other. Next to
+ * that a few small cases fix the semantics of ties and of the tolerance. Finally the
+ * heuristics themselves are timed on the largest building.
+ *
+ * usage: heuristics_benchmark [options]
+ *   --spaces <n>     benchmark a building of n spaces (repeatable)
+ *   --seeds <n>      number of random score sets per building (default 3)
+ *   --out <file>     JSON output file (default heuristics_benchmark.json)
+ *
+ * Without --spaces buildings of 100, 1000, 4000 and 8000 spaces are run. The program
+ * exits with 1 if any of the checks fails.
+ */
+
+#include <BSO/Spatial_Design/Movable_Sizable.hpp>
+#include <BSO/Structural_Design/SD_Analysis.hpp>
+#include <BSO/Building_Physics/BP_Simulation.hpp>
+#include <BSO/Heuristics.hpp>
+
+struct Ordering_Case
+{
+    const char* m_heuristic;
+    double m_tolerance;
+    bool m_high_is_worst;
+    bool m_whole_scores; // deletion counts, which the previous code compared for equality instead of within the tolerance
+}; // Ordering_Case
+
+const Ordering_Case ordering_cases[] = {
+    {"scale_and_subdivide_1", 1.0, true, true},
+    {"scale_and_subdivide_2", 0.0001, false, false},
+    {"BP_scale_and_subdivide", 0.01, false, false},
+    {"combined_scale_and_subdivide", 0.01, false, false}
+};
+const unsigned int ordering_case_count = sizeof(ordering_cases)/sizeof(ordering_cases[0]);
+
+struct Size_Result
+{
+    unsigned int m_space_count;
+    unsigned int m_mismatches;
+    double m_select_ms; // select_worst_spaces(), all heuristics and seeds
+    double m_previous_select_ms; // the previous ordering, all heuristics and seeds
+    double m_rank_ms;
+    double m_previous_rank_ms;
+}; // Size_Result
+
+std::vector<int> previous_worst_spaces(std::map<int, double>& performances, unsigned int count, const Ordering_Case& ordering)
+{ // the selection of the scale_and_subdivide heuristics before select_worst_spaces()
+    std::vector<int> space_performances_ordered;
+    for (std::map<int, double>::iterator ite = performances.begin(); ite != performances.end(); ite++)
+    { // insert each space before the first space that performs better
+        bool space_inserted = false;
+        for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
+        {
+            double other = performances[space_performances_ordered[i]];
+            if (ordering.m_high_is_worst ? (ite->second > other) : (ite->second < other))
+            {
+                space_performances_ordered.insert(space_performances_ordered.begin() + i, ite->first);
+                space_inserted = true;
+                break;
+            }
+        }
+        if (!space_inserted)
+        {
+            space_performances_ordered.push_back(ite->first);
+        }
+    }
+
+    std::vector<int> deleted_spaces;
+    double critical_performance = 0;
+    for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
+    {
+        double performance = performances[space_performances_ordered[i]];
+        if (i < count - 1)
+        {
+            deleted_spaces.push_back(space_performances_ordered[i]);
+        }
+        else if (i == count - 1)
+        {
+            critical_performance = performance;
+            deleted_spaces.push_back(space_performances_ordered[i]);
+        }
+        else if (ordering.m_whole_scores ? (performance == critical_performance) :
+                 ((ordering.m_high_is_worst ? critical_performance - performance : performance - critical_performance) < ordering.m_tolerance))
+        {
+            deleted_spaces.push_back(space_performances_ordered[i]);
+        }
+        else
+        {
+            break;
+        }
+    }
+    return deleted_spaces;
+} // previous_worst_spaces()
+
+std::vector<unsigned int> previous_cluster_ranking(std::vector<std::shared_ptr<BSO::Cluster> > clusters, const std::vector<std::shared_ptr<BSO::Cluster> >& all_clusters)
+{ // the order in which the cluster heuristics removed the clusters before rank_clusters(): the furthest remaining cluster, the first one if several are equally far
+    std::vector<unsigned int> ranking;
+    while (!clusters.empty())
+    {
+        double max_distance = 0;
+        unsigned int furthest_cluster = 0;
+        for (unsigned int i = 0; i < clusters.size(); i++)
+        {
+            if (max_distance < clusters[i]->m_dist_from_origin)
+            {
+                max_distance = clusters[i]->m_dist_from_origin;
+                furthest_cluster = i;
+            }
+        }
+        for (unsigned int i = 0; i < all_clusters.size(); i++)
+        {
+            if (all_clusters[i] == clusters[furthest_cluster])
+            {
+                ranking.push_back(i);
+            }
+        }
+        clusters.erase(clusters.begin() + furthest_cluster);
+    }
+    return ranking;
+} // previous_cluster_ranking()
+
+template <typename T>
+std::string write_list(const std::vector<T>& list)
+{
+    std::ostringstream text;
+    for (unsigned int i = 0; i < list.size(); i++)
+    {
+        text << list[i] << "\n";
+    }
+    return text.str();
+} // write_list()
+
+std::map<int, double> random_performances(unsigned int space_count, const Ordering_Case& ordering, std::mt19937& generator)
+{ // quantised scores, so that many spaces perform equally and many lie within the tolerance of each other
+    std::uniform_int_distribution<int> level(0, 40), offset(0, 3), count(0, 20);
+    std::map<int, double> performances;
+    for (unsigned int i = 0; i < space_count; i++)
+    {
+        performances[i + 1] = ordering.m_whole_scores ? (double)count(generator) :
+                              level(generator)*0.025 + offset(generator)*0.4*ordering.m_tolerance;
+    }
+    return performances;
+} // random_performances()
+
+Size_Result run_size(unsigned int space_count, unsigned int seeds)
+{ // compares the selections and cluster rankings with the previous implementation and times both
+    Size_Result result = {space_count, 0, 0, 0, 0, 0};
+    for (unsigned int seed = 0; seed < seeds; seed++)
+    {
+        std::mt19937 generator(seed);
+        for (unsigned int i = 0; i < ordering_case_count; i++)
+        {
+            std::map<int, double> performances = random_performances(space_count, ordering_cases[i], generator);
+            unsigned int count = space_count - space_count/2;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::vector<int> selected = BSO::select_worst_spaces(BSO::space_scores(performances), count,
+                                                                 ordering_cases[i].m_tolerance, ordering_cases[i].m_high_is_worst);
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            result.m_select_ms += std::chrono::duration<double, std::milli>(end - start).count();
+
+            start = std::chrono::steady_clock::now();
+            std::vector<int> previous = previous_worst_spaces(performances, count, ordering_cases[i]);
+            end = std::chrono::steady_clock::now();
+            result.m_previous_select_ms += std::chrono::duration<double, std::milli>(end - start).count();
+
+            if (write_list(selected) != write_list(previous))
+            {
+                std::cerr << "Mismatch in the selection of " << ordering_cases[i].m_heuristic << " for "
+                          << space_count << " spaces, seed " << seed << std::endl;
+                result.m_mismatches++;
+            }
+        }
+
+        // clusters with few distinct distances, as the heuristics make between 6 and 10 clusters the count is scaled up here
+        std::uniform_int_distribution<int> distance(0, 50);
+        std::vector<std::shared_ptr<BSO::Cluster> > clusters;
+        for (unsigned int i = 0; i < space_count/10 + 2; i++)
+        {
+            clusters.push_back(std::make_shared<BSO::Cluster>(BSO::data_point::Zero(2), std::weak_ptr<std::vector<BSO::data_point> >()));
+            clusters.back()->m_dist_from_origin = distance(generator)*0.5;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<unsigned int> ranking = BSO::rank_clusters(clusters);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        result.m_rank_ms += std::chrono::duration<double, std::milli>(end - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<unsigned int> previous_ranking = previous_cluster_ranking(clusters, clusters);
+        end = std::chrono::steady_clock::now();
+        result.m_previous_rank_ms += std::chrono::duration<double, std::milli>(end - start).count();
+
+        if (write_list(ranking) != write_list(previous_ranking))
+        {
+            std::cerr << "Mismatch in the cluster ranking for " << space_count << " spaces, seed " << seed << std::endl;
+            result.m_mismatches++;
+        }
+    }
+    return result;
+} // run_size()
+
+unsigned int check_selection(std::string name, std::vector<BSO::space_score> scores, unsigned int count, double tolerance,
+                             bool high_is_worst, std::vector<int> expected)
+{ // returns 1 if select_worst_spaces() does not select the expected spaces in the expected order
+    std::vector<int> selected = BSO::select_worst_spaces(scores, count, tolerance, high_is_worst);
+    if (selected == expected)
+    {
+        return 0;
+    }
+    std::cerr << "Failed semantics check \"" << name << "\", selected:";
+    for (unsigned int i = 0; i < selected.size(); i++)
+    {
+        std::cerr << " " << selected[i];
+    }
+    std::cerr << std::endl;
+    return 1;
+} // check_selection()
+
+unsigned int check_semantics()
+{ // the behaviour of select_worst_spaces() for ties and the tolerance, returns the number of failed checks
+    unsigned int failures = 0;
+    std::vector<BSO::space_score> scores = {{4, 5.0}, {2, 1.0}, {3, 5.0}, {1, 5.0}, {5, 2.0}};
+
+    // equal scores are ordered by ascending ID, whatever their order in the input
+    failures += check_selection("ties by ID", scores, 1, 0.0, true, {1});
+    // spaces with the same score as the last selected space are added, for any tolerance above 0
+    failures += check_selection("ties at the boundary", scores, 2, 1.0, true, {1, 3, 4});
+    // with a tolerance of 0 only 'count' spaces are selected, even if the next one performs the same
+    failures += check_selection("zero tolerance", scores, 2, 0.0, true, {1, 3});
+    // the tolerance is strict: a space exactly 'tolerance' better than the last selected space is not added
+    failures += check_selection("strict tolerance", scores, 4, 1.0, true, {1, 3, 4, 5});
+    failures += check_selection("within tolerance", scores, 4, 1.5, true, {1, 3, 4, 5, 2});
+    // if low scores are worst the order and the tolerance are mirrored
+    failures += check_selection("low is worst", scores, 1, 1.5, false, {2, 5});
+    failures += check_selection("low is worst ties", scores, 3, 0.5, false, {2, 5, 1, 3, 4});
+    // the count is limited to the number of spaces, and a count of 0 selects nothing
+    failures += check_selection("count above size", scores, 9, 0.0, true, {1, 3, 4, 5, 2});
+    failures += check_selection("zero count", scores, 0, 10.0, true, {});
+    failures += check_selection("no spaces", {}, 3, 1.0, true, {});
+
+    // clusters at the same distance keep their order
+    std::vector<std::shared_ptr<BSO::Cluster> > clusters;
+    double distances[] = {1.0, 3.0, 1.0, 3.0, 0.0};
+    for (unsigned int i = 0; i < 5; i++)
+    {
+        clusters.push_back(std::make_shared<BSO::Cluster>(BSO::data_point::Zero(2), std::weak_ptr<std::vector<BSO::data_point> >()));
+        clusters.back()->m_dist_from_origin = distances[i];
+    }
+    if (BSO::rank_clusters(clusters) != std::vector<unsigned int>({1, 3, 0, 2, 4}))
+    {
+        std::cerr << "Failed semantics check \"cluster ties\"" << std::endl;
+        failures++;
+    }
+    return failures;
+} // check_semantics()
+
+std::map<std::string, double> time_heuristics(unsigned int space_count)
+{ // times the heuristics that use select_worst_spaces() on a square building of space_count spaces
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> level(0, 40), count(0, 20);
+    BSO::Spatial_Design::MS_Building MS;
+    BSO::Structural_Design::SD_Building_Results sd_results;
+    BSO::Building_Physics::BP_Building_Results bp_results;
+    unsigned int n_x = (unsigned int)std::sqrt((double)space_count);
+    for (unsigned int i = 0; i < space_count; i++)
+    {
+        BSO::Spatial_Design::MS_Space space;
+        space.ID = i + 1;
+        space.width = 3000;
+        space.depth = 3000;
+        space.height = 3000;
+        space.x = 3000*(i % n_x);
+        space.y = 3000*(i / n_x);
+        space.z = 0;
+        space.surfaces_given = false;
+        space.space_type_given = false;
+        MS.add_space(space);
+
+        BSO::Structural_Design::SD_Space_Results sd_space;
+        sd_space.m_ID = space.ID;
+        sd_space.m_deletion_count = count(generator);
+        sd_space.m_rel_performance = level(generator)*0.025;
+        sd_space.m_total_compliance = level(generator);
+        sd_results.m_spaces.push_back(sd_space);
+
+        BSO::Building_Physics::BP_Space_Results bp_space;
+        bp_space.m_space_ID = std::to_string(space.ID);
+        bp_space.m_rel_performance = level(generator)*0.025;
+        bp_space.m_total_energy = level(generator) + 1;
+        bp_results.m_space_results.push_back(bp_space);
+    }
+
+    std::map<std::string, double> times;
+    for (unsigned int i = 0; i < 5; i++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        switch (i)
+        {
+            case 0: BSO::scale_and_subdivide_1(MS, sd_results); break;
+            case 1: BSO::scale_and_subdivide_2(MS, sd_results); break;
+            case 2: BSO::BP_scale_and_subdivide(MS, bp_results); break;
+            case 3: BSO::combined_scale_and_subdivide(MS, bp_results, sd_results); break;
+            case 4: BSO::change_1_space(MS, bp_results, sd_results, 0); break;
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        const char* names[] = {"scale_and_subdivide_1", "scale_and_subdivide_2", "BP_scale_and_subdivide", "combined_scale_and_subdivide", "change_1_space"};
+        times[names[i]] = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+    return times;
+} // time_heuristics()
+
+void write_json(std::string file_name, const std::vector<Size_Result>& sizes, unsigned int seeds, unsigned int semantics_failures,
+                unsigned int heuristics_spaces, const std::map<std::string, double>& heuristics_times)
+{
+    std::ofstream output(file_name.c_str());
+    if (!output)
+    {
+        std::cerr << "Error, could not open \"" << file_name << "\", exiting now... (Heuristics_Benchmark/main.cpp)" << std::endl;
+        exit(1);
+    }
+    output.precision(10);
+
+    output << "{" << std::endl
+           << "  \"benchmark\": \"heuristics ordering\"," << std::endl
+           << "  \"seeds\": " << seeds << "," << std::endl
+           << "  \"semantics_failures\": " << semantics_failures << "," << std::endl
+           << "  \"sizes\": [" << std::endl;
+    for (unsigned int i = 0; i < sizes.size(); i++)
+    {
+        const Size_Result& s = sizes[i];
+        output << "    {\"spaces\": " << s.m_space_count
+               << ", \"mismatches\": " << s.m_mismatches
+               << ", \"select_ms\": " << s.m_select_ms
+               << ", \"previous_select_ms\": " << s.m_previous_select_ms
+               << ", \"rank_ms\": " << s.m_rank_ms
+               << ", \"previous_rank_ms\": " << s.m_previous_rank_ms << "}"
+               << ((i + 1 < sizes.size()) ? "," : "") << std::endl;
+    }
+    output << "  ]," << std::endl
+           << "  \"heuristics\": {\"spaces\": " << heuristics_spaces;
+    for (std::map<std::string, double>::const_iterator ite = heuristics_times.begin(); ite != heuristics_times.end(); ite++)
+    {
+        output << ", \"" << ite->first << "_ms\": " << ite->second;
+    }
+    output << "}" << std::endl
+           << "}" << std::endl;
+} // write_json()
+
+int main(int argc, char* argv[])
+{
+    std::vector<unsigned int> space_counts;
+    unsigned int seeds = 3;
+    std::string out_file = "heuristics_benchmark.json";
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Error, missing value after \"" << arg << "\", exiting now... (Heuristics_Benchmark/main.cpp)" << std::endl;
+            exit(1);
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--spaces") space_counts.push_back(std::atoi(value.c_str()));
+        else if (arg == "--seeds") seeds = std::atoi(value.c_str());
+        else if (arg == "--out") out_file = value;
+        else
+        {
+            std::cerr << "Error, unknown argument \"" << arg << "\", exiting now... (Heuristics_Benchmark/main.cpp)" << std::endl;
+            exit(1);
+        }
+    }
+
+    if (space_counts.empty())
+    {
+        space_counts.push_back(100);
+        space_counts.push_back(1000);
+        space_counts.push_back(4000);
+        space_counts.push_back(8000);
+    }
+
+    unsigned int semantics_failures = check_semantics();
+
+    std::vector<Size_Result> sizes;
+    unsigned int mismatches = 0;
+    unsigned int largest = 0;
+    for (unsigned int i = 0; i < space_counts.size(); i++)
+    {
+        if (space_counts[i] < 2)
+        {
+            std::cerr << "Error, a building needs at least 2 spaces, exiting now... (Heuristics_Benchmark/main.cpp)" << std::endl;
+            exit(1);
+        }
+        sizes.push_back(run_size(space_counts[i], seeds));
+        mismatches += sizes.back().m_mismatches;
+        largest = std::max(largest, space_counts[i]);
+        std::cout << space_counts[i] << " spaces: select " << sizes.back().m_select_ms << " ms (previous "
+                  << sizes.back().m_previous_select_ms << " ms), " << sizes.back().m_mismatches << " mismatches" << std::endl;
+    }
+
+    std::map<std::string, double> heuristics_times = time_heuristics(largest);
+
+    write_json(out_file, sizes, seeds, semantics_failures, largest, heuristics_times);
+    std::cout << std::endl << "Wrote benchmark results to " << out_file << std::endl;
+
+    if (semantics_failures > 0 || mismatches > 0)
+    {
+        std::cerr << "Error, " << semantics_failures << " semantics checks failed and " << mismatches
+                  << " orderings differ from the previous implementation (Heuristics_Benchmark/main.cpp)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+#ifndef BP_OBSERVER_HPP
+#define BP_OBSERVER_HPP
+
+#include <BSO/Building_Physics/States/Dep_States/BP_Space.hpp>
+#include <BSO/Building_Physics/States/Dep_States/BP_Wall.hpp>
+#include <BSO/Building_Physics/States/Dep_States/BP_window.hpp>
+#include <BSO/Building_Physics/States/Dep_States/BP_Floor.hpp>
+#include <BSO/Building_Physics/States/Indep_States/BP_Weather_Profile.hpp>
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace BSO { namespace Building_Physics {
+
+    /*
+     * BP_Observer writes the results of a simulation period to a file, it is called
+     * by BP_Simulation::Observer_function() after each time step. Each output step
+     * holds one row of columns: the outdoor temperature, the temperature, heating and
+     * cooling power of each space and the temperatures of the walls, floors and windows.
+     * The heating/cooling bookkeeping is done by BP_Simulation, so an observer is only
+     * created when results are written (output::NONE has no observer at all).
+     */
+
+    // Class definitions:
+
+    class BP_Observer
+    {
+    protected:
+        BP_Simulation* m_system;
+        std::vector<std::string> m_column_names;
+        std::vector<double> m_row; // the columns of the current output step
+
+        void fill_row(const BP_Period_Context& context);
+    public:
+        BP_Observer(BP_Simulation* system);
+        virtual ~BP_Observer();
+
+        virtual void observe(const BP_Period_Context& context, double t) = 0;
+        virtual void end() = 0; // writes what is left and closes the file
+    }; // BP_Observer
+
+    class BP_Text_Observer : public BP_Observer
+    { // every output step as a line of comma separated values
+    private:
+        std::ofstream m_stream;
+    public:
+        BP_Text_Observer(BP_Simulation* system, std::string file_name);
+        void observe(const BP_Period_Context& context, double t);
+        void end();
+    }; // BP_Text_Observer
+
+    class BP_Binary_Observer : public BP_Observer
+    { // every output step in blocks of columns: the header holds the magic "BSO_OBS", the version, the column count and the column
+      // names (each a uint32 length and the characters), then each block holds the number of rows (uint32), the time stamps of the
+      // rows (int64, seconds since 1970) and the values of each column in turn (doubles)
+    private:
+        std::ofstream m_stream;
+        unsigned int m_block_size;
+        std::vector<int64_t> m_times;
+        std::vector<std::vector<double> > m_columns;
+
+        void write_block();
+    public:
+        BP_Binary_Observer(BP_Simulation* system, std::string file_name, unsigned int block_size = 4096);
+        void observe(const BP_Period_Context& context, double t);
+        void end();
+    }; // BP_Binary_Observer
+
+    class BP_Hourly_Observer : public BP_Observer
+    { // the mean of each column over the output steps in every hour, as a line of comma separated values per hour
+    private:
+        std::ofstream m_stream;
+        long long m_hour; // the hour (since 1970) of the sums, -1 if there are none
+        unsigned int m_count;
+        std::vector<double> m_sums;
+
+        void write_hour();
+    public:
+        BP_Hourly_Observer(BP_Simulation* system, std::string file_name);
+        void observe(const BP_Period_Context& context, double t);
+        void end();
+    }; // BP_Hourly_Observer
+
+
+
+    // Implementation of member functions:
+
+    BP_Observer::BP_Observer(BP_Simulation* system)
+    {
+        m_system = system;
+
+        m_column_names.push_back("Te");
+        for (auto i : m_system->m_space_ptrs) // the spaces
+        {
+            m_column_names.push_back("T_space_" + i->get_ID());   // temperature
+            m_column_names.push_back("Qh_space_" + i->get_ID()); // active heating power
+            m_column_names.push_back("Qc_space_" + i->get_ID()); // active cooling power
+        }
+        for (auto i : m_system->m_wall_ptrs) // the walls
+            m_column_names.push_back("T_wall_" + i->get_ID());
+        for (auto i : m_system->m_floor_ptrs) // the floors
+            m_column_names.push_back("T_floor_" + i->get_ID());
+        for (auto i : m_system->m_window_ptrs) // the windows
+            m_column_names.push_back("T_window_" + i->get_ID());
+
+        m_row.resize(m_column_names.size());
+    } // ctor
+
+    BP_Observer::~BP_Observer()
+    {
+
+    } // dtor
+
+    void BP_Observer::fill_row(const BP_Period_Context& context)
+    {
+        unsigned int n = 0;
+        m_row[n++] = context.m_SS_u(m_system->m_weather_profile->get_index());
+        for (auto i : m_system->m_space_ptrs)
+        {
+            unsigned int space_index = i->get_index();
+            double Q = context.m_SS_B.coeff(space_index,0) * i->get_capacitance();
+            m_row[n++] = context.m_SS_x(space_index); // space temperature
+            m_row[n++] = (Q >= 0) ? Q : 0; // heating power
+            m_row[n++] = (Q < 0) ? -Q : 0; // cooling power
+        }
+        for (auto i : m_system->m_wall_ptrs)
+            m_row[n++] = context.m_SS_x(i->get_index());
+        for (auto i : m_system->m_floor_ptrs)
+            m_row[n++] = context.m_SS_x(i->get_index());
+        for (auto i : m_system->m_window_ptrs)
+            m_row[n++] = context.m_SS_x(i->get_index());
+    } // fill_row()
+
+    BP_Text_Observer::BP_Text_Observer(BP_Simulation* system, std::string file_name) : BP_Observer(system)
+    {
+        m_stream.open(file_name.c_str());
+        m_stream << "Time";
+        for (unsigned int i = 0; i < m_column_names.size(); i++)
+            m_stream << "," << m_column_names[i];
+        m_stream << std::endl;
+    } // ctor
+
+    void BP_Text_Observer::observe(const BP_Period_Context& context, double t)
+    {
+        fill_row(context);
+        m_stream << (context.m_sim_begin + boost::posix_time::seconds((long)t));
+        for (unsigned int i = 0; i < m_row.size(); i++)
+            m_stream << "," << m_row[i];
+        m_stream << std::endl;
+    } // observe()
+
+    void BP_Text_Observer::end()
+    {
+        if (m_stream.is_open()) m_stream.close();
+    } // end()
+
+    BP_Binary_Observer::BP_Binary_Observer(BP_Simulation* system, std::string file_name, unsigned int block_size) : BP_Observer(system)
+    {
+        m_block_size = block_size;
+        m_times.reserve(m_block_size);
+        m_columns.resize(m_column_names.size());
+        for (unsigned int i = 0; i < m_columns.size(); i++)
+            m_columns[i].reserve(m_block_size);
+
+        m_stream.open(file_name.c_str(), std::ios::binary);
+        if (!m_stream)
+        {
+            std::cerr << "Error, could not open observer file \"" << file_name << "\", exiting now... (BP_Observer.hpp)" << std::endl;
+            exit(1);
+        }
+        const char magic[8] = "BSO_OBS";
+        uint32_t version = 1, column_count = m_column_names.size();
+        m_stream.write(magic, sizeof(magic));
+        m_stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        m_stream.write(reinterpret_cast<const char*>(&column_count), sizeof(column_count));
+        for (unsigned int i = 0; i < m_column_names.size(); i++)
+        {
+            uint32_t length = m_column_names[i].size();
+            m_stream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            m_stream.write(m_column_names[i].data(), length);
+        }
+    } // ctor
+
+    void BP_Binary_Observer::write_block()
+    {
+        if (m_times.empty()) return;
+        uint32_t row_count = m_times.size();
+        m_stream.write(reinterpret_cast<const char*>(&row_count), sizeof(row_count));
+        m_stream.write(reinterpret_cast<const char*>(m_times.data()), row_count*sizeof(int64_t));
+        for (unsigned int i = 0; i < m_columns.size(); i++)
+        {
+            m_stream.write(reinterpret_cast<const char*>(m_columns[i].data()), row_count*sizeof(double));
+            m_columns[i].clear();
+        }
+        m_times.clear();
+    } // write_block()
+
+    void BP_Binary_Observer::observe(const BP_Period_Context& context, double t)
+    {
+        fill_row(context);
+        m_times.push_back(context.m_sim_begin_second + (long long)t);
+        for (unsigned int i = 0; i < m_row.size(); i++)
+            m_columns[i].push_back(m_row[i]);
+        if (m_times.size() >= m_block_size) write_block();
+    } // observe()
+
+    void BP_Binary_Observer::end()
+    {
+        if (!m_stream.is_open()) return;
+        write_block();
+        m_stream.close();
+    } // end()
+
+    BP_Hourly_Observer::BP_Hourly_Observer(BP_Simulation* system, std::string file_name) : BP_Observer(system)
+    {
+        m_hour = -1;
+        m_count = 0;
+        m_sums.assign(m_column_names.size(), 0.0);
+
+        m_stream.open(file_name.c_str());
+        m_stream << "Time";
+        for (unsigned int i = 0; i < m_column_names.size(); i++)
+            m_stream << "," << m_column_names[i];
+        m_stream << std::endl;
+    } // ctor
+
+    void BP_Hourly_Observer::write_hour()
+    {
+        if (m_count == 0) return;
+        m_stream << (boost::posix_time::ptime(boost::gregorian::date(1970,1,1)) + boost::posix_time::hours(m_hour));
+        for (unsigned int i = 0; i < m_sums.size(); i++)
+        {
+            m_stream << "," << m_sums[i]/m_count;
+            m_sums[i] = 0.0;
+        }
+        m_stream << std::endl;
+        m_count = 0;
+    } // write_hour()
+
+    void BP_Hourly_Observer::observe(const BP_Period_Context& context, double t)
+    {
+        long long second = context.m_sim_begin_second + (long long)t;
+        long long hour = (second >= 0) ? second/3600 : (second - 3599)/3600;
+        if (hour != m_hour)
+        {
+            write_hour();
+            m_hour = hour;
+        }
+
+        fill_row(context);
+        for (unsigned int i = 0; i < m_row.size(); i++)
+            m_sums[i] += m_row[i];
+        m_count++;
+    } // observe()
+
+    void BP_Hourly_Observer::end()
+    {
+        if (!m_stream.is_open()) return;
+        write_hour();
+        m_stream.close();
+    } // end()
+
+} // namespace Building_Physics
+} // namespace BSO
+
+#endif // BP_OBSERVER_HPP
@@ -2,13 +2,16 @@
 #define BP_SIMULATION_CPP
 
 #include <utility>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include <boost/date_time/posix_time/posix_time.hpp> // for simulation time
 #include <boost/bind.hpp> // used in odeint stepper
-#include <boost/tokenizer.hpp> // to tokenize strings
-#include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/numeric/odeint.hpp> // to solve ODE's
+#include <boost/numeric/odeint/external/eigen/eigen.hpp> // to use Eigen vectors as states
+#include <unsupported/Eigen/MatrixFunctions> // matrix exponential for the exponential solver
 
 
 #include <BSO/Building_Physics/Construction/BP_Construction.hpp>
@@ -19,6 +22,7 @@
 #include <BSO/Building_Physics/States/Dep_States/BP_Floor.hpp>
 #include <BSO/Building_Physics/States/Indep_States/BP_Weather_Profile.hpp>
 #include <BSO/Building_Physics/States/Indep_States/BP_Ground_profile.hpp>
+#include <BSO/Building_Physics/BP_Observer.hpp>
 
 #include <BSO/Trim_And_Cast.hpp>
 #include <Read_BP_Settings.hpp>
@@ -30,9 +34,57 @@ namespace BSO { namespace Building_Physics {
 namespace odeint = boost::numeric::odeint; // shorten name space declaration a bit
 //typedef odeint::runge_kutta_fehlberg78<BP_Vector_Type, double, BP_Vector_Type, double, odeint::vector_space_algebra> explicit_stepper; // this defines what solver is used and what type of variable is used for the states
 typedef odeint::runge_kutta_dopri5<BP_Vector_Type, double, BP_Vector_Type, double, odeint::vector_space_algebra> explicit_stepper; // this defines what solver is used and what type of variable is used for the states
-//typedef odeint::euler<ublas::vector<double>, double, ublas::vector<double>, double, odeint::vector_space_algebra> explicit_stepper; // this defines what solver is used and what type of variable is used for the states
-
-typedef odeint::implicit_euler<double> implicit_stepper;
+//typedef odeint::euler<BP_Vector_Type, double, BP_Vector_Type, double, odeint::vector_space_algebra> explicit_stepper; // this defines what solver is used and what type of variable is used for the states
+
+class BP_Implicit_Stepper
+{ // odeint stepper for the implicit solvers, the step itself is taken by BP_Simulation::implicit_step()
+  // with theta = 1 for implicit Euler and theta = 0.5 for Crank-Nicolson
+private:
+	BP_Simulation* m_system;
+	BP_Period_Context* m_context;
+	double m_theta;
+public:
+	typedef BP_Vector_Type state_type;
+	typedef BP_Vector_Type deriv_type;
+	typedef double value_type;
+	typedef double time_type;
+	typedef unsigned short order_type;
+	typedef odeint::stepper_tag stepper_category;
+
+	BP_Implicit_Stepper(BP_Simulation* system, BP_Period_Context* context, double theta) : m_system(system), m_context(context), m_theta(theta) {}
+
+	order_type order() const { return (m_theta == 0.5) ? 2 : 1; }
+
+	template <class System>
+	void do_step(System system, state_type& x, time_type t, time_type dt)
+	{
+		m_system->implicit_step(*m_context, x, t, dt, m_theta);
+	}
+}; // BP_Implicit_Stepper
+
+class BP_Exponential_Stepper
+{ // odeint stepper for the exponential solver, the step itself is taken by BP_Simulation::exponential_step()
+private:
+	BP_Simulation* m_system;
+	BP_Period_Context* m_context;
+public:
+	typedef BP_Vector_Type state_type;
+	typedef BP_Vector_Type deriv_type;
+	typedef double value_type;
+	typedef double time_type;
+	typedef unsigned short order_type;
+	typedef odeint::stepper_tag stepper_category;
+
+	BP_Exponential_Stepper(BP_Simulation* system, BP_Period_Context* context) : m_system(system), m_context(context) {}
+
+	order_type order() const { return 2; }
+
+	template <class System>
+	void do_step(System system, state_type& x, time_type t, time_type dt)
+	{
+		m_system->exponential_step(*m_context, x, t, dt);
+	}
+}; // BP_Exponential_Stepper
 
 
 BP_Simulation::BP_Simulation(std::string file_name)
@@ -65,16 +117,74 @@ void BP_Simulation::initialize()
 	m_building_results = new BP_Building_Results;
 
 	// initialize the state vectors and matrices to their correct sizes and some initial values
-    m_SS_u = BP_Vector_Type(m_indep_count, 1.0); // seed state vector u with initial values (must be initiated to 1!)
-    m_SS_x = BP_Vector_Type(m_dep_count, (m_space_settings[0].m_heat_set_point + m_space_settings[0].m_cool_set_point) /2.0); // seed state vector x with initial values
-	m_SS_dT = BP_Vector_Type(m_dep_count, 0.0);
-    m_SS_A = BP_Matrix_Type(m_dep_count, m_dep_count, 0.0); // seed state matrix A with initial values (must be zero!)
-    m_SS_B = BP_Matrix_Type(m_dep_count, m_indep_count, 0.0); // seed state matrix B with initial values (must be zero!)
+    m_SS_u = BP_Vector_Type::Constant(m_indep_count, 1.0); // seed state vector u with initial values (must be initiated to 1!)
+    m_SS_x = BP_Vector_Type::Constant(m_dep_count, (m_space_settings[0].m_heat_set_point + m_space_settings[0].m_cool_set_point) /2.0); // seed state vector x with initial values
+	m_SS_dT = BP_Vector_Type::Zero(m_dep_count);
+    m_SS_A = BP_Matrix_Type(m_dep_count, m_dep_count); // seed state matrix A without any entries
+    m_SS_B = BP_Matrix_Type(m_dep_count, m_indep_count); // seed state matrix B without any entries
+
+	// group the states by how they change during a simulation
+	for (auto i : m_indep_states)
+	{
+		if (i->is_weather_profile()) m_time_varying_states.push_back(static_cast<BP_Weather_Profile*>(i));
+		else m_constant_states.push_back(i);
+	}
+	m_space_controllers = new BP_Space_Controllers;
+	m_space_controllers->initialize(m_space_ptrs);
+	m_exponential_h = 0.0;
 } // initialize()
 
+void BP_Simulation::assemble_system()
+{ // builds the state space matrices from the entries added by the dependent states (entries at the same position are summed)
+	for (unsigned int i = 0; i < m_dep_count; i++)
+	{ // the first column of B holds the heating/cooling of each state and is updated during simulation, so it is always stored
+		m_SS_B_entries.push_back(Eigen::Triplet<double>(i, 0, 0.0));
+	}
+
+	m_SS_A.resize(m_dep_count, m_dep_count);
+	m_SS_A.setFromTriplets(m_SS_A_entries.begin(), m_SS_A_entries.end());
+	m_SS_B.resize(m_dep_count, m_indep_count);
+	m_SS_B.setFromTriplets(m_SS_B_entries.begin(), m_SS_B_entries.end());
+	m_SS_A_entries.clear();
+	m_SS_B_entries.clear();
+} // assemble_system()
+
+void BP_Simulation::init_context(BP_Period_Context& context, std::string ID)
+{ // every simulation period starts from the seed state vectors and the assembled system
+	context.m_ID = ID;
+	context.m_SS_x = m_SS_x;
+	context.m_SS_u = m_SS_u;
+	context.m_SS_dT = BP_Vector_Type::Zero(m_dep_count);
+	context.m_SS_B = m_SS_B;
+	context.m_SS_B.makeCompressed(); // required by BP_Space_Controllers::update()
+	context.m_heating_energy.assign(m_dep_count, 0.0);
+	context.m_cooling_energy.assign(m_dep_count, 0.0);
+
+	context.m_implicit_h = 0.0; // no decomposition yet
+	context.m_implicit_u.resize(m_indep_count);
+	context.m_implicit_f.resize(m_dep_count);
+	context.m_implicit_dx.resize(m_dep_count);
+	context.m_exponential_Q.resize(m_space_ptrs.size());
+	context.m_exponential_x.resize(m_dep_count);
+	context.m_space_T.resize(m_space_ptrs.size());
+	context.m_space_Q.resize(m_space_ptrs.size());
+	context.m_space_dT.resize(m_space_ptrs.size());
+	context.m_space_dQ.resize(m_space_ptrs.size());
+	context.m_observer = nullptr;
+} // init_context()
+
+void BP_Simulation::update_forcing(BP_Period_Context& context, const double& t)
+{ // non-virtual updates of the independent states that change in time
+	for (auto i : m_time_varying_states)
+	{
+		i->BP_Weather_Profile::update_sys(context, t);
+	}
+} // update_forcing()
+
 BP_Simulation::~BP_Simulation()
 {
     delete m_building_results;
+    delete m_space_controllers;
 
     for (unsigned int i = 0; i < m_states.size(); i++)
     {
@@ -90,227 +200,331 @@ BP_Simulation::~BP_Simulation()
 
 } // dtor
 
-void BP_Simulation::ODE_function(const BP_Vector_Type &x, BP_Vector_Type &dxdt, const double& t)
+void BP_Simulation::ODE_function(BP_Period_Context& context, const BP_Vector_Type &x, BP_Vector_Type &dxdt, const double& t)
 {
-	for (auto i : m_indep_states)
-	{
-        i->update_sys(t);
-	}
+	update_forcing(context, t);
 
-    dxdt = prod(m_SS_A, x) + prod(m_SS_B ,m_SS_u); // x is passed as a function argument as it must be varied by the ODE solver
+	dxdt.noalias() = m_SS_A * x; // x is passed as a function argument as it must be varied by the ODE solver
+	dxdt.noalias() += context.m_SS_B * context.m_SS_u; // sparse products, written directly into dxdt
 	if (t < 0) dxdt *= -1; // for warm up period with negative time steps
 } // ODE_function()
 
-void BP_Simulation::ODE_Jacobi(const BP_Vector_Type &x, BP_Matrix_Type &J, const double& t)
-{
-	J = m_SS_A;
-	if (t < 0) J *= -1; // for warm up period with negative time steps
-}
-
-void BP_Simulation::Observer_function(const BP_Vector_Type &x, double t)
-{
-	bool stream_open = m_observer_stream.is_open();
-	ODE_function(x, m_SS_dT, t);
-	m_SS_dT *= 3600.0/m_time_step_hour; // get an estimate for heating during the next time step
-	
-	for(auto i : m_space_ptrs) // update heating
+void BP_Simulation::implicit_step(BP_Period_Context& context, BP_Vector_Type &x, const double& t, const double& dt, const double& theta)
+{ // solves (I - theta*h*A)*dx = h*(A*x + B*u) for the step dx, with h = |dt| (during the warm up period time runs backwards and the signs
+  // of A and B are flipped) and u = (1-theta)*u(t) + theta*u(t+dt). This gives implicit Euler for theta = 1 (the same step as odeint's
+  // implicit_euler) and Crank-Nicolson for theta = 0.5. A does not change within a simulation period, so the decomposition is only
+  // computed again when theta*h changes, all other work is done in preallocated vectors
+	double h = std::abs(dt);
+	if (theta*h != context.m_implicit_h)
 	{
-		i->update_sys(t);
-	}
-	
-	boost::posix_time::ptime current_time = (m_sim_begin + boost::posix_time::seconds(t));
-	boost::posix_time::time_duration abs_dt = m_last_observer_moment - current_time;
-	if (abs_dt.is_negative())abs_dt *= -1; // to make abs_dt an absolute time duration
-    if (stream_open) m_observer_stream << current_time;
-
-    // send external temperature to the observer file
-    if (stream_open) m_observer_stream << "," << m_weather_profile->get_temp();
-
-    // send space temperatures to the observer file
-    for (auto i : m_space_ptrs)
-    {
-        unsigned int space_index = i->get_index();
-        double Q = m_SS_B(space_index,0) * i->get_capacitance();
-		i->add_Q_load((double)abs_dt.total_seconds(), Q);
-		if (stream_open)
+		Eigen::SparseMatrix<double> M = -theta*h*m_SS_A; // the decomposition requires column major storage
+		Eigen::SparseMatrix<double> I(m_dep_count, m_dep_count);
+		I.setIdentity();
+		M += I;
+		context.m_implicit_LU.compute(M);
+		if (context.m_implicit_LU.info() != Eigen::Success)
 		{
-			m_observer_stream << "," << m_SS_x(space_index) // space temperature
-							  << "," << ((Q >= 0) ? Q : 0) // heating power
-							  << "," << ((Q < 0) ? -Q : 0); // cooling power
+			std::cerr << "Decomposition for the implicit solver failed, exiting now... (BP_Simulation.cpp)" << std::endl;
+			exit(1);
 		}
+		context.m_implicit_h = theta*h;
 	}
 
-    // send wall temperatures to the observer file
-	if (stream_open)
+	if (theta < 1.0)
+	{
+		update_forcing(context, t);
+		context.m_implicit_u = (1.0 - theta)*context.m_SS_u;
+	}
+	else
+	{
+		context.m_implicit_u.setZero();
+	}
+	update_forcing(context, t + dt);
+	context.m_implicit_u += theta*context.m_SS_u;
+
+	context.m_implicit_f.noalias() = m_SS_A * x;
+	context.m_implicit_f.noalias() += context.m_SS_B * context.m_implicit_u;
+	context.m_implicit_f *= h;
+	context.m_implicit_dx = context.m_implicit_LU.solve(context.m_implicit_f);
+	x += context.m_implicit_dx;
+} // implicit_step()
+
+void BP_Simulation::discretize_system(const double& h)
+{ // exact discretization of dx/dt = A*x + v for a time step h in which v = W*w changes linearly from v0 to v1:
+  // x(h) = Phi*x(0) + G0*v0 + G1*v1, with Phi = exp(A*h). The integrals of exp(A*s) that make up G0*W and G1*W are the
+  // top blocks of the exponential of the augmented matrix [A*h, W*h, 0; 0, 0, I; 0, 0, 0], which is only m columns wider
+  // than A for m inputs. The heating/cooling (first column of B, only changed by the spaces) is constant during a time step,
+  // so it enters through (G0 + G1)*W with a unit column for each space, the other inputs through Gamma_0 = G0*B and
+  // Gamma_1 = G1*B. The exponential is dense, so systems of more than BP_exponential_max_states states are not discretized
+	unsigned int n = m_dep_count;
+	unsigned int n_spaces = m_space_controllers->m_index.size();
+	unsigned int n_inputs = m_indep_count - 1; // the columns of B after the heating/cooling
+	unsigned int m = n_spaces + n_inputs;
+
+	Eigen::MatrixXd C = Eigen::MatrixXd::Zero(n + 2*m, n + 2*m);
+	C.topLeftCorner(n, n) = Eigen::MatrixXd(m_SS_A) * h;
+	for (unsigned int i = 0; i < n_spaces; i++)
+	{
+		C(m_space_controllers->m_index[i], n + i) = h;
+	}
+	C.block(0, n + n_spaces, n, n_inputs) = Eigen::MatrixXd(m_SS_B).rightCols(n_inputs) * h;
+	C.block(n, n + m, m, m) = Eigen::MatrixXd::Identity(m, m);
+	Eigen::MatrixXd E = C.exp();
+
+	m_Phi = E.topLeftCorner(n, n);
+	m_Gamma_heating = E.block(0, n, n, n_spaces);
+	m_Gamma_0 = Eigen::MatrixXd::Zero(n, m_indep_count); // the heating/cooling is added separately
+	m_Gamma_1 = Eigen::MatrixXd::Zero(n, m_indep_count);
+	m_Gamma_1.rightCols(n_inputs) = E.block(0, n + m + n_spaces, n, n_inputs);
+	m_Gamma_0.rightCols(n_inputs) = E.block(0, n + n_spaces, n, n_inputs) - m_Gamma_1.rightCols(n_inputs);
+	m_exponential_h = h;
+
+	// heat only spreads a few connections per time step, so when most entries of Phi are negligible it is used sparse
+	m_Phi_sparse = m_Phi.sparseView(1.0, 1e-15*m_Phi.cwiseAbs().maxCoeff());
+	m_exponential_sparse = (m_Phi_sparse.nonZeros() < 0.25*n*n);
+	if (m_exponential_sparse) m_Phi.resize(0, 0);
+	else m_Phi_sparse.resize(0, 0);
+} // discretize_system()
+
+void BP_Simulation::exponential_step(BP_Period_Context& context, BP_Vector_Type &x, const double& t, const double& dt)
+{ // a step with the discretization of discretize_system(), the heating/cooling in B is constant during the step and the other
+  // inputs change linearly (as the interpolated weather data does within each hour). During the warm up period time runs backwards
+  // and the signs of A and B are flipped, which is the same system forward in -t, so the same discretization applies
+	if (std::abs(dt) != m_exponential_h)
 	{
-		// send wall temperatures to the observer file
-		for (auto i : m_wall_ptrs)
-			m_observer_stream << "," << i->get_temp();
-
-		// send floor temperatures to the observer file
-		for (auto i : m_floor_ptrs)
-			m_observer_stream << "," << i->get_temp();
-
-		// send window temperatures to the observer filer
-		for (auto i : m_window_ptrs)
-			m_observer_stream << "," << i->get_temp();
-		m_observer_stream << std::endl;
+		std::cerr << "The exponential solver is discretized for another time step, exiting now... (BP_Simulation.cpp)" << std::endl;
+		exit(1);
 	}
 
-	m_last_observer_moment = current_time;
-}
+	const double* B_values = context.m_SS_B.valuePtr(); // the heating/cooling is the first stored entry of each row, see BP_Space_Controllers
+	const int* B_rows = context.m_SS_B.outerIndexPtr();
+	for (unsigned int i = 0; i < m_space_controllers->m_index.size(); i++)
+	{
+		context.m_exponential_Q(i) = B_values[B_rows[m_space_controllers->m_index[i]]];
+	}
 
-void BP_Simulation::init_observer_file(std::string file_name)
+	if (m_exponential_sparse) context.m_exponential_x.noalias() = m_Phi_sparse * x;
+	else context.m_exponential_x.noalias() = m_Phi * x;
+	context.m_exponential_x.noalias() += m_Gamma_heating * context.m_exponential_Q;
+	update_forcing(context, t);
+	context.m_exponential_x.noalias() += m_Gamma_0 * context.m_SS_u;
+	update_forcing(context, t + dt);
+	context.m_exponential_x.noalias() += m_Gamma_1 * context.m_SS_u;
+	x.swap(context.m_exponential_x);
+} // exponential_step()
+
+void BP_Simulation::Observer_function(BP_Period_Context& context, const BP_Vector_Type &x, double t)
 {
-	if (m_output != output::SIM_RESULTS) return; // if output of the results is turned off, then skip all this
-    m_observer_stream.open(file_name.c_str());
-    // write the header
-    m_observer_stream << "Time,Te";
-    for (auto i : m_space_ptrs) // set heading for the spaces
+	ODE_function(context, x, context.m_SS_dT, t);
+	context.m_SS_dT *= 3600.0/m_time_step_hour; // get an estimate for heating during the next time step
+	
+	m_space_controllers->update(context, 3600.0/m_time_step_hour); // update heating
+	
+	long long current_second = (long long)t; // whole seconds, as the time stamps of the output
+	double abs_dt = (double)std::abs(current_second - context.m_last_observer_second);
+
+	// count the heating and cooling energy of each space
+    for (auto i : m_space_ptrs)
     {
-        m_observer_stream << ",T_space_" + i->get_ID()   // temperature
-                          << ",Qh_space_" + i->get_ID() // active heating power
-                          << ",Qc_space_" + i->get_ID();  // active cooling power
-    }
-    for (auto i : m_wall_ptrs) // set heading for the walls
-        m_observer_stream << ",T_wall_" + i->get_ID();
-    for (auto i : m_floor_ptrs) // set heading for the floors
-        m_observer_stream << ",T_floor_" + i->get_ID();
-    for (auto i : m_window_ptrs) // set heading for the windows
-        m_observer_stream << ",T_window_" + i->get_ID();
-    m_observer_stream << std::endl;
-} // init_observer_file()
-
-void BP_Simulation::end_observer_file()
-{
-    if (m_observer_stream.is_open()) m_observer_stream.close(); // only close it when it is actually open
-} // end_observer_file()
+        double Q = context.m_SS_B.coeff(i->get_index(),0) * i->get_capacitance();
+		i->add_Q_load(context, abs_dt, Q);
+	}
 
-void BP_Simulation::sim_period()
-{
-	m_building_results->reset(); // clear the structure (in case a new simulation is being run)
-	double time_step = 3600.0/(m_time_step_hour);
-	boost::posix_time::time_duration duration;
+	if (context.m_observer != nullptr) context.m_observer->observe(context, t);
 
-	for (auto sim_period : m_simulation_periods)
-    {
-		std::pair<boost::posix_time::ptime, boost::posix_time::ptime> period = sim_period.second; // the begin (first of pair) and the end (second of pair) of the simulation period
-		m_current_sim_period = sim_period.first; // the ID of the simulation period
-		
-
-		// warm up period
-		m_sim_begin = period.first + boost::gregorian::days(m_warm_up_days); // this is the begin of this simulation period
-		duration = period.first - m_sim_begin;
-		m_last_observer_moment = m_sim_begin;
-
-		for (auto i : m_dep_states)
-		{ // for each dependant state
-			i->init_sys(); // initialise the state space matrices
-		}
-		for (auto i : m_states)
-		{
-			i->update_sys(0.0); // update the system according to the initial values (i.e. add heating/cooling loads and ground/weather profile to the system)
-		}
+	context.m_last_observer_second = current_second;
+} // Observer_function()
 
-		if (m_solver_type == solver_type::CONTROLLED_EXPLICIT)
-		{
-		// solve the ODE from begin to end
+BP_Observer* BP_Simulation::create_observer(std::pair<boost::posix_time::ptime, boost::posix_time::ptime> period)
+{
+	std::string file_name = "BP_sim_from_"+boost::posix_time::to_iso_string(period.first)+"_until_"+boost::posix_time::to_iso_string(period.second);
+	switch (m_output)
+	{
+	case output::NONE:
+		return nullptr; // only the heating and cooling energy is counted
+	case output::SIM_RESULTS:
+		return new BP_Text_Observer(this, file_name + ".txt");
+	case output::BINARY_RESULTS:
+		return new BP_Binary_Observer(this, file_name + ".bin");
+	case output::HOURLY_RESULTS:
+		return new BP_Hourly_Observer(this, file_name + "_hourly.txt");
+	default:
+		std::cerr << "Unknown output type, exiting now... (BP_Simulation.cpp)" << std::endl;
+		exit(1);
+	}
+} // create_observer()
+
+void BP_Simulation::integrate(BP_Period_Context& context, const double& t_end, const double& time_step)
+{ // solves the state space system from t = 0 until t_end with the selected solver, the observer is called after each time step
+	if (m_solver_type == solver_type::CONTROLLED_EXPLICIT)
+	{
 		odeint::integrate_const(odeint::make_controlled(1e-6,1e-6,explicit_stepper()) // which stepper is used
-							   ,boost::bind(&BP_Simulation::ODE_function, this, _1, _2, _3)
-							   ,m_SS_x // all dependent states
+							   ,boost::bind(&BP_Simulation::ODE_function, this, boost::ref(context), _1, _2, _3)
+							   ,context.m_SS_x // all dependent states
 							   ,0.0 // the current time
-							   ,(double)duration.total_seconds() // the time after the simulation
-							   ,-time_step
-							   ,boost::bind(&BP_Simulation::Observer_function, this, _1, _2)
-							   ); // duration of the time step
-		}
-		else if (m_solver_type == solver_type::IMPLICIT)
-		{
-			// solve the ODE from begin to end
-			odeint::integrate_const(implicit_stepper() // which stepper is used
-								   ,std::make_pair(boost::bind(&BP_Simulation::ODE_function, this, _1, _2, _3),
-												   boost::bind(&BP_Simulation::ODE_Jacobi,   this, _1, _2, _3))
-								   ,m_SS_x // all dependent states
-								   ,0.0 // the current time
-								   ,(double)duration.total_seconds() // the time after the simulation
-								   ,-time_step
-								   ,boost::bind(&BP_Simulation::Observer_function, this, _1, _2)
-								   ); // duration of the time step
-		}
-		else if (m_solver_type == solver_type::UNCONTROLLED_EXPLICIT)
-		{
-			// solve the ODE from begin to end
+							   ,t_end // the time after the simulation
+							   ,time_step // duration of the time step
+							   ,boost::bind(&BP_Simulation::Observer_function, this, boost::ref(context), _1, _2)
+							   );
+	}
+	else if (m_solver_type == solver_type::UNCONTROLLED_EXPLICIT)
+	{
 		odeint::integrate_const(explicit_stepper() // which stepper is used
-							   ,boost::bind(&BP_Simulation::ODE_function, this, _1, _2, _3)
-							   ,m_SS_x // all dependent states
+							   ,boost::bind(&BP_Simulation::ODE_function, this, boost::ref(context), _1, _2, _3)
+							   ,context.m_SS_x // all dependent states
 							   ,0.0 // the current time
-							   ,(double)duration.total_seconds() // the time after the simulation
-							   ,-time_step
-							   ,boost::bind(&BP_Simulation::Observer_function, this, _1, _2)
-							   ); // duration of the time step
-		}
-		else
-		{
-			std::cerr << ", exiting now... (BP_Simulation.cpp)" << std::endl;
-			exit(1);
-		}
+							   ,t_end // the time after the simulation
+							   ,time_step // duration of the time step
+							   ,boost::bind(&BP_Simulation::Observer_function, this, boost::ref(context), _1, _2)
+							   );
+	}
+	else if (m_solver_type == solver_type::IMPLICIT || m_solver_type == solver_type::CRANK_NICOLSON)
+	{
+		double theta = (m_solver_type == solver_type::IMPLICIT) ? 1.0 : 0.5;
+		odeint::integrate_const(BP_Implicit_Stepper(this, &context, theta) // which stepper is used
+							   ,boost::bind(&BP_Simulation::ODE_function, this, boost::ref(context), _1, _2, _3)
+							   ,context.m_SS_x // all dependent states
+							   ,0.0 // the current time
+							   ,t_end // the time after the simulation
+							   ,time_step // duration of the time step
+							   ,boost::bind(&BP_Simulation::Observer_function, this, boost::ref(context), _1, _2)
+							   );
+	}
+	else if (m_solver_type == solver_type::EXPONENTIAL)
+	{
+		odeint::integrate_const(BP_Exponential_Stepper(this, &context) // which stepper is used
+							   ,boost::bind(&BP_Simulation::ODE_function, this, boost::ref(context), _1, _2, _3)
+							   ,context.m_SS_x // all dependent states
+							   ,0.0 // the current time
+							   ,t_end // the time after the simulation
+							   ,time_step // duration of the time step
+							   ,boost::bind(&BP_Simulation::Observer_function, this, boost::ref(context), _1, _2)
+							   );
+	}
+	else
+	{
+		std::cerr << "Unknown solver type, exiting now... (BP_Simulation.cpp)" << std::endl;
+		exit(1);
+	}
+} // integrate()
 
-		// simulation period
-		m_sim_begin = period.first; // this is the begin of this simulation period
-		duration = period.second - m_sim_begin;
-		m_last_observer_moment = m_sim_begin;
-		init_observer_file("BP_sim_from_"+boost::posix_time::to_iso_string(period.first)+"_until_"+boost::posix_time::to_iso_string(period.second)+".txt");
+void BP_Simulation::simulate_period(BP_Period_Context& context, std::pair<boost::posix_time::ptime, boost::posix_time::ptime> period)
+{ // period: the begin (first of pair) and the end (second of pair) of the simulation period
+	double time_step = 3600.0/(m_time_step_hour);
+	boost::posix_time::time_duration duration;
 
-		for (unsigned int i = 0; i < m_space_ptrs.size(); i++)
-		{ // for each space
-			m_space_ptrs[i]->set_power_count_zero(); // reset the power counters for the current simulation period
-		}
+	// warm up period
+	context.set_sim_begin(period.first + boost::gregorian::days(m_warm_up_days)); // this is the begin of this simulation period
+	duration = period.first - context.m_sim_begin;
 
-		if (m_solver_type == solver_type::CONTROLLED_EXPLICIT)
+	// update the system according to the initial values (i.e. add ground/weather profile and heating/cooling loads to the system)
+	for (auto i : m_constant_states)
+	{
+		i->update_sys(context, 0.0);
+	}
+	update_forcing(context, 0.0);
+	m_space_controllers->update(context, time_step);
+
+	integrate(context, (double)duration.total_seconds(), -time_step); // negative time steps, back from the begin of the simulation period
+
+	// simulation period
+	context.set_sim_begin(period.first); // this is the begin of this simulation period
+	duration = period.second - context.m_sim_begin;
+	context.m_observer = create_observer(period);
+
+	std::fill(context.m_heating_energy.begin(), context.m_heating_energy.end(), 0.0); // only count the energy of the simulation period itself
+	std::fill(context.m_cooling_energy.begin(), context.m_cooling_energy.end(), 0.0);
+
+	integrate(context, (double)duration.total_seconds(), time_step);
+
+	if (context.m_observer != nullptr)
+	{
+		context.m_observer->end();
+		delete context.m_observer;
+		context.m_observer = nullptr;
+	}
+} // simulate_period()
+
+void BP_Simulation::sim_period(unsigned int n_threads)
+{ // the simulation periods are independent of each other: each starts from the seed state with its own warm up period,
+  // so they are solved in their own context, concurrently, and their results are merged in the order of the periods
+	BSO_PROFILE_SCOPE("BP_Simulation::sim_period");
+	m_building_results->reset(); // clear the structure (in case a new simulation is being run)
+
+	for (auto i : m_dep_states)
+	{ // for each dependant state
+		i->init_sys(); // add the entries of the state space matrices
+	}
+	assemble_system(); // build the state space matrices, A is the same for all simulation periods
+	if (m_solver_type == solver_type::EXPONENTIAL && m_dep_count > BP_exponential_max_states)
+	{
+		std::cerr << "Warning, the exponential solver is limited to " << BP_exponential_max_states << " states and this building has "
+		          << m_dep_count << ", using the Crank-Nicolson solver instead (BP_Simulation.cpp)" << std::endl;
+		m_solver_type = solver_type::CRANK_NICOLSON;
+	}
+	if (m_solver_type == solver_type::EXPONENTIAL)
+	{
+		discretize_system(3600.0/(m_time_step_hour));
+	}
+
+	std::vector<std::pair<std::string, std::pair<boost::posix_time::ptime, boost::posix_time::ptime> > > periods(m_simulation_periods.begin(), m_simulation_periods.end());
+	std::vector<BP_Period_Context> contexts(periods.size());
+	for (unsigned int i = 0; i < periods.size(); i++)
+	{
+		init_context(contexts[i], periods[i].first);
+	}
+
+	if (n_threads == 0)
+	{
+		n_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	n_threads = std::min(n_threads, (unsigned int)periods.size());
+
+	std::atomic<unsigned int> next_period(0);
+	auto simulate_periods = [&]()
+	{
+		for (unsigned int i = next_period++; i < periods.size(); i = next_period++)
 		{
-			// solve the ODE from begin to end
-			odeint::integrate_const( odeint::make_controlled(1e-6,1e-6,explicit_stepper()) // which stepper is used
-								   ,boost::bind(&BP_Simulation::ODE_function, this, _1, _2, _3)
-								   ,m_SS_x // all dependent states
-								   ,0.0 // the current time
-								   ,(double)duration.total_seconds() // the time after the simulation
-								   ,time_step
-								   ,boost::bind(&BP_Simulation::Observer_function, this, _1, _2)
-								   ); // duration of the time step
+			simulate_period(contexts[i], periods[i].second);
 		}
-		else if (m_solver_type == solver_type::IMPLICIT)
+	};
+
+	if (n_threads <= 1)
+	{
+		simulate_periods();
+	}
+	else
+	{
+		std::vector<std::thread> workers;
+		for (unsigned int i = 0; i < n_threads; i++)
 		{
-			// solve the ODE from begin to end
-			odeint::integrate_const(implicit_stepper() // which stepper is used
-								   ,std::make_pair(boost::bind(&BP_Simulation::ODE_function, this, _1, _2, _3),
-												   boost::bind(&BP_Simulation::ODE_Jacobi,   this, _1, _2, _3))
-								   ,m_SS_x // all dependent states
-								   ,0.0 // the current time
-								   ,(double)duration.total_seconds() // the time after the simulation
-								   ,time_step
-								   ,boost::bind(&BP_Simulation::Observer_function, this, _1, _2)
-								   ); // duration of the time step
+			workers.push_back(std::thread(simulate_periods));
 		}
-		else if (m_solver_type == solver_type::UNCONTROLLED_EXPLICIT)
+		for (unsigned int i = 0; i < workers.size(); i++)
 		{
-			// solve the ODE from begin to end
-		odeint::integrate_const(explicit_stepper() // which stepper is used
-							   ,boost::bind(&BP_Simulation::ODE_function, this, _1, _2, _3)
-							   ,m_SS_x // all dependent states
-							   ,0.0 // the current time
-							   ,(double)duration.total_seconds() // the time after the simulation
-							   ,time_step
-							   ,boost::bind(&BP_Simulation::Observer_function, this, _1, _2)
-							   ); // duration of the time step
+			workers[i].join();
 		}
-		else
+	}
+
+	// merge the energy of each simulation period (in the order of the periods, so the results do not depend on the number of threads)
+	for (unsigned int i = 0; i < m_space_ptrs.size(); i++)
+	{ // for each space
+		m_space_ptrs[i]->set_power_count_zero(); // reset the power counters of all simulation periods
+	}
+	for (unsigned int i = 0; i < contexts.size(); i++)
+	{
+		for (auto j : m_space_ptrs)
 		{
-			std::cerr << ", exiting now... (BP_Simulation.cpp)" << std::endl;
-			exit(1);
+			unsigned int index = j->get_index();
+			j->add_energy(contexts[i].m_ID, contexts[i].m_heating_energy[index], contexts[i].m_cooling_energy[index]);
 		}
+	}
 
-		end_observer_file();
-	} // end for every simulation period
+	if (!contexts.empty())
+	{ // the states show the temperatures at the end of the last simulation period
+		m_SS_x = contexts.back().m_SS_x;
+		m_SS_u = contexts.back().m_SS_u;
+	}
 
     // add results to the results structure
     for (unsigned int i = 0; i < m_space_ptrs.size(); i++)
@@ -13,28 +13,56 @@
 #error Included "BSO/Performance_indexing.hpp" before "BSO/Building_Physics/BP_Simulation.hpp"
 #endif
 
-#ifndef BOOST_UBLAS_NDEBUG
-#define BOOST_UBLAS_NDEBUG // to improve ublas algebra speed
-#endif // BOOST_UBLAS_NDEBUG
-
 // include all the building physics related objects
+#include <BSO/Profiler.hpp>
 #include <BSO/Spatial_Design/Conformation.hpp>
-#include <boost/numeric/ublas/matrix.hpp> // for state space matrices
-#include <boost/numeric/ublas/vector.hpp> // for state space matrices
+#include <Eigen/Dense> // for state space vectors
+#include <Eigen/Sparse> // for state space matrices
 #include <boost/date_time/posix_time/posix_time.hpp> // for simulation time
 
 #include <BSO/Building_Physics/BP_Simulation_Vars.hpp>
 
-namespace ublas = boost::numeric::ublas;
-
-typedef ublas::matrix<double> BP_Matrix_Type;
-typedef ublas::vector<double> BP_Vector_Type;
+typedef Eigen::SparseMatrix<double, Eigen::RowMajor> BP_Matrix_Type; // compressed row storage, each state only connects to a few others
+typedef Eigen::VectorXd BP_Vector_Type;
 
 namespace BSO {
 namespace Building_Physics {
 
-enum class solver_type{CONTROLLED_EXPLICIT, UNCONTROLLED_EXPLICIT, IMPLICIT, ARG_COUNT};
-enum class output{NONE, SIM_RESULTS, ARG_COUNT};
+enum class solver_type{CONTROLLED_EXPLICIT, UNCONTROLLED_EXPLICIT, IMPLICIT, CRANK_NICOLSON, EXPONENTIAL, ARG_COUNT}; // IMPLICIT is implicit Euler, EXPONENTIAL is exact for the time step
+enum class output{NONE, SIM_RESULTS, BINARY_RESULTS, HOURLY_RESULTS, ARG_COUNT}; // see BP_Observer.hpp
+
+// the exponential solver computes a dense matrix exponential of about the size of the system, which takes O(n^3) time and
+// O(n^2) memory, so larger systems are solved with the Crank-Nicolson solver instead (see discretize_system())
+const unsigned int BP_exponential_max_states = 1000;
+
+struct BP_Period_Context
+{ // everything that changes while a simulation period is solved, so that periods can be solved concurrently
+  // (the states and the matrix A are shared and only read during the simulation)
+	std::string m_ID; // the ID of the simulation period
+	boost::posix_time::ptime m_sim_begin; // time at t = 0
+	long long m_sim_begin_second; // m_sim_begin in seconds since 1970
+	long long m_last_observer_second; // seconds since m_sim_begin at the previous output step
+
+	BP_Vector_Type m_SS_x, m_SS_u, m_SS_dT;
+	BP_Matrix_Type m_SS_B; // a copy, the first column (heating/cooling) is changed by the spaces
+
+	std::vector<double> m_heating_energy, m_cooling_energy; // [kWh] per dependent state, only used for the spaces
+
+	Eigen::SparseLU<Eigen::SparseMatrix<double> > m_implicit_LU; // decomposition of (I - h*A) used by the implicit solvers
+	double m_implicit_h; // the h of the current decomposition, 0 if there is none
+	BP_Vector_Type m_implicit_u, m_implicit_f, m_implicit_dx; // buffers of the implicit solvers
+	BP_Vector_Type m_exponential_Q, m_exponential_x; // buffers of the exponential solver
+	Eigen::ArrayXd m_space_T, m_space_Q, m_space_dT, m_space_dQ; // buffers of the space controllers, see BP_Space_Controllers::update()
+
+	BP_Observer* m_observer; // writes the results, nullptr when there is no output
+
+	void set_sim_begin(boost::posix_time::ptime sim_begin)
+	{
+		m_sim_begin = sim_begin;
+		m_sim_begin_second = (sim_begin - boost::posix_time::ptime(boost::gregorian::date(1970,1,1))).total_seconds();
+		m_last_observer_second = 0;
+	} // set_sim_begin()
+}; // BP_Period_Context
 
 class BP_Simulation : public BP_Simulation_Vars
 {
@@ -42,17 +70,32 @@ private:
     // also look at BP_Simulation_Vars
 	BP_Vector_Type m_SS_x, m_SS_u, m_SS_dT;
 	BP_Matrix_Type m_SS_A, m_SS_B;
+	std::vector<Eigen::Triplet<double> > m_SS_A_entries, m_SS_B_entries; // added by the dependent states, assembled into m_SS_A and m_SS_B
 
-	std::string m_observer_file;
-	std::ofstream m_observer_stream;
+	// the states grouped by how they change during a simulation (walls, floors and windows are passive and never updated)
+	std::vector<BP_Weather_Profile*> m_time_varying_states; // independent states that change in time
+	std::vector<BP_Indep_State*> m_constant_states; // independent states that are set once per simulation period
+	BP_Space_Controllers* m_space_controllers; // the heating/cooling of all spaces
 
-	void initialize();
+	// exact discretization of the system for the exponential solver, the same for all simulation periods (see discretize_system())
+	double m_exponential_h; // the time step of the discretization, 0 if there is none
+	bool m_exponential_sparse; // whether Phi is used sparse or dense
+	Eigen::MatrixXd m_Phi, m_Gamma_0, m_Gamma_1, m_Gamma_heating;
+	BP_Matrix_Type m_Phi_sparse;
 
-    void ODE_function(const BP_Vector_Type &x, BP_Vector_Type &dxdt, const double& t);
-	void ODE_Jacobi(const BP_Vector_Type &x, BP_Matrix_Type &J, const double& t);
-	void Observer_function(const BP_Vector_Type &x, double t);
-	void init_observer_file(std::string);
-	void end_observer_file();
+	void initialize();
+	void assemble_system();
+	void init_context(BP_Period_Context& context, std::string ID);
+	void update_forcing(BP_Period_Context& context, const double& t);
+
+    void ODE_function(BP_Period_Context& context, const BP_Vector_Type &x, BP_Vector_Type &dxdt, const double& t);
+	void implicit_step(BP_Period_Context& context, BP_Vector_Type &x, const double& t, const double& dt, const double& theta);
+	void discretize_system(const double& h);
+	void exponential_step(BP_Period_Context& context, BP_Vector_Type &x, const double& t, const double& dt);
+	void integrate(BP_Period_Context& context, const double& t_end, const double& time_step);
+	void Observer_function(BP_Period_Context& context, const BP_Vector_Type &x, double t);
+	BP_Observer* create_observer(std::pair<boost::posix_time::ptime, boost::posix_time::ptime> period);
+	void simulate_period(BP_Period_Context& context, std::pair<boost::posix_time::ptime, boost::posix_time::ptime> period);
 
     friend BP_State;
     friend BP_Dep_State;
@@ -63,6 +106,8 @@ private:
     friend BP_Space;
     friend BP_Ground_Profile;
     friend BP_Weather_Profile;
+    friend class BP_Implicit_Stepper;
+    friend class BP_Exponential_Stepper;
 
     unsigned int m_indep_count;
     unsigned int m_dep_count;
@@ -76,7 +121,7 @@ public:
 
     void test_values(); // for testing purposes
 
-    void sim_period();
+    void sim_period(unsigned int n_threads = 0); // simulates all simulation periods, concurrently if n_threads != 1 (0: one per hardware thread)
 
     unsigned int get_wall_count();
     unsigned int get_floor_count();
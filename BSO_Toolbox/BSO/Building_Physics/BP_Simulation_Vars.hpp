@@ -18,6 +18,8 @@ class BP_Window;
 class BP_Space;
 class BP_Ground_Profile;
 class BP_Weather_Profile;
+class BP_Observer;
+struct BP_Space_Controllers;
 struct BP_Building_Results;
 struct BP_Space_Settings;
 struct BP_Material;
@@ -55,9 +57,6 @@ struct BP_Simulation_Vars
     BP_Ground_Profile* m_ground_profile; // this profile simulates the ground temperature
 
 	std::map<std::string, std::pair<boost::posix_time::ptime, boost::posix_time::ptime> > m_simulation_periods;
-    boost::posix_time::ptime m_sim_begin, m_last_observer_moment;
-	boost::posix_time::time_duration m_dt_observer;
-	std::string m_current_sim_period;
 
     bool m_visualisation_model; // will be true when the constructor of the conformal model is used
     std::vector<BP_Vis_Setting> m_vis_settings;
@@ -9,6 +9,7 @@ namespace BSO {
 namespace Building_Physics {
 
 class BP_Simulation;
+struct BP_Period_Context;
 
 /*
  * Adj_State stores a connection
@@ -34,7 +35,7 @@ public:
     BP_State(BP_Simulation* system);
     virtual ~BP_State();
 
-    virtual void update_sys(double t) = 0;
+    virtual void update_sys(BP_Period_Context& context, double t) = 0;
 
     virtual bool is_dep();
     virtual bool is_indep();
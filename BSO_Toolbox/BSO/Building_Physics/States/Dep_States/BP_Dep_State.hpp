@@ -36,7 +36,7 @@ public:
     virtual double get_temp();
 	virtual double get_capacitance();
 
-    virtual void update_sys(double t); // updates the state space system matrices
+    virtual void update_sys(BP_Period_Context& context, double t); // updates the state space system matrices
     virtual bool is_dep();
     virtual void init_sys(); // updates the invariant fluxes in the A and B matrices of the state space system
     virtual void add_adj_state(Adj_State new_adj_state); // adds a state (with respective resistance) to the vector m_capacitors
@@ -131,20 +131,20 @@ bool BP_Dep_State::is_dep()
 } // is_dep()
 
 void BP_Dep_State::init_sys()
-{ // initialise the state space matrices
+{ // add the entries of this state to the state space matrices (they are assembled by BP_Simulation::assemble_system())
 
     for (unsigned int i = 0; i < m_connections.size(); i++)
     { // for each connection to this dependant state, add teir influence
 
         if (m_connections[i].m_state_ptr->is_dep())
         {
-            m_system->m_SS_A(this->get_index(), this->get_index()) += -1/(m_capacitance* m_connections[i].m_resistance);
-            m_system->m_SS_A(this->get_index(), m_connections[i].m_state_ptr->get_index()) += 1/(m_capacitance* m_connections[i].m_resistance);
+            m_system->m_SS_A_entries.push_back(Eigen::Triplet<double>(this->get_index(), this->get_index(), -1/(m_capacitance* m_connections[i].m_resistance)));
+            m_system->m_SS_A_entries.push_back(Eigen::Triplet<double>(this->get_index(), m_connections[i].m_state_ptr->get_index(), 1/(m_capacitance* m_connections[i].m_resistance)));
         }
         else if (m_connections[i].m_state_ptr->is_indep())
         {
-            m_system->m_SS_A(this->get_index(), this->get_index()) += -1/(m_capacitance* m_connections[i].m_resistance);
-            m_system->m_SS_B(this->get_index(), m_connections[i].m_state_ptr->get_index()) += 1/(m_capacitance* m_connections[i].m_resistance);
+            m_system->m_SS_A_entries.push_back(Eigen::Triplet<double>(this->get_index(), this->get_index(), -1/(m_capacitance* m_connections[i].m_resistance)));
+            m_system->m_SS_B_entries.push_back(Eigen::Triplet<double>(this->get_index(), m_connections[i].m_state_ptr->get_index(), 1/(m_capacitance* m_connections[i].m_resistance)));
         }
         else
         {
@@ -154,7 +154,7 @@ void BP_Dep_State::init_sys()
     }
 } // init_sys()
 
-void BP_Dep_State::update_sys(double t)
+void BP_Dep_State::update_sys(BP_Period_Context& context, double t)
 { // empty here
 
 } // update_sys
@@ -38,7 +38,7 @@ namespace Building_Physics {
 
         std::string get_ID();
         bool is_floor();
-        void update_sys(double t); // updates the A and B matrices of the state space system
+        void update_sys(BP_Period_Context& context, double t); // updates the A and B matrices of the state space system
         void show_vars();
 
 
@@ -127,7 +127,7 @@ namespace Building_Physics {
 
     } // dtor
 
-    void BP_Floor::update_sys(double t) // updates the A and B matrices of the state space system
+    void BP_Floor::update_sys(BP_Period_Context& context, double t) // updates the A and B matrices of the state space system
     {
 
     } // update_sys()
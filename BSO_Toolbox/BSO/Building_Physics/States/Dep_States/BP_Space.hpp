@@ -20,9 +20,12 @@ namespace Building_Physics {
 
     // Class definition:
 
+    struct BP_Space_Controllers;
+
     class BP_Space : public BP_Dep_State
     {
     private:
+        friend struct BP_Space_Controllers;
         double m_volume; // volume of the space
         double m_heat_cap, m_cool_cap;
         double m_heat_set_point, m_cool_sep_point;
@@ -35,13 +38,13 @@ namespace Building_Physics {
 
         bool is_space();
 
-        void update_sys(double t); // updates the A and B matrices of the state space system
         std::string get_ID(); // getter function for Space ID
         void show_vars();
 
 
         void set_power_count_zero();
-		void add_Q_load(double dt, double Q);
+		void add_Q_load(BP_Period_Context& context, double dt, double Q);
+		void add_energy(const std::string& sim_ID, double heating, double cooling); // adds the energy used in a simulation period
 
         std::map<std::string, double> get_heating_energy();
         std::map<std::string, double> get_cooling_energy();
@@ -51,6 +54,17 @@ namespace Building_Physics {
 
     }; // BP_Space
 
+    struct BP_Space_Controllers
+    { // the heating/cooling controllers of all spaces of a simulation, updated together, each space heats or cools towards its set points
+      // only the settings are stored here, the controllers are shared by the simulation periods that are solved concurrently
+        std::vector<unsigned int> m_index; // dependent state index of each space
+        Eigen::ArrayXd m_heat_set_point, m_cool_set_point;
+        Eigen::ArrayXd m_Q_max, m_Q_min; // heating/cooling capacity per capacitance
+
+        void initialize(const std::vector<BP_Space*>& spaces);
+        void update(BP_Period_Context& context, double dt);
+    }; // BP_Space_Controllers
+
 
 
 
@@ -87,43 +101,6 @@ namespace Building_Physics {
         return true;
     } // is_space()
 
-    void BP_Space::update_sys(double t) // updates the A and B matrices of the state space system
-    {
-		double current_T = m_system->m_SS_x(m_dep_index);
-		double dQ = 0, current_Q = m_system->m_SS_B(m_dep_index,0);
-		double dT_sys = m_system->m_SS_dT(m_dep_index);
-		double dt = 3600.0 / (m_system->m_time_step_hour);
-
-
-		if (current_T < m_heat_set_point)
-		{ // heating must be added
-			double Q_max = m_heat_cap * m_volume / m_capacitance;
-			dQ = (m_heat_set_point - current_T - dT_sys) / dt;
-			if ((current_Q + dQ) > Q_max) dQ = Q_max - current_Q;
-		}
-		else if (current_T > m_cool_sep_point)
-		{ // cooling must be added
-			double Q_min = -m_cool_cap * m_volume / m_capacitance;
-			dQ = (m_cool_sep_point - current_T - dT_sys) / dt;
-			if ((current_Q + dQ) < Q_min) dQ = Q_min - current_Q;
-		}
-		else
-		{ // either cooling or heating must be decreased, or nothing happens
-			if (current_Q > 0)
-			{ // heating should be decreased
-				dQ = (m_heat_set_point - current_T - dT_sys) / dt;
-				if ((current_Q + dQ) < 0) dQ = -current_Q;
-			}
-			if (current_Q < 0)
-			{ // cooling should be decreased
-				dQ = (m_cool_sep_point - current_T - dT_sys) / dt;
-				if ((current_Q + dQ) > 0) dQ = -current_Q;
-			}
-		}
-
-		m_system->m_SS_B(m_dep_index,0) += dQ;
-    } // update_sys()
-
     std::string BP_Space::get_ID() // getter function for Space ID
     {
         return m_ID;
@@ -152,13 +129,19 @@ namespace Building_Physics {
 		}
     } // set_power_count_zero()
 
-	void BP_Space::add_Q_load(double dt, double Q)
+	void BP_Space::add_Q_load(BP_Period_Context& context, double dt, double Q)
 	{
 		double load = Q*dt / (3600*1000);
-		if (load >= 0) m_sum_heat_power[m_system->m_current_sim_period] += load;
-		else m_sum_cool_power[m_system->m_current_sim_period] -= load;
+		if (load >= 0) context.m_heating_energy[m_dep_index] += load;
+		else context.m_cooling_energy[m_dep_index] -= load;
 	} // add_Q_load()
 
+	void BP_Space::add_energy(const std::string& sim_ID, double heating, double cooling)
+	{
+		m_sum_heat_power[sim_ID] += heating;
+		m_sum_cool_power[sim_ID] += cooling;
+	} // add_energy()
+
     std::map<std::string, double> BP_Space::get_heating_energy()
     {
         return m_sum_heat_power;
@@ -169,6 +152,57 @@ namespace Building_Physics {
         return m_sum_cool_power;
     } // get_cooling_energy()
 
+    void BP_Space_Controllers::initialize(const std::vector<BP_Space*>& spaces)
+    {
+        unsigned int n = spaces.size();
+        m_index.resize(n);
+        m_heat_set_point.resize(n);
+        m_cool_set_point.resize(n);
+        m_Q_max.resize(n);
+        m_Q_min.resize(n);
+
+        for (unsigned int i = 0; i < n; i++)
+        {
+            BP_Space* space = spaces[i];
+            m_index[i] = space->m_dep_index;
+            m_heat_set_point(i) = space->m_heat_set_point;
+            m_cool_set_point(i) = space->m_cool_sep_point;
+            m_Q_max(i) = space->m_heat_cap * space->m_volume / space->m_capacitance;
+            m_Q_min(i) = -space->m_cool_cap * space->m_volume / space->m_capacitance;
+        }
+    } // initialize()
+
+    void BP_Space_Controllers::update(BP_Period_Context& context, double dt)
+    { // the heating/cooling of each state is the first stored entry of its row in B (see BP_Simulation::assemble_system()),
+      // so it is read and written directly in the (compressed) value array of B
+        double* B_values = context.m_SS_B.valuePtr();
+        const int* B_rows = context.m_SS_B.outerIndexPtr();
+        Eigen::ArrayXd& T = context.m_space_T; // buffers of the period, see BP_Simulation::init_context()
+        Eigen::ArrayXd& Q = context.m_space_Q;
+        Eigen::ArrayXd& dT_sys = context.m_space_dT;
+        Eigen::ArrayXd& dQ = context.m_space_dQ;
+        for (unsigned int i = 0; i < m_index.size(); i++)
+        {
+            T(i) = context.m_SS_x(m_index[i]);
+            Q(i) = B_values[B_rows[m_index[i]]];
+            dT_sys(i) = context.m_SS_dT(m_index[i]);
+        }
+
+        // the change in heating (first) or cooling (second) power that brings the space to its set point
+        Eigen::ArrayXd dQ_heat = (m_heat_set_point - T - dT_sys) / dt;
+        Eigen::ArrayXd dQ_cool = (m_cool_set_point - T - dT_sys) / dt;
+
+        dQ = (T < m_heat_set_point).select((Q + dQ_heat > m_Q_max).select(m_Q_max - Q, dQ_heat), // heating must be added
+             (T > m_cool_set_point).select((Q + dQ_cool < m_Q_min).select(m_Q_min - Q, dQ_cool), // cooling must be added
+             (Q > 0).select((Q + dQ_heat < 0).select(-Q, dQ_heat), // heating should be decreased
+             (Q < 0).select((Q + dQ_cool > 0).select(-Q, dQ_cool), 0.0)))); // cooling should be decreased, or nothing happens
+
+        for (unsigned int i = 0; i < m_index.size(); i++)
+        {
+            B_values[B_rows[m_index[i]]] += dQ(i);
+        }
+    } // update()
+
     double BP_Space::get_volume()
     {
         return m_volume;
@@ -37,7 +37,7 @@ namespace Building_Physics {
 
         std::string get_ID();
         bool is_wall();
-        void update_sys(double t); // updates the A and B matrices of the state space system
+        void update_sys(BP_Period_Context& context, double t); // updates the A and B matrices of the state space system
 
         double get_thickness();
         void show_vars();
@@ -127,7 +127,7 @@ namespace Building_Physics {
     } // dtor
 
 
-    void BP_Wall::update_sys(double t) // updates the A and B matrices of the state space system
+    void BP_Wall::update_sys(BP_Period_Context& context, double t) // updates the A and B matrices of the state space system
     {
 
     } // update_sys()
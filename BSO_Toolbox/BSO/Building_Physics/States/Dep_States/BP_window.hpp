@@ -39,7 +39,7 @@ namespace Building_Physics {
 
         std::string get_ID();
         bool is_window();
-        void update_sys(double t); // updates the A and B matrices of the state space system
+        void update_sys(BP_Period_Context& context, double t); // updates the A and B matrices of the state space system
         void show_vars();
 
 
@@ -88,7 +88,7 @@ namespace Building_Physics {
 
     } // dtor
 
-    void BP_Window::update_sys(double t) // updates the A and B matrices of the state space system
+    void BP_Window::update_sys(BP_Period_Context& context, double t) // updates the A and B matrices of the state space system
     {
 
     } // update_sys()
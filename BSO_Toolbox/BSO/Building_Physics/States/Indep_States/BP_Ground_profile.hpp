@@ -23,7 +23,7 @@ public:
 
     bool is_ground_profile();
 
-    void update_sys(double t);
+    void update_sys(BP_Period_Context& context, double t);
     double get_temp();
 }; // BP_Ground_profile
 
@@ -44,9 +44,9 @@ bool BP_Ground_Profile::is_ground_profile()
     return true;
 } // is_ground_profile()
 
-void BP_Ground_Profile::update_sys(double t)
-{ // empty here
-    m_system->m_SS_u(m_index) = m_temperature;
+void BP_Ground_Profile::update_sys(BP_Period_Context& context, double t)
+{ // the ground temperature is constant
+    context.m_SS_u(m_index) = m_temperature;
 } // update_sys
 
 double BP_Ground_Profile::get_temp()
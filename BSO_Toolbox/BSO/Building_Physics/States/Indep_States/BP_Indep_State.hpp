@@ -23,7 +23,7 @@ public:
 
     virtual unsigned int get_index(); // for testing purposes
 
-    virtual void update_sys(double t);
+    virtual void update_sys(BP_Period_Context& context, double t);
     virtual bool is_indep();
     virtual double get_temp();
     virtual void add_adj_state(Adj_State new_adj_state);
@@ -57,7 +57,7 @@ void BP_Indep_State::add_adj_state(Adj_State new_adj_state)
     // function is empty as it will be called upon for independant states however, it should not add adjacent states to the independant class as they have no influence on the state.
 } // add_adj_state()
 
-void BP_Indep_State::update_sys(double t)
+void BP_Indep_State::update_sys(BP_Period_Context& context, double t)
 { // empty here
 
 } // update_sys()
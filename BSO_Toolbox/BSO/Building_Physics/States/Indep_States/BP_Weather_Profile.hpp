@@ -2,18 +2,25 @@
 #define BP_WEATHER_PROFILE_HPP
 
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Field_Scanner.hpp>
 #include <BSO/Building_Physics/States/Indep_States/BP_Indep_State.hpp>
 
-#include <boost/tokenizer.hpp>
-#include <boost/lexical_cast.hpp>
-#include <boost/algorithm/string/trim.hpp>
+#include <boost/algorithm/string.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include <string>
+#include <vector>
 #include <map>
+#include <mutex>
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
 #include <fstream>
 
 
@@ -21,16 +28,29 @@ namespace BSO {
 namespace Building_Physics {
 
 /*
- * BP_Weather_Data is a structure to contain a weather data point
+ * BP_Weather_Cache_Header is the start of a binary weather cache, it is followed by
+ * m_column_count arrays of m_hour_count values (in the units of the weather file)
  */
 
-struct BP_Weather_Data
+struct BP_Weather_Cache_Header
 {
-    double m_temp;
+    char m_magic[8];
+    unsigned int m_version;
+    unsigned int m_column_count;
+    long long m_first_hour; // hours since 1970-01-01 00:00 of the first value
+    unsigned long long m_hour_count;
+    unsigned long long m_checksum; // of the weather file the cache was made from
 };
 
+const char BP_weather_cache_magic[8] = "BSO_WTH";
+const unsigned int BP_weather_cache_version = 1;
+const unsigned int BP_weather_temperature_column = 4; // T, after DD, FH, FF and FX
+const int BP_weather_missing_value = -2147483647 - 1; // empty entries and hours that are not in the weather file
+
 /*
- * BP_Weather_Profile reads the temperature from a weather file at given simulation date and time
+ * BP_Weather_Profile reads the temperature from a weather file at given simulation date and time,
+ * each weather file is converted once to a binary cache next to it, from which only the simulated
+ * periods are read; if the cache cannot be written the periods are taken from the parsed weather file
  */
 
  // Class definition:
@@ -39,17 +59,27 @@ class BP_Weather_Profile : public BP_Indep_State
 {
 private:
     std::string m_weather_file_location;
-    std::map<boost::posix_time::ptime, BP_Weather_Data> m_weather_data; // vector containing pointers to data of weather during the simulation
-	double* m_elapsed_time;
+    std::vector<double> m_hourly_temps; // temperature at each whole hour from m_first_hour on, NaN where it is unknown
+    long long m_first_hour; // hours since 1970-01-01 00:00 of the first entry in m_hourly_temps
+    std::map<std::string, std::pair<BP_Weather_Cache_Header, std::vector<int> > > m_uncached_files; // parsed weather files of which the cache could not be written
 
     std::string find_weather_file(const int& year);
-    double m_temperature;
+
+    static unsigned long long weather_file_checksum(const std::string& file_name);
+    static bool parse_weather_file(const std::string& file_name, BP_Weather_Cache_Header& header, std::vector<int>& values);
+    static bool write_weather_cache(const std::string& cache_name, const BP_Weather_Cache_Header& header, const std::vector<int>& values);
+    bool read_weather_cache(const std::string& file_name, const std::string& cache_name, boost::posix_time::ptime& begin, const boost::posix_time::ptime& end);
+    static void weather_range(const std::string& file_name, const BP_Weather_Cache_Header& header, const boost::posix_time::ptime& begin,
+                              const boost::posix_time::ptime& end, long long& first_hour, long long& last_hour);
+    void store_temperatures(const int* temperatures, long long first_hour, long long last_hour, boost::posix_time::ptime& begin);
+    double& hourly_temp(long long hour); // extends m_hourly_temps if needed
 public:
     BP_Weather_Profile(BP_Simulation* system, std::string weather_file_location); // initialises the weather profile to the start date, defines end date and how many time steps per hour are used
     ~BP_Weather_Profile();
 
 	void add_weather_data(boost::posix_time::ptime begin, boost::posix_time::ptime end);
-    void update_sys(double t);
+    static bool write_weather_cache(const std::string& file_name, const std::string& cache_name); // converts a weather file to a binary cache
+    void update_sys(BP_Period_Context& context, double t);
     bool is_weather_profile();
 }; // BP_Weather_Profile
 
@@ -65,6 +95,7 @@ public:
 BP_Weather_Profile::BP_Weather_Profile(BP_Simulation* system, std::string weather_file_location) : BP_Indep_State(system)
 {
     m_weather_file_location = weather_file_location;
+    m_first_hour = 0;
 } // ctor
 
 
@@ -80,98 +111,257 @@ void BP_Weather_Profile::add_weather_data(boost::posix_time::ptime begin, boost:
 	if (warm_up_days*24*3600 > (end - begin).total_seconds())
 	{
 		end = begin + boost::posix_time::hours(warm_up_days*24);
-		end += boost::posix_time::hours(1.0);
+		end += boost::posix_time::hours(1);
 	}
 	else
 	{
-		end += boost::posix_time::hours(1.0);
+		end += boost::posix_time::hours(1);
+	}
+	begin -= boost::posix_time::hours(1);
+
+	const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+	long long first_hour = (begin - epoch).hours();
+	long long last_hour = (end - epoch).hours();
+
+	while (begin <= end)
+	{ // read the data from the cache of each weather file that covers a part of the requested period
+		std::string file_name = m_weather_file_location + find_weather_file(begin.date().year()); // find the file that contains the given year
+		std::string cache_name = file_name.substr(0, file_name.find_last_of('.')) + ".bin";
+
+		std::map<std::string, std::pair<BP_Weather_Cache_Header, std::vector<int> > >::iterator uncached = m_uncached_files.find(file_name);
+		if (uncached == m_uncached_files.end() && !read_weather_cache(file_name, cache_name, begin, end))
+		{ // the cache does not exist yet or belongs to another version of the weather file
+			BP_Weather_Cache_Header header;
+			std::vector<int> values;
+			if (!parse_weather_file(file_name, header, values))
+			{
+				std::cerr << "Error, no temperatures found in weather file \"" << file_name << "\", exiting now..." << std::endl;
+				exit(1);
+			}
+			if (!write_weather_cache(cache_name, header, values) || !read_weather_cache(file_name, cache_name, begin, end))
+			{ // e.g. the weather directory is read-only, the simulation does not depend on the cache
+				std::cerr << "Warning, could not write weather cache \"" << cache_name << "\", using the weather file instead" << std::endl;
+				uncached = m_uncached_files.insert(std::make_pair(file_name, std::make_pair(header, std::vector<int>()))).first;
+				uncached->second.second.swap(values);
+			}
+		}
+		if (uncached != m_uncached_files.end())
+		{ // read the data from the parsed weather file
+			const BP_Weather_Cache_Header& header = uncached->second.first;
+			long long first_hour, last_hour;
+			weather_range(file_name, header, begin, end, first_hour, last_hour);
+			store_temperatures(uncached->second.second.data() + header.m_hour_count*BP_weather_temperature_column + (first_hour - header.m_first_hour),
+			                   first_hour, last_hour, begin);
+		}
 	}
-	begin -= boost::posix_time::hours(1.0);
 
-	boost::posix_time::ptime current_time;
-	while (current_time != end)
-    {
-        std::string file_name = m_weather_file_location + find_weather_file(begin.date().year()); // find the file that contains the given year
-        boost::gregorian::date current_date;
-
-        std::fstream input(file_name.c_str());
-        std::string line;
-        unsigned int file_position = 0;
-        boost::char_separator<char> sep(",");
-        typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer;
-        for (unsigned int i = 0; i < 33; i++)
-        { // for 33 times
-            getline(input, line); // to skip the heading of the weather files
-        }
-
-        while (begin != current_time) // keep reading lines in the file until the correct line has been found, this is a time consuming approach (15 seconds if the starting date is the last file entry)
-        {
-            file_position = input.tellg(); // position before getline, because when it is the searched line the position must be stored
-            getline(input, line); // get next line from the file
-            t_tokenizer tok(line, sep);
-            t_tokenizer::iterator token = tok.begin();
-
-            token++; // skip first token: STN
-            current_date = boost::gregorian::date(boost::gregorian::from_undelimited_string(*token) );token++; // date
-            current_time = boost::posix_time::ptime(current_date, boost::posix_time::hours(BSO::trim_and_cast_int(*token) ) ); // add time
-        }
-
-        input.seekg(file_position);
-
-        while (end > current_time)
-        {
-            getline(input, line); // get next line from the file
-            boost::algorithm::trim(line);
-
-            if (input.eof())
-            { // if this is the end of the file
-                begin = current_time + boost::posix_time::hours(1); // then create the next time point, that should be in the next file
-                break; // escape the current while loop
-            }
-
-            if (line == "")
-            { // if the line is empty
-                continue; // continue to the next line
-            }
-
-            t_tokenizer tok(line, sep);
-            t_tokenizer::iterator token = tok.begin();
-
-            token++; // skip first token STN
-
-            current_date = boost::gregorian::date(boost::gregorian::from_undelimited_string(*token) ); token++; // date
-            current_time = boost::posix_time::ptime(current_date, boost::posix_time::hours(BSO::trim_and_cast_int(*token) ) ); token++; // add time
-
-            BP_Weather_Data temp; // temporary data structure to hold the tokenized data
-
-            token++; // skip DD = Mean wind direction (in degrees) during the 10-minute period preceding the time of observation (360=north, 90=east, 180=south, 270=west, 0=calm 990=variable)
-            token++; // skip FH = Hourly mean wind speed (in 0.1 m/s)
-            token++; // skip FF = Mean wind speed (in 0.1 m/s) during the 10-minute period preceding the time of observation
-            token++; // skip FX = Maximum wind gust (in 0.1 m/s) during the hourly division
-            temp.m_temp = trim_and_cast_double(*token)/10.0;token++; // temperature (in tenths of degrees Celsius)
-            /*token++; // skip T10N = Minimum temperature (in 0.1 degrees Celsius) at 0.1 m in the preceding 6-hour period
-            token++; // skip TD = Dew point temperature (in 0.1 degrees Celsius) at 1.50 m at the time of observation
-            token++; // skip SQ = Sunshine duration (in 0.1 hour) during the hourly division, calculated from global radiation (-1 for <0.05 hour)
-            token++; // skip Q = Global radiation (in J/cm2) during the hourly division
-            token++; // skip DR = Precipitation duration (in 0.1 hour) during the hourly division
-            token++; // skip RH = Hourly precipitation amount (in 0.1 mm) (-1 for <0.05 mm)
-            token++; // skip P = Air pressure (in 0.1 hPa) reduced to mean sea level, at the time of observation
-            token++; // skip VV = Horizontal visibility at the time of observation (0=less than 100m, 1=100-200m, 2=200-300m,..., 49=4900-5000m, 50=5-6km, 56=6-7km, 57=7-8km, ..., 79=29-30km, 80=30-35km, 81=35-40km,..., 89=more than 70km)
-            token++; // skip N = Cloud cover (in octants), at the time of observation (9=sky invisible)
-            token++; // skip U = Relative atmospheric humidity (in percents) at 1.50 m at the time of observation
-            token++; // skip WW = Present weather code (00-99), description for the hourly division. See http://www.knmi.nl/klimatologie/achtergrondinformatie/ww_lijst_engels.pdf
-            token++; // skip IX = Indicator present weather code (1=manned and recorded (using code from visual observations), 2,3=manned and omitted (no significant weather phenomenon to report, not available), 4=automatically recorded (using code from visual observations), 5,6=automatically omitted (no significant weather phenomenon to report, not available), 7=automatically set (using code from automated observations)
-            token++; // skip M = Fog 0=no occurrence, 1=occurred during the preceding hour and/or at the time of observation
-            token++; // skip R = Rainfall 0=no occurrence, 1=occurred during the preceding hour and/or at the time of observation
-            token++; // skip S = Snow 0=no occurrence, 1=occurred during the preceding hour and/or at the time of observation
-            token++; // skip O = Thunder  0=no occurrence, 1=occurred during the preceding hour and/or at the time of observation
-            // skip final token: Y = Ice formation 0=no occurrence, 1=occurred during the preceding hour and/or at the time of observation*/
-
-            m_weather_data[current_time] = temp;
-        }
-    }
+	for (long long i = first_hour + 1; i < last_hour; i++)
+	{ // interpolate hours that are missing in the weather file between their known neighbours
+		if (std::isnan(hourly_temp(i)))
+		{
+			long long next = i + 1;
+			while (next < last_hour && std::isnan(hourly_temp(next))) next++;
+			if (std::isnan(hourly_temp(i - 1)) || std::isnan(hourly_temp(next))) continue;
+			for (long long j = i; j < next; j++)
+			{
+				hourly_temp(j) = hourly_temp(i - 1) + (hourly_temp(next) - hourly_temp(i - 1))*(j - i + 1)/(next - i + 1);
+			}
+			i = next;
+		}
+	}
 } // add_weather_data()
 
+double& BP_Weather_Profile::hourly_temp(long long hour)
+{
+	if (m_hourly_temps.empty())
+	{
+		m_first_hour = hour;
+	}
+	if (hour < m_first_hour)
+	{
+		m_hourly_temps.insert(m_hourly_temps.begin(), m_first_hour - hour, std::numeric_limits<double>::quiet_NaN());
+		m_first_hour = hour;
+	}
+	if (hour - m_first_hour >= (long long)m_hourly_temps.size())
+	{
+		m_hourly_temps.resize(hour - m_first_hour + 1, std::numeric_limits<double>::quiet_NaN());
+	}
+	return m_hourly_temps[hour - m_first_hour];
+} // hourly_temp()
+
+unsigned long long BP_Weather_Profile::weather_file_checksum(const std::string& file_name)
+{ // FNV-1a hash of the content of a file, validated checksums are kept for the rest of the run
+	static std::map<std::string, unsigned long long> checksums;
+	static std::mutex checksums_mutex;
+	std::lock_guard<std::mutex> lock(checksums_mutex);
+	if (checksums.find(file_name) != checksums.end())
+	{
+		return checksums[file_name];
+	}
+
+	std::ifstream input(file_name.c_str(), std::ios::binary);
+	if (!input)
+	{
+		std::cerr << "Error, could not open weather file \"" << file_name << "\", exiting now..." << std::endl;
+		exit(1);
+	}
+	unsigned long long hash = 14695981039346656037ULL;
+	std::vector<char> buffer(1 << 20);
+	while (input)
+	{
+		input.read(buffer.data(), buffer.size());
+		std::streamsize count = input.gcount();
+		for (std::streamsize i = 0; i < count; i++)
+		{
+			hash ^= (unsigned char)buffer[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+	checksums[file_name] = hash;
+	return hash;
+} // weather_file_checksum()
+
+bool BP_Weather_Profile::write_weather_cache(const std::string& file_name, const std::string& cache_name)
+{ // converts a KNMI weather file to a binary cache
+	BP_Weather_Cache_Header header;
+	std::vector<int> values;
+	return parse_weather_file(file_name, header, values) && write_weather_cache(cache_name, header, values);
+} // write_weather_cache()
+
+bool BP_Weather_Profile::parse_weather_file(const std::string& file_name, BP_Weather_Cache_Header& header, std::vector<int>& values)
+{ // parses a KNMI weather file into the content of a binary cache: a header followed by the hourly values of each column (all columns
+  // after STN, YYYYMMDD and HH), stored column by column and indexed by the hours since the first entry in the file;
+  // returns false if the file contains no temperatures
+	Field_Scanner input(file_name, ",", true); // empty fields are missing values
+	if (!input.is_open())
+	{
+		std::cerr << "Error, could not open weather file \"" << file_name << "\", exiting now..." << std::endl;
+		exit(1);
+	}
+
+	const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+	std::vector<long long> hours; // hours since the epoch of each line
+	std::vector<std::vector<int> > columns;
+	input.skip_lines(33); // to skip the heading of the weather files
+	while (input.next_line())
+	{ // empty lines are skipped
+		if (input.field_count() < 4)
+		{
+			continue;
+		}
+		int date = input.get_int(1); // YYYYMMDD
+		boost::gregorian::date current_date(date / 10000, (date / 100) % 100, date % 100);
+		boost::posix_time::ptime current_time(current_date, boost::posix_time::hours(input.get_int(2)));
+		hours.push_back((current_time - epoch).hours());
+
+		if (columns.empty())
+		{
+			columns.resize(input.field_count() - 3);
+		}
+		for (unsigned int i = 0; i < columns.size(); i++)
+		{
+			bool missing = (i + 3 >= input.field_count() || input.field_is_empty(i + 3));
+			columns[i].push_back((missing) ? BP_weather_missing_value : input.get_int(i + 3));
+		}
+	}
+	if (hours.empty() || columns.size() <= BP_weather_temperature_column)
+	{
+		return false;
+	}
+
+	std::memcpy(header.m_magic, BP_weather_cache_magic, sizeof(header.m_magic));
+	header.m_version = BP_weather_cache_version;
+	header.m_column_count = columns.size();
+	header.m_first_hour = *std::min_element(hours.begin(), hours.end());
+	header.m_hour_count = *std::max_element(hours.begin(), hours.end()) - header.m_first_hour + 1;
+	header.m_checksum = weather_file_checksum(file_name);
+
+	values.assign(header.m_column_count*header.m_hour_count, BP_weather_missing_value); // hours that are not in the file are missing values
+	for (unsigned int i = 0; i < columns.size(); i++)
+	{
+		int* column_data = values.data() + i*header.m_hour_count;
+		for (unsigned int j = 0; j < hours.size(); j++)
+		{
+			column_data[hours[j] - header.m_first_hour] = columns[i][j];
+		}
+	}
+	return true;
+} // parse_weather_file()
+
+bool BP_Weather_Profile::write_weather_cache(const std::string& cache_name, const BP_Weather_Cache_Header& header, const std::vector<int>& values)
+{ // writes the content of a cache made by parse_weather_file(), returns false if the cache could not be written
+	std::ofstream output(cache_name.c_str(), std::ios::binary | std::ios::trunc);
+	if (!output)
+	{
+		return false;
+	}
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(int));
+	output.close();
+	return !output.fail();
+} // write_weather_cache()
+
+bool BP_Weather_Profile::read_weather_cache(const std::string& file_name, const std::string& cache_name,
+                                            boost::posix_time::ptime& begin, const boost::posix_time::ptime& end)
+{ // maps the part of the temperature column in the cache from begin until end (or the end of the cache) and stores it in the weather data,
+  // begin is moved to the first hour after the stored data; returns false if the cache is missing or does not match the weather file
+	namespace bip = boost::interprocess;
+	const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+	try
+	{
+		bip::file_mapping cache(cache_name.c_str(), bip::read_only);
+		BP_Weather_Cache_Header header;
+		{
+			bip::mapped_region header_region(cache, bip::read_only, 0, sizeof(header));
+			std::memcpy(&header, header_region.get_address(), sizeof(header));
+		}
+		if (std::memcmp(header.m_magic, BP_weather_cache_magic, sizeof(header.m_magic)) != 0 ||
+			header.m_version != BP_weather_cache_version ||
+			header.m_column_count <= BP_weather_temperature_column ||
+			header.m_checksum != weather_file_checksum(file_name))
+		{
+			return false;
+		}
+
+		long long first_hour, last_hour;
+		weather_range(file_name, header, begin, end, first_hour, last_hour);
+
+		std::size_t offset = sizeof(header) + (header.m_hour_count*BP_weather_temperature_column + (first_hour - header.m_first_hour))*sizeof(int);
+		bip::mapped_region region(cache, bip::read_only, offset, (last_hour - first_hour + 1)*sizeof(int));
+		store_temperatures(static_cast<const int*>(region.get_address()), first_hour, last_hour, begin);
+	}
+	catch (bip::interprocess_exception& e)
+	{ // e.g. the cache does not exist
+		return false;
+	}
+	return true;
+} // read_weather_cache()
+
+void BP_Weather_Profile::weather_range(const std::string& file_name, const BP_Weather_Cache_Header& header, const boost::posix_time::ptime& begin,
+                                       const boost::posix_time::ptime& end, long long& first_hour, long long& last_hour)
+{ // the hours since the epoch of the part from begin until end (or the end of the data) that a weather file with this header covers
+	const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+	first_hour = (begin - epoch).hours();
+	last_hour = std::min((long long)(end - epoch).hours(), header.m_first_hour + (long long)header.m_hour_count - 1);
+	if (first_hour < header.m_first_hour || first_hour > last_hour)
+	{
+		std::cerr << "Error, no weather data for " << begin << " in \"" << file_name << "\", exiting now..." << std::endl;
+		exit(1);
+	}
+} // weather_range()
+
+void BP_Weather_Profile::store_temperatures(const int* temperatures, long long first_hour, long long last_hour, boost::posix_time::ptime& begin)
+{ // stores the temperatures of the hours first_hour until last_hour in the weather data, begin is moved to the first hour after them
+	for (long long i = 0; i <= last_hour - first_hour; i++)
+	{
+		if (temperatures[i] != BP_weather_missing_value)
+		{
+			hourly_temp(first_hour + i) = temperatures[i]/10.0; // temperature (in tenths of degrees Celsius)
+		}
+	}
+	begin += boost::posix_time::hours(last_hour - first_hour + 1);
+} // store_temperatures()
+
 std::string BP_Weather_Profile::find_weather_file(const int& year)
 {
     int m_year = year-((year-1)%10);
@@ -207,18 +397,20 @@ bool BP_Weather_Profile::is_weather_profile()
     return true;
 } // is_weather_profile()
 
-void BP_Weather_Profile::update_sys(double t)
-{ // update the external temperature using the weather data
-    boost::posix_time::ptime current_time = m_system->m_sim_begin + boost::posix_time::seconds(t); // get the current time from BP_Simulation
-    boost::posix_time::ptime lower_bound  = boost::posix_time::ptime(current_time.date(), boost::posix_time::hours(current_time.time_of_day().hours())); // get the current or previous temperature data entry by rounding down to hours
-    boost::posix_time::ptime upper_bound  = lower_bound + boost::posix_time::hours(1);  // get next entry temperature data (i.e. one hour later)
+void BP_Weather_Profile::update_sys(BP_Period_Context& context, double t)
+{ // update the external temperature by linear interpolation between the hourly temperatures, t is rounded to whole seconds
+    long long second = context.m_sim_begin_second - m_first_hour*3600 + (long long)t; // seconds since the first hourly temperature
+    long long hour = (second >= 0) ? second/3600 : (second - 3599)/3600; // the current or previous hourly temperature
+    if (hour < 0 || hour + 1 >= (long long)m_hourly_temps.size() || std::isnan(m_hourly_temps[hour]) || std::isnan(m_hourly_temps[hour + 1]))
+    {
+        std::cerr << "Error, no weather data for " << context.m_sim_begin + boost::posix_time::seconds((long)t) << ", exiting now..." << std::endl;
+        exit(1);
+    }
 
-    double d_time_tot = (double)((upper_bound-lower_bound).total_seconds()); // calculate how far time has progressed into the current data entry
-    double d_temp_tot = m_weather_data[upper_bound].m_temp - m_weather_data[lower_bound].m_temp; // calculate how far temperature will progress in the current data entry
-    double d_time = (double)((current_time-lower_bound).total_seconds()); // calculate how far time has progressed into the current data entry
+    double d_temp_tot = m_hourly_temps[hour + 1] - m_hourly_temps[hour]; // calculate how far temperature will progress in the current data entry
+    double d_time = (double)(second - hour*3600); // calculate how far time has progressed into the current data entry
 
-    m_temperature = (d_temp_tot/d_time_tot)*(d_time) + m_weather_data[lower_bound].m_temp;
-    m_system->m_SS_u(m_index) = m_temperature; // update the system with the current temperature
+    context.m_SS_u(m_index) = (d_temp_tot/3600.0)*(d_time) + m_hourly_temps[hour]; // update the system with the current temperature
 } // update_sys()
 
 
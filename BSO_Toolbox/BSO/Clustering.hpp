@@ -10,6 +10,11 @@
 #include <map>
 #include <memory>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <Eigen/Dense>
 
 namespace BSO {
@@ -77,177 +82,307 @@ void calc_variances(std::vector<std::shared_ptr<Cluster> > x_k, dist_function d_
 
 
 
-std::vector<std::shared_ptr<Cluster> > k_means(std::shared_ptr<std::vector<data_point> > x, unsigned int k, dist_function d_func)
-{
-	// initialise the random number generator
-	std::mt19937 rand_num_engine;
-	rand_num_engine.seed(std::random_device()());
+struct K_Means_Data
+{ // the data set of the k-means algorithm: one column per data point, normalised beforehand if the distance is normalised,
+  // so that all distances are Euclidian distances between columns
+    Eigen::MatrixXd m_points;
+    data_point m_offset; // to map a (normalised) centroid back to the data set: offset + range .* centroid
+    data_point m_range;
 
-    // initialise centroids to random points inside the data set (i.e. select k random data_points to serve as centroids)
-    std::vector<std::shared_ptr<Cluster> > x_k; // will contain all clusters
+    K_Means_Data(const std::vector<data_point>& x, dist_function d_func)
+    {
+        m_points.resize(x.front().rows(), x.size());
+        for (unsigned int i = 0; i < x.size(); i++)
+        {
+            m_points.col(i) = x[i];
+        }
 
-    if (k > x->size())
+        if (d_func.m_tag == dist_function::Normalised)
+        {
+            m_offset = d_func.m_min;
+            m_range = d_func.m_max - d_func.m_min;
+            m_points = (m_points.colwise() - m_offset).array().colwise() / m_range.array();
+        }
+        else
+        {
+            m_offset = data_point::Zero(m_points.rows());
+            m_range = data_point::Ones(m_points.rows());
+        }
+    }
+}; // K_Means_Data
+
+void k_means_assign(const Eigen::MatrixXd& points, const Eigen::MatrixXd& centroids, const Eigen::VectorXd& centroid_norms,
+                    std::vector<unsigned int>& assignment, unsigned int begin, unsigned int end)
+{ // assigns the points 'begin' up to 'end' to the closest centroid
+  // |x-c|^2 = |x|^2 - 2 x.c + |c|^2, where |x|^2 is the same for each centroid, so the closest centroid has the smallest |c|^2 - 2 x.c
+  // the products x.c are computed for a block of points at a time, as one matrix product
+    const unsigned int block_size = 256;
+    Eigen::MatrixXd products;
+    for (unsigned int b = begin; b < end; b += block_size)
     {
-        std::cout << "Error in k-means clustering (Clustering.hpp) number of clusters is larger than " << std::endl
-                  << "the number of data points in the given data set, exiting now..." << std::endl;
-        exit(1);
+        unsigned int n = std::min(block_size, end - b);
+        products.noalias() = centroids.transpose() * points.middleCols(b, n);
+
+        for (unsigned int j = 0; j < n; j++)
+        { // for each point in the block
+            unsigned int closest_cluster = 0;
+            double min_dist = centroid_norms(0) - 2*products(0, j);
+            for (unsigned int i = 1; i < centroids.cols(); i++)
+            {
+                double distance = centroid_norms(i) - 2*products(i, j);
+                if (min_dist > distance)
+                {
+                    min_dist = distance;
+                    closest_cluster = i;
+                }
+            }
+            assignment[b + j] = closest_cluster;
+        }
     }
-    else if (k > x->size()/2.0)
+} // k_means_assign()
+
+void k_means_plus_plus(const Eigen::MatrixXd& points, Eigen::MatrixXd& centroids, std::mt19937& rand_num_engine)
+{ // k-means++ seeding: the first centroid is a random data point, each next centroid is a data point chosen
+  // with a probability proportional to its squared distance to the closest centroid chosen so far
+    unsigned int n_points = points.cols();
+    std::uniform_int_distribution<unsigned int> first(0, n_points-1);
+    centroids.col(0) = points.col(first(rand_num_engine));
+
+    std::vector<double> min_dist(n_points); // squared distance of each data point to its closest centroid
+    for (unsigned int j = 0; j < n_points; j++)
     {
-        std::vector<unsigned int> rand_array(x->size());
+        min_dist[j] = (points.col(j) - centroids.col(0)).squaredNorm();
+    }
 
-        for (unsigned int i = 0; i < x->size(); i++)
-        { // initialise an array with the index numbers of the data set
-            rand_array[i] = i;
+    for (unsigned int i = 1; i < centroids.cols(); i++)
+    { // for each remaining centroid
+        double sum = 0;
+        for (unsigned int j = 0; j < n_points; j++)
+        {
+            sum += min_dist[j];
         }
-        std::shuffle(rand_array.begin(), rand_array.end(), rand_num_engine); // shuffle the indices in a random manner
 
-        for (unsigned int i = 0; i < k; i++)
-        { // the first k numbers in the shuffled list will be assigned to each clusters centroid
-            x_k.push_back(std::make_shared<Cluster>((*x)[rand_array[i] ], std::weak_ptr<std::vector<data_point> >(x)));
-        }
-    }
-    else
-    { // Fisher-Yates shuffle
-		std::vector<unsigned int> blacklist;
-        for (unsigned int i = 0; i < k; i++)
-        { // for each cluster
-            unsigned int r; // will contain a (unique) random number
-            do
+        unsigned int r = n_points-1; // will hold the index of the chosen data point
+        if (sum > 0)
+        {
+            std::uniform_real_distribution<double> distribution(0.0, sum);
+            double target = distribution(rand_num_engine);
+            for (unsigned int j = 0; j < n_points; j++)
             {
-                std::uniform_int_distribution<std::mt19937::result_type> distribution(0, x->size()-1);
-				r = distribution(rand_num_engine);
-            }while (std::find(blacklist.begin(), blacklist.end(), r) != blacklist.end()); // continue seeding a random number untill a new unique random number is found
+                target -= min_dist[j];
+                if (target < 0)
+                {
+                    r = j;
+                    break;
+                }
+            }
+        }
+        else
+        { // all data points coincide with a centroid
+            r = first(rand_num_engine);
+        }
+        centroids.col(i) = points.col(r);
 
-            blacklist.push_back(r); // if the random number is unique put it in the black list
-            x_k.push_back(std::make_shared<Cluster>((*x)[r], std::weak_ptr<std::vector<data_point> >(x))); // assigned the data point with index r as a centroid to cluster k
-            x_k.back()->m_d_func = d_func; // stores what dist-function was use to create this cluster
+        for (unsigned int j = 0; j < n_points; j++)
+        {
+            min_dist[j] = std::min(min_dist[j], (points.col(j) - centroids.col(i)).squaredNorm());
         }
     }
+} // k_means_plus_plus()
+
+void k_means_lloyd(const Eigen::MatrixXd& points, Eigen::MatrixXd& centroids, std::vector<unsigned int>& assignment,
+                   std::vector<unsigned int>& sizes, unsigned int n_threads = 0)
+{ // Lloyd's iterations from the given centroids (one column per cluster) until no centroid moves anymore
+  // assignment holds the index of the cluster of each data point afterwards and sizes the number of data points in each cluster
+    unsigned int n_points = points.cols();
+    unsigned int k = centroids.cols();
+
+    // the assignment is only split over threads if the data set is large enough to make up for starting the threads
+    if (n_threads == 0)
+    {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if ((double)n_points * k * points.rows() < 1.0e6)
+    {
+        n_threads = 1;
+    }
+    n_threads = std::min(n_threads, n_points);
+
+    assignment.resize(n_points);
+    sizes.resize(k);
+    Eigen::MatrixXd sums(points.rows(), k); // sum of the data points of each cluster
 
     bool convergence = false; // check to see if the algorithm has converged on clustering or not
     while (!convergence)
     {
-        convergence = true; // set to true, and put back to false as soon a data point switches cluster
+        convergence = true; // set to true, and put back to false as soon as a centroid changes position
 
-        // initialize bit masks and sizes of each cluster
-        for (unsigned int i = 0; i < k; i++)
-        { // for each cluster
-            x_k[i]->m_size = 0; // set the variable that keeps track of the cluster size to zero
-            x_k[i]->m_mean.setZero(); // set the mean of this cluster to a zero vector
-            for (unsigned int j = 0; j < x->size(); j++)
-            { // set the bit mask to false for each data point
-                if (x_k[i]->m_bit_mask[j])
-                    x_k[i]->m_bit_mask[j] = false;
+        // assign each data point to a cluster based on its distance to each cluster
+        Eigen::VectorXd centroid_norms = centroids.colwise().squaredNorm().transpose();
+        if (n_threads <= 1)
+        {
+            k_means_assign(points, centroids, centroid_norms, assignment, 0, n_points);
+        }
+        else
+        {
+            std::vector<std::thread> workers;
+            for (unsigned int t = 0; t < n_threads; t++)
+            { // each thread assigns a contiguous part of the data set
+                unsigned int begin = (unsigned long)n_points*t/n_threads;
+                unsigned int end = (unsigned long)n_points*(t+1)/n_threads;
+                workers.push_back(std::thread(k_means_assign, std::cref(points), std::cref(centroids), std::cref(centroid_norms),
+                                              std::ref(assignment), begin, end));
+            }
+            for (unsigned int t = 0; t < n_threads; t++)
+            {
+                workers[t].join();
             }
         }
 
-        // assign each data point to a cluster based on its distance to each cluster
-        double min_dist;
-        for (unsigned int i = 0; i < x->size(); i ++)
-        { // for each data point
-            unsigned int closest_cluster = 0; // will hold the index to the closest cluster
-            min_dist = d_func.calc((*x)[i], x_k[0]->m_centroid); // initialise with the distance to the first centroid
-
-            for (unsigned int j = 1; j < x_k.size(); j++)
-            { // for the remaining clusters
-                double distance = d_func.calc((*x)[i], x_k[j]->m_centroid); // find the distance of the centroid of cluster j to data point i
-                // check if the distance to centroid j is smaller
-                if (min_dist > distance)
-                {
-                    min_dist = distance; // if it is, then this is now the smallest distance
-                    closest_cluster = j; // and cluster j contains the centroid closest to data point i
-                }
-            } // at the end of this loop the cluster with the centroid closest to data point i is known
-
-            x_k[closest_cluster]->m_bit_mask[i] = true; // update bit_mask index i in the cluster with its centroid closest to data point i
-            x_k[closest_cluster]->m_size++; // increment the size of this cluster
-            x_k[closest_cluster]->m_mean += (*x)[i]; // add this data point to the summation of the mean
+        std::fill(sizes.begin(), sizes.end(), 0);
+        sums.setZero();
+        for (unsigned int i = 0; i < n_points; i++)
+        { // add each data point to the summation of the mean of its cluster
+            sizes[assignment[i]]++;
+            sums.col(assignment[i]) += points.col(i);
         }
 
-        for (unsigned int i = 0; i < x_k.size(); i++)
+        for (unsigned int i = 0; i < k; i++)
         {
             // check if a cluster is empty
-            if (x_k[i]->m_size == 0)
+            if (sizes[i] == 0)
             { // if this cluster is empty, then it will be filled with the furthest point of the largest cluster
-                // initiation of trackers
                 unsigned int largest_cluster_size = 0;
                 unsigned int largest_cluster_index = 0;
-                for (unsigned int j = 0; j < x_k.size(); j++)
+                for (unsigned int j = 0; j < k; j++)
                 { // for all other clusters
-
-                    if ((i != j) && (x_k[j]->m_size > largest_cluster_size))
-                    { // if the size of this cluster if larger that the currently largest found cluster
-                        // update the trackers for the larget cluster
-                        largest_cluster_size = x_k[j]->m_size;
+                    if ((i != j) && (sizes[j] > largest_cluster_size))
+                    { // update the trackers for the largest cluster
+                        largest_cluster_size = sizes[j];
                         largest_cluster_index = j;
                     }
-                    else
-                    { // if not just keep searching for large clusters
-                        continue;
-                    }
                 } // found the index to the largest cluster
 
-                // now need to find the furthest point away in the largest cluster
-                // to find that, first the new centroid (i.e. new mean) of this largest cluster needs to be calculated
-                data_point largest_cluster_mean = x_k[largest_cluster_index]->m_mean / x_k[largest_cluster_index]->m_size; // calculate the mean
-
-                // now the point furthest away from this mean is searched
-                // initiation of trackers
+                // now the point furthest away from the mean of the largest cluster is searched
+                Eigen::VectorXd largest_cluster_mean = sums.col(largest_cluster_index) / sizes[largest_cluster_index];
                 double furthest_point_distance = 0;
                 unsigned int furthest_point_index = 0;
 
-                for (unsigned int j = 0; j < x->size(); j++)
-                { // for all data points in the data set
-                    if (x_k[largest_cluster_index]->m_bit_mask[j])
-                    { // if point j belongs to the largest cluster
-                        if (furthest_point_distance < d_func.calc((*x)[j], largest_cluster_mean))
-                        { // and if the distance of point j to the mean of the largest cluster is larger than the current furthest distance
-                            // update the trackers for the furthest away point
-                            furthest_point_distance = d_func.calc((*x)[j], largest_cluster_mean);
+                for (unsigned int j = 0; j < n_points; j++)
+                { // for all data points in the largest cluster
+                    if (assignment[j] == largest_cluster_index)
+                    {
+                        double distance = (points.col(j) - largest_cluster_mean).squaredNorm();
+                        if (furthest_point_distance < distance)
+                        { // update the trackers for the furthest away point
+                            furthest_point_distance = distance;
                             furthest_point_index = j;
                         }
                     }
                 } // found the furthest away point in the largest cluster
 
-                // remove this point from the largest cluster
-                x_k[largest_cluster_index]->m_mean -= (*x)[furthest_point_index];
-                x_k[largest_cluster_index]->m_size--;
-                x_k[largest_cluster_index]->m_bit_mask[furthest_point_index] = false;
-
-                // add the found point to the empty cluster
-                x_k[i]->m_mean += (*x)[furthest_point_index];
-                x_k[i]->m_size++;
-                x_k[i]->m_bit_mask[furthest_point_index] = true;
-
-            }
-            else
-            { // if this cluster is not empty then continue checking the rest of the clusters
-                continue;
+                // move this point from the largest cluster to the empty cluster
+                sums.col(largest_cluster_index) -= points.col(furthest_point_index);
+                sizes[largest_cluster_index]--;
+                sums.col(i) += points.col(furthest_point_index);
+                sizes[i]++;
+                assignment[furthest_point_index] = i;
             }
         }
 
         // calculate new centroids
-        for (unsigned int i = 0; i < x_k.size(); i++)
+        for (unsigned int i = 0; i < k; i++)
         {
-            x_k[i]->m_mean /= x_k[i]->m_size; // calculate the mean
+            Eigen::VectorXd mean = sums.col(i) / sizes[i]; // calculate the mean
 
             // check if the centroid changed position
-            if(x_k[i]->m_centroid != x_k[i]->m_mean)
+            if (centroids.col(i) != mean)
             {
                 convergence = false;
-                x_k[i]->m_centroid = x_k[i]->m_mean; // assign this as the new centroid
+                centroids.col(i) = mean; // assign this as the new centroid
             } // else the centroid of this cluster did not change
         } // if the centroid of none of the clusters has changed then convergence remains true
     } // convergence: true --> clustering algorithm has found a local minimum for the centroid positions
+} // k_means_lloyd()
+
+std::vector<std::shared_ptr<Cluster> > k_means(const K_Means_Data& data, std::shared_ptr<std::vector<data_point> > x, unsigned int k,
+                                               dist_function d_func, std::mt19937& rand_num_engine, unsigned int n_threads = 0,
+                                               double max_variance = std::numeric_limits<double>::infinity())
+{ // k-means on the data set 'data', which has been made from 'x', n_threads = 0 uses as many threads as the hardware supports
+  // the clustering is abandoned (an empty vector is returned) if the sum of the variances of the clusters exceeds max_variance
+    const Eigen::MatrixXd& points = data.m_points;
+    unsigned int n_points = points.cols();
+
+    if (k > n_points)
+    {
+        std::cout << "Error in k-means clustering (Clustering.hpp) number of clusters is larger than " << std::endl
+                  << "the number of data points in the given data set, exiting now..." << std::endl;
+        exit(1);
+    }
+
+    Eigen::MatrixXd centroids(points.rows(), k);
+    k_means_plus_plus(points, centroids, rand_num_engine);
+
+    std::vector<unsigned int> assignment; // index of the cluster to which each data point belongs
+    std::vector<unsigned int> sizes;
+    k_means_lloyd(points, centroids, assignment, sizes, n_threads);
+
+    // calculate the variances of the clusters, the squared distances in 'points' are the squared distances of d_func
+    // each data point adds its squared distance divided by the size of its cluster to the sum of the variances,
+    // so the clustering can be abandoned as soon as the partial sum exceeds max_variance
+    std::vector<double> variances(k, 0.0);
+    double sum_variances = 0;
+    for (unsigned int i = 0; i < n_points; i++)
+    {
+        double variance = (points.col(i) - centroids.col(assignment[i])).squaredNorm() / (double)sizes[assignment[i]];
+        variances[assignment[i]] += variance;
+        sum_variances += variance;
+        if (sum_variances > max_variance)
+        {
+            return std::vector<std::shared_ptr<Cluster> >();
+        }
+    }
+
+    // make the clusters
+    std::vector<std::shared_ptr<Cluster> > x_k; // will contain all clusters
+    data_point origin = data_point::Zero(points.rows());
+    for (unsigned int i = 0; i < k; i++)
+    {
+        data_point centroid = data.m_offset + data.m_range.cwiseProduct(centroids.col(i));
+        x_k.push_back(std::make_shared<Cluster>(centroid, std::weak_ptr<std::vector<data_point> >(x)));
+        x_k[i]->m_mean = centroid;
+        x_k[i]->m_size = sizes[i];
+        x_k[i]->m_d_func = d_func; // stores what dist-function was use to create this cluster
+        x_k[i]->m_variance = variances[i];
+        x_k[i]->m_dist_from_origin = d_func.calc(origin, centroid);
+    }
+    for (unsigned int i = 0; i < n_points; i++)
+    {
+        x_k[assignment[i]]->m_bit_mask[i] = true;
+    }
 
-    // calculate variances
-    calc_variances(x_k, d_func);
     return x_k; // return the found cluster
+} // k_means()
+
+std::vector<std::shared_ptr<Cluster> > k_means(std::shared_ptr<std::vector<data_point> > x, unsigned int k, dist_function d_func)
+{
+    if (k > x->size())
+    {
+        std::cout << "Error in k-means clustering (Clustering.hpp) number of clusters is larger than " << std::endl
+                  << "the number of data points in the given data set, exiting now..." << std::endl;
+        exit(1);
+    }
+    K_Means_Data data(*x, d_func);
+	std::mt19937 rand_num_engine;
+	rand_num_engine.seed(std::random_device()());
+    return k_means(data, x, k, d_func, rand_num_engine);
 } // end of k_means()
 
-std::vector<std::shared_ptr<Cluster> > clustering(std::shared_ptr<std::vector<data_point> > x, unsigned int runs, unsigned int k_min, unsigned int k_max, int dist_switch)
+std::vector<std::shared_ptr<Cluster> > clustering(std::shared_ptr<std::vector<data_point> > x, unsigned int runs, unsigned int k_min, unsigned int k_max, int dist_switch,
+                                                  unsigned int n_threads = 0, unsigned int seed = std::random_device()())
 { // this function tries to find the best clustering for the data set x, using a specified number of runs, and  using between k_min and k_max clusters
+  // the runs for all cluster sizes are divided over n_threads threads (0 uses as many threads as the hardware supports), each run has its
+  // own random number generator seeded with 'seed', the cluster size and the run, so the result for a given seed does not depend on n_threads
 
     if (k_min <= 1)
     {
@@ -293,36 +428,83 @@ std::vector<std::shared_ptr<Cluster> > clustering(std::shared_ptr<std::vector<da
     }
 
     std::map<unsigned int, double> cluster_variances;
+    K_Means_Data data(*x, d_func); // the data set is prepared once for all runs of the k_means algorithm
+
+    // each task is one run of the k_means algorithm for one cluster size, from k_min-1 up to k_max+1
+    runs = std::max(1u, runs);
+    unsigned int n_sizes = k_max - k_min + 3;
+    unsigned int n_tasks = n_sizes*runs;
+    std::vector<std::vector<std::shared_ptr<Cluster> > > task_results(n_tasks); // empty if the run has been abandoned
+    std::vector<double> task_variances(n_tasks, std::numeric_limits<double>::infinity());
+    std::vector<double> min_variances(n_sizes, std::numeric_limits<double>::infinity()); // the smallest variance found so far for each cluster size
+    std::mutex variance_mutex;
+    std::atomic<unsigned int> next_task(0);
+
+    auto run_tasks = [&]()
+    {
+        for (unsigned int t = next_task++; t < n_tasks; t = next_task++)
+        {
+            unsigned int size_index = t / runs;
+            unsigned int k = k_min - 1 + size_index;
+            std::seed_seq seeds = {seed, k, t % runs};
+            std::mt19937 rand_num_engine(seeds);
 
-    for (unsigned int i = k_min-1; i <= k_max+1; i++)
-    { // for each cluster size and 1 less and 1 more cluster
-        double min_variance = 0; // to keep track of which cluster contains the minimal variance
-        clustered_data_sets[i] = k_means(x, i, d_func);
-
-        for (unsigned int j = 1; j < runs; j++)
-        { // run the k_means algorithm 'runs' times
-
-            std::vector<std::shared_ptr<Cluster> > temp_clustered_data_set; // will contain the clusters for each cluster size
-            temp_clustered_data_set = k_means(x, i, d_func); // run the k_means algorithm and add it to the temporary set of clusters
-            double variance = 0;
-
-            for (unsigned int k = 0; k < i; k++)
+            double max_variance;
             {
-                variance += temp_clustered_data_set[k]->m_variance;
+                std::lock_guard<std::mutex> lock(variance_mutex);
+                max_variance = min_variances[size_index];
             }
+            // a run that is worse than the best run so far is abandoned, this does not change which run is the best one,
+            // the margin keeps runs with the same variance (up to round off) as the best run, of which the first is selected
+            max_variance *= 1.0 + 1.0e-9;
+            task_results[t] = k_means(data, x, k, d_func, rand_num_engine, 1, max_variance);
+            if (task_results[t].empty()) continue;
 
-            if (min_variance == 0)
+            double variance = 0;
+            for (unsigned int i = 0; i < k; i++)
             {
-                clustered_data_sets[i] = temp_clustered_data_set;
-                min_variance = variance;
+                variance += task_results[t][i]->m_variance;
             }
-            else if (min_variance > variance)
+            task_variances[t] = variance;
+
+            std::lock_guard<std::mutex> lock(variance_mutex);
+            min_variances[size_index] = std::min(min_variances[size_index], variance);
+        }
+    };
+
+    if (n_threads == 0)
+    {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    n_threads = std::min(n_threads, n_tasks);
+    if (n_threads <= 1)
+    {
+        run_tasks();
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        for (unsigned int i = 0; i < n_threads; i++)
+        {
+            workers.push_back(std::thread(run_tasks));
+        }
+        for (unsigned int i = 0; i < n_threads; i++)
+        {
+            workers[i].join();
+        }
+    }
+
+    for (unsigned int i = 0; i < n_sizes; i++)
+    { // for each cluster size select the run with the smallest variance (the first of equal runs)
+        unsigned int best_run = i*runs;
+        for (unsigned int j = i*runs + 1; j < (i+1)*runs; j++)
+        {
+            if (task_variances[j] < task_variances[best_run])
             {
-                clustered_data_sets[i] = temp_clustered_data_set;
-                min_variance = variance;
+                best_run = j;
             }
         }
-
+        clustered_data_sets[k_min - 1 + i] = task_results[best_run];
     }
 
     // select the cluster for which the second derivative of the variances is largest (largest curvature equals maximum effect loss of clustering algorithm)
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <Eigen/Dense>
 #include <map>
+#include <vector>
 
 namespace BSO{
 // this file contains data types and functions that are intended for handling and processing data
@@ -0,0 +1,473 @@
+#ifndef EVALUATION_CACHE_HPP
+#define EVALUATION_CACHE_HPP
+
+#include <BSO/Spatial_Design/Movable_Sizable.hpp>
+
+#ifdef SD_ANALYSIS_HPP
+#include <BSO/Structural_Design/SD_Results.hpp>
+#endif
+
+#ifdef BP_SIMULATION_HPP
+#include <BSO/Building_Physics/BP_Results.hpp>
+#endif
+
+#include <BSO/Snapshot.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace BSO
+{
+
+    /*
+     * Evaluation_Cache stores the results of structural and building physics evaluations
+     * by the design that was evaluated, so that a design that is encountered again (e.g.
+     * in a heuristic optimisation loop) costs a lookup instead of an analysis. A design is
+     * identified by its spaces, sorted by ID, by an identifier of the grammar that turns it
+     * into the SD and BP models (given by the caller, the grammar itself is a function) and
+     * by the contents of the settings files that were used in the evaluation. Results are
+     * kept in memory and, if a store directory is given, in one snapshot file per design and
+     * discipline in that directory, so that they can be reused by later runs. The directory
+     * must exist. A file in the store that cannot be read (e.g. of another snapshot version,
+     * or left incomplete by a run that was stopped) counts as a miss, and each file is written
+     * under a temporary name first and then renamed, so that it is either complete or absent.
+     *
+     * Only the building and space results are stored: the component and element results
+     * refer to the finite element model, which does not exist for a design that is looked up.
+     * Results that are looked up are therefore marked as partial (m_partial), and the indexing
+     * functions that need the element results refuse them.
+     * As in Performance_Indexing.hpp, the functions for each discipline are only available if
+     * the analysis of that discipline has been included before this file.
+     */
+
+    // FNV-1a hash of a string of bytes, seed may be the hash of preceding bytes
+    uint64_t fnv_1a_hash(const std::string& bytes, uint64_t seed = 14695981039346656037ULL)
+    {
+        uint64_t hash = seed;
+        for (unsigned int i = 0; i < bytes.size(); i++)
+        {
+            hash ^= (unsigned char)bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    } // fnv_1a_hash()
+
+    std::string canonical_design(Spatial_Design::MS_Building& MS)
+    { // describes the spaces of a design, ordered by ID, one space per line and all values at full precision
+        std::vector<Spatial_Design::MS_Space> spaces;
+        for (int i = 0; i < MS.obtain_space_count(); i++)
+        {
+            spaces.push_back(MS.obtain_space(i));
+        }
+        std::sort(spaces.begin(), spaces.end(), [](const Spatial_Design::MS_Space& a, const Spatial_Design::MS_Space& b)
+                  { return a.ID < b.ID; });
+
+        std::ostringstream design;
+        design << std::setprecision(17);
+        for (unsigned int i = 0; i < spaces.size(); i++)
+        {
+            design << spaces[i].ID << " " << spaces[i].width << " " << spaces[i].depth << " " << spaces[i].height << " "
+                   << spaces[i].x << " " << spaces[i].y << " " << spaces[i].z;
+            if (spaces[i].space_type_given)
+            {
+                design << " " << spaces[i].m_space_type;
+            }
+            if (spaces[i].surfaces_given)
+            {
+                for (int j = 0; j < 6; j++)
+                {
+                    design << " " << spaces[i].surface_type[j];
+                }
+            }
+            design << "\n";
+        }
+        return design.str();
+    } // canonical_design()
+
+    class Evaluation_Cache
+    {
+    private:
+        struct Cache_Entry
+        {
+            std::string m_design; // the canonical design, to tell designs apart of which the hashes are equal
+            bool m_sd_given, m_bp_given;
+            #ifdef SD_ANALYSIS_HPP
+            Structural_Design::SD_Building_Results m_sd_results;
+            #endif
+            #ifdef BP_SIMULATION_HPP
+            Building_Physics::BP_Building_Results m_bp_results;
+            #endif
+        };
+
+        std::string m_store; // directory of the on-disk store, empty if results are only kept in memory
+        uint64_t m_settings_hash;
+        std::map<uint64_t, Cache_Entry> m_entries;
+
+        unsigned long m_sd_hits, m_sd_misses, m_bp_hits, m_bp_misses, m_store_hits;
+
+        Cache_Entry& entry(uint64_t hash, const std::string& design);
+        std::string store_file(uint64_t hash, const char* discipline);
+        void replace_store_file(const std::string& temp_file, const std::string& file_name);
+        #ifdef SD_ANALYSIS_HPP
+        bool read_sd(uint64_t hash, const std::string& design, Structural_Design::SD_Building_Results& results);
+        #endif
+        #ifdef BP_SIMULATION_HPP
+        bool read_bp(uint64_t hash, const std::string& design, Building_Physics::BP_Building_Results& results);
+        #endif
+    public:
+        Evaluation_Cache(std::string grammar_ID, std::vector<std::string> settings_files, std::string store = "");
+
+        #ifdef SD_ANALYSIS_HPP
+        bool find_sd_results(Spatial_Design::MS_Building&, Structural_Design::SD_Building_Results&);
+        void store_sd_results(Spatial_Design::MS_Building&, const Structural_Design::SD_Building_Results&);
+        #endif
+        #ifdef BP_SIMULATION_HPP
+        bool find_bp_results(Spatial_Design::MS_Building&, Building_Physics::BP_Building_Results&);
+        void store_bp_results(Spatial_Design::MS_Building&, const Building_Physics::BP_Building_Results&);
+        #endif
+
+        unsigned long get_sd_hits() {return m_sd_hits;}
+        unsigned long get_sd_misses() {return m_sd_misses;}
+        unsigned long get_bp_hits() {return m_bp_hits;}
+        unsigned long get_bp_misses() {return m_bp_misses;}
+        unsigned long get_store_hits() {return m_store_hits;} // hits that were read from the on-disk store
+        void write_statistics(std::ostream& output);
+    }; // Evaluation_Cache
+
+
+    // Functions to write and read the value parts of the results to and from a snapshot:
+
+    void write_snapshot_map(Snapshot_Writer& snapshot, const std::map<unsigned int, double>& values)
+    {
+        snapshot.write((uint32_t)values.size());
+        for (auto ite = values.begin(); ite != values.end(); ite++)
+        {
+            snapshot.write(ite->first);
+            snapshot.write(ite->second);
+        }
+    } // write_snapshot_map()
+
+    void write_snapshot_map(Snapshot_Writer& snapshot, const std::map<std::string, double>& values)
+    {
+        snapshot.write((uint32_t)values.size());
+        for (auto ite = values.begin(); ite != values.end(); ite++)
+        {
+            snapshot.write_string(ite->first);
+            snapshot.write(ite->second);
+        }
+    } // write_snapshot_map()
+
+    void read_snapshot_map(Snapshot_Reader& snapshot, std::map<unsigned int, double>& values)
+    {
+        values.clear();
+        uint32_t n = snapshot.read_count(sizeof(unsigned int) + sizeof(double));
+        for (uint32_t i = 0; i < n; i++)
+        {
+            unsigned int key = snapshot.read<unsigned int>();
+            values[key] = snapshot.read<double>();
+        }
+    } // read_snapshot_map()
+
+    void read_snapshot_map(Snapshot_Reader& snapshot, std::map<std::string, double>& values)
+    {
+        values.clear();
+        uint32_t n = snapshot.read_count(sizeof(uint32_t) + sizeof(double));
+        for (uint32_t i = 0; i < n; i++)
+        {
+            std::string key = snapshot.read_string();
+            values[key] = snapshot.read<double>();
+        }
+    } // read_snapshot_map()
+
+    #ifdef SD_ANALYSIS_HPP
+    void copy_sd_values(const Structural_Design::SD_Building_Results& from, Structural_Design::SD_Building_Results& to)
+    { // copies the building and space results, but not the components and elements
+        to.m_partial = true;
+        to.m_components.clear();
+        to.m_ghost_components.clear();
+        to.m_spaces = from.m_spaces;
+        for (unsigned int i = 0; i < to.m_spaces.size(); i++)
+        {
+            to.m_spaces[i].m_components.clear();
+        }
+        to.m_element_clusters = from.m_element_clusters;
+        to.m_total_compliance = from.m_total_compliance;
+        to.m_total_ghost_compliance = from.m_total_ghost_compliance;
+        to.m_struct_volume = from.m_struct_volume;
+        to.m_struct_ghost_volume = from.m_struct_ghost_volume;
+        to.m_compliances = from.m_compliances;
+    } // copy_sd_values()
+    #endif
+
+
+    // Implementation of member functions:
+
+    Evaluation_Cache::Evaluation_Cache(std::string grammar_ID, std::vector<std::string> settings_files, std::string store)
+    { // grammar_ID tells the grammars apart that are used with the same store, e.g. the name of the grammar function
+        m_store = store;
+        m_sd_hits = m_sd_misses = m_bp_hits = m_bp_misses = m_store_hits = 0;
+
+        m_settings_hash = fnv_1a_hash("grammar\0" + grammar_ID + '\0');
+        for (unsigned int i = 0; i < settings_files.size(); i++)
+        {
+            std::ifstream input(settings_files[i].c_str(), std::ios::binary);
+            if (!input.is_open())
+            {
+                std::cerr << "Error, could not open settings file \"" << settings_files[i] << "\", exiting now... (Evaluation_Cache.hpp)" << std::endl;
+                exit(1);
+            }
+            std::ostringstream contents;
+            contents << input.rdbuf();
+            m_settings_hash = fnv_1a_hash(settings_files[i] + '\0' + contents.str() + '\0', m_settings_hash);
+        }
+    } // ctor
+
+    Evaluation_Cache::Cache_Entry& Evaluation_Cache::entry(uint64_t hash, const std::string& design)
+    {
+        Cache_Entry& entry = m_entries[hash];
+        if (entry.m_design != design)
+        { // a new design, or (very unlikely) another design with the same hash, which replaces it
+            entry.m_design = design;
+            entry.m_sd_given = false;
+            entry.m_bp_given = false;
+        }
+        return entry;
+    } // entry()
+
+    std::string Evaluation_Cache::store_file(uint64_t hash, const char* discipline)
+    {
+        std::ostringstream file_name;
+        file_name << m_store << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << "_" << discipline << ".bso";
+        return file_name.str();
+    } // store_file()
+
+    void Evaluation_Cache::replace_store_file(const std::string& temp_file, const std::string& file_name)
+    { // moves a completely written file into place, rename() replaces an existing file at once where the system allows it
+        if (std::rename(temp_file.c_str(), file_name.c_str()) != 0)
+        {
+            std::remove(file_name.c_str());
+            if (std::rename(temp_file.c_str(), file_name.c_str()) != 0)
+            {
+                std::cerr << "Error, could not move \"" << temp_file << "\" to \"" << file_name << "\", exiting now... (Evaluation_Cache.hpp)" << std::endl;
+                exit(1);
+            }
+        }
+    } // replace_store_file()
+
+    #ifdef SD_ANALYSIS_HPP
+    bool Evaluation_Cache::read_sd(uint64_t hash, const std::string& design, Structural_Design::SD_Building_Results& results)
+    {
+        if (m_store.empty()) return false;
+        Snapshot_Reader snapshot(store_file(hash, "sd"), false); // a file that is missing or cannot be read is a miss
+        snapshot.expect_tag("ECSD");
+        if (snapshot.read<uint64_t>() != m_settings_hash || snapshot.read_string() != design) return false;
+
+        results.m_partial = true;
+        results.m_components.clear();
+        results.m_ghost_components.clear();
+        results.m_spaces.resize(snapshot.read_count(1));
+        for (unsigned int i = 0; i < results.m_spaces.size(); i++)
+        {
+            Structural_Design::SD_Space_Results& space = results.m_spaces[i];
+            space.m_ID = snapshot.read<int>();
+            space.m_deletion_count = snapshot.read<unsigned int>();
+            space.m_floor_area = snapshot.read<double>();
+            space.m_volume = snapshot.read<double>();
+            space.m_struct_volume = snapshot.read<double>();
+            space.m_total_compliance = snapshot.read<double>();
+            space.m_invert_compliance = snapshot.read<double>();
+            read_snapshot_map(snapshot, space.m_compliances);
+            space.m_rel_performance = snapshot.read<double>();
+            space.m_components.clear();
+        }
+        results.m_element_clusters = snapshot.read_vector<double>();
+        results.m_total_compliance = snapshot.read<double>();
+        results.m_total_ghost_compliance = snapshot.read<double>();
+        results.m_struct_volume = snapshot.read<double>();
+        results.m_struct_ghost_volume = snapshot.read<double>();
+        read_snapshot_map(snapshot, results.m_compliances);
+        return snapshot.at_end();
+    } // read_sd()
+
+    bool Evaluation_Cache::find_sd_results(Spatial_Design::MS_Building& MS, Structural_Design::SD_Building_Results& results)
+    { // returns true and copies the results into 'results' if the design has been analysed before
+        std::string design = canonical_design(MS);
+        uint64_t hash = fnv_1a_hash(design, m_settings_hash);
+
+        auto ite = m_entries.find(hash);
+        if (ite != m_entries.end() && ite->second.m_sd_given && ite->second.m_design == design)
+        {
+            copy_sd_values(ite->second.m_sd_results, results);
+            m_sd_hits++;
+            return true;
+        }
+
+        Structural_Design::SD_Building_Results stored;
+        if (read_sd(hash, design, stored))
+        {
+            Cache_Entry& found = entry(hash, design);
+            copy_sd_values(stored, found.m_sd_results);
+            found.m_sd_given = true;
+            copy_sd_values(stored, results);
+            m_sd_hits++;
+            m_store_hits++;
+            return true;
+        }
+
+        m_sd_misses++;
+        return false;
+    } // find_sd_results()
+
+    void Evaluation_Cache::store_sd_results(Spatial_Design::MS_Building& MS, const Structural_Design::SD_Building_Results& results)
+    {
+        std::string design = canonical_design(MS);
+        uint64_t hash = fnv_1a_hash(design, m_settings_hash);
+
+        Cache_Entry& stored = entry(hash, design);
+        copy_sd_values(results, stored.m_sd_results);
+        stored.m_sd_given = true;
+
+        if (m_store.empty()) return;
+        std::string file_name = store_file(hash, "sd");
+        Snapshot_Writer snapshot(file_name + ".tmp");
+        snapshot.write_tag("ECSD");
+        snapshot.write(m_settings_hash);
+        snapshot.write_string(design);
+        snapshot.write((uint32_t)results.m_spaces.size());
+        for (unsigned int i = 0; i < results.m_spaces.size(); i++)
+        {
+            const Structural_Design::SD_Space_Results& space = results.m_spaces[i];
+            snapshot.write(space.m_ID);
+            snapshot.write(space.m_deletion_count);
+            snapshot.write(space.m_floor_area);
+            snapshot.write(space.m_volume);
+            snapshot.write(space.m_struct_volume);
+            snapshot.write(space.m_total_compliance);
+            snapshot.write(space.m_invert_compliance);
+            write_snapshot_map(snapshot, space.m_compliances);
+            snapshot.write(space.m_rel_performance);
+        }
+        snapshot.write_vector(results.m_element_clusters);
+        snapshot.write(results.m_total_compliance);
+        snapshot.write(results.m_total_ghost_compliance);
+        snapshot.write(results.m_struct_volume);
+        snapshot.write(results.m_struct_ghost_volume);
+        write_snapshot_map(snapshot, results.m_compliances);
+        snapshot.close();
+        replace_store_file(file_name + ".tmp", file_name);
+    } // store_sd_results()
+    #endif
+
+    #ifdef BP_SIMULATION_HPP
+    bool Evaluation_Cache::read_bp(uint64_t hash, const std::string& design, Building_Physics::BP_Building_Results& results)
+    {
+        if (m_store.empty()) return false;
+        Snapshot_Reader snapshot(store_file(hash, "bp"), false); // a file that is missing or cannot be read is a miss
+        snapshot.expect_tag("ECBP");
+        if (snapshot.read<uint64_t>() != m_settings_hash || snapshot.read_string() != design) return false;
+
+        results.m_space_results.resize(snapshot.read_count(1));
+        for (unsigned int i = 0; i < results.m_space_results.size(); i++)
+        {
+            Building_Physics::BP_Space_Results& space = results.m_space_results[i];
+            space.m_space_ID = snapshot.read_string();
+            space.m_floor_area = snapshot.read<double>();
+            space.m_space_volume = snapshot.read<double>();
+            read_snapshot_map(snapshot, space.m_heating_energy);
+            read_snapshot_map(snapshot, space.m_cooling_energy);
+            space.m_total_heating_energy = snapshot.read<double>();
+            space.m_total_cooling_energy = snapshot.read<double>();
+            space.m_total_energy = snapshot.read<double>();
+            space.m_rel_performance = snapshot.read<double>();
+        }
+        results.m_total_heating_energy = snapshot.read<double>();
+        results.m_total_cooling_energy = snapshot.read<double>();
+        results.m_total_energy = snapshot.read<double>();
+        return snapshot.at_end();
+    } // read_bp()
+
+    bool Evaluation_Cache::find_bp_results(Spatial_Design::MS_Building& MS, Building_Physics::BP_Building_Results& results)
+    { // returns true and copies the results into 'results' if the design has been simulated before
+        std::string design = canonical_design(MS);
+        uint64_t hash = fnv_1a_hash(design, m_settings_hash);
+
+        auto ite = m_entries.find(hash);
+        if (ite != m_entries.end() && ite->second.m_bp_given && ite->second.m_design == design)
+        {
+            results = ite->second.m_bp_results;
+            m_bp_hits++;
+            return true;
+        }
+
+        Building_Physics::BP_Building_Results stored;
+        if (read_bp(hash, design, stored))
+        {
+            results = stored;
+            Cache_Entry& found = entry(hash, design);
+            found.m_bp_results = results;
+            found.m_bp_given = true;
+            m_bp_hits++;
+            m_store_hits++;
+            return true;
+        }
+
+        m_bp_misses++;
+        return false;
+    } // find_bp_results()
+
+    void Evaluation_Cache::store_bp_results(Spatial_Design::MS_Building& MS, const Building_Physics::BP_Building_Results& results)
+    {
+        std::string design = canonical_design(MS);
+        uint64_t hash = fnv_1a_hash(design, m_settings_hash);
+
+        Cache_Entry& stored = entry(hash, design);
+        stored.m_bp_results = results;
+        stored.m_bp_given = true;
+
+        if (m_store.empty()) return;
+        std::string file_name = store_file(hash, "bp");
+        Snapshot_Writer snapshot(file_name + ".tmp");
+        snapshot.write_tag("ECBP");
+        snapshot.write(m_settings_hash);
+        snapshot.write_string(design);
+        snapshot.write((uint32_t)results.m_space_results.size());
+        for (unsigned int i = 0; i < results.m_space_results.size(); i++)
+        {
+            const Building_Physics::BP_Space_Results& space = results.m_space_results[i];
+            snapshot.write_string(space.m_space_ID);
+            snapshot.write(space.m_floor_area);
+            snapshot.write(space.m_space_volume);
+            write_snapshot_map(snapshot, space.m_heating_energy);
+            write_snapshot_map(snapshot, space.m_cooling_energy);
+            snapshot.write(space.m_total_heating_energy);
+            snapshot.write(space.m_total_cooling_energy);
+            snapshot.write(space.m_total_energy);
+            snapshot.write(space.m_rel_performance);
+        }
+        snapshot.write(results.m_total_heating_energy);
+        snapshot.write(results.m_total_cooling_energy);
+        snapshot.write(results.m_total_energy);
+        snapshot.close();
+        replace_store_file(file_name + ".tmp", file_name);
+    } // store_bp_results()
+    #endif
+
+    void Evaluation_Cache::write_statistics(std::ostream& output)
+    {
+        output << "Evaluation cache: " << m_entries.size() << " designs, SD " << m_sd_hits << " hits " << m_sd_misses
+               << " misses, BP " << m_bp_hits << " hits " << m_bp_misses << " misses, "
+               << m_store_hits << " hits read from the store" << std::endl;
+    } // write_statistics()
+
+} // namespace BSO
+
+#endif // EVALUATION_CACHE_HPP
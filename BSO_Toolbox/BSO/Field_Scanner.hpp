@@ -0,0 +1,395 @@
+#ifndef FIELD_SCANNER_HPP
+#define FIELD_SCANNER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <cctype>
+#include <algorithm>
+
+namespace BSO
+{
+
+    /*
+     * Field_Scanner reads a text file in one block and splits it into lines and
+     * the lines into fields, without copying: each field is a trimmed range in the
+     * buffer of the file. Numbers are parsed directly from these ranges, a field
+     * that is not a valid number is reported with its line and column, after which
+     * the program exits.
+     *
+     * Like boost::char_separator, empty fields are skipped unless keep_empty_fields
+     * is set (e.g. for the missing values in KNMI weather files). The source is
+     * either a file or (scanner_source::TEXT) the text itself.
+     */
+
+    enum class scanner_source{FILE, TEXT};
+
+    // Function declarations (from_chars-style: parse [first, last) completely, returns false if that is not possible)
+
+    bool parse_number(const char* first, const char* last, long& value);
+    bool parse_number(const char* first, const char* last, unsigned long& value);
+    bool parse_number(const char* first, const char* last, double& value);
+
+    // Class definition
+
+    class Field_Scanner
+    {
+    private:
+        std::string m_file_name;
+        std::string m_buffer; // the contents of the file
+        bool m_is_open;
+        std::string m_separators;
+        bool m_keep_empty_fields;
+
+        const char* m_next; // the start of the next line
+        const char* m_line_begin;
+        const char* m_line_first; // the current line without white space at its ends
+        const char* m_line_last;
+        unsigned int m_line_number;
+        std::vector<std::pair<const char*, const char*> > m_fields; // the trimmed fields of the current line
+
+        void check_field(unsigned int i) const;
+        void field_error(unsigned int i, const std::string& expected) const;
+    public:
+        Field_Scanner(const std::string& source, const std::string& separators = ",", bool keep_empty_fields = false, scanner_source source_type = scanner_source::FILE);
+        Field_Scanner(const Field_Scanner&) = delete; // the fields point into the buffer
+        Field_Scanner& operator=(const Field_Scanner&) = delete;
+
+        bool is_open() const;
+        const std::string& get_file_name() const;
+
+        bool next_line(); // moves to the next line that is not empty, returns false at the end of the file
+        void skip_lines(unsigned int n); // skips n lines, whatever they contain
+        unsigned int line_number() const; // the current line, starting at 1
+        std::size_t line_offset() const; // the position of the current line in the source
+        void seek_line(std::size_t offset); // the next line starts at offset (e.g. a line_offset() of an earlier line)
+        std::string get_line() const; // the current line without white space at its ends
+
+        unsigned int field_count() const;
+        bool field_is(unsigned int i, const char* s) const; // whether field i is equal to s
+        bool field_is_empty(unsigned int i) const;
+
+        std::string get_string(unsigned int i) const;
+        char get_char(unsigned int i) const;
+        int get_int(unsigned int i) const;
+        unsigned int get_uint(unsigned int i) const;
+        unsigned long get_ulong(unsigned int i) const;
+        double get_double(unsigned int i) const;
+    }; // Field_Scanner
+
+
+    //Function implementations:
+
+    bool parse_number(const char* first, const char* last, long& value)
+    {
+        const char* p = first;
+        bool negative = false;
+        if (p != last && (*p == '-' || *p == '+'))
+        {
+            negative = (*p == '-');
+            p++;
+        }
+        if (p == last)
+        {
+            return false;
+        }
+        unsigned long magnitude = 0, limit = (negative) ? (unsigned long)LONG_MAX + 1 : (unsigned long)LONG_MAX;
+        for (; p != last; p++)
+        {
+            if (*p < '0' || *p > '9')
+            {
+                return false;
+            }
+            unsigned int digit = *p - '0';
+            if (magnitude > (limit - digit) / 10)
+            {
+                return false; // out of range
+            }
+            magnitude = magnitude*10 + digit;
+        }
+        value = (negative) ? (long)(0 - magnitude) : (long)magnitude;
+        return true;
+    } // parse_number()
+
+    bool parse_number(const char* first, const char* last, unsigned long& value)
+    {
+        const char* p = first;
+        if (p != last && *p == '+')
+        {
+            p++;
+        }
+        if (p == last)
+        {
+            return false;
+        }
+        unsigned long magnitude = 0;
+        for (; p != last; p++)
+        {
+            if (*p < '0' || *p > '9')
+            {
+                return false;
+            }
+            unsigned int digit = *p - '0';
+            if (magnitude > (ULONG_MAX - digit) / 10)
+            {
+                return false; // out of range
+            }
+            magnitude = magnitude*10 + digit;
+        }
+        value = magnitude;
+        return true;
+    } // parse_number()
+
+    bool parse_number(const char* first, const char* last, double& value)
+    { // strtod needs a terminated string, the fields are short so they are copied to the stack
+        char digits[64];
+        std::size_t length = last - first;
+        if (length == 0 || length >= sizeof(digits) || *first == ' ' || *first == '\t')
+        {
+            return false;
+        }
+        std::memcpy(digits, first, length);
+        digits[length] = '\0';
+        char* end;
+        errno = 0;
+        value = std::strtod(digits, &end);
+        return (end == digits + length && errno != ERANGE);
+    } // parse_number()
+
+    Field_Scanner::Field_Scanner(const std::string& source, const std::string& separators, bool keep_empty_fields, scanner_source source_type)
+    {
+        m_separators = separators;
+        m_keep_empty_fields = keep_empty_fields;
+        m_line_number = 0;
+
+        if (source_type == scanner_source::TEXT)
+        {
+            m_file_name = "<text>";
+            m_buffer = source;
+            m_is_open = true;
+        }
+        else
+        {
+            m_file_name = source;
+            std::ifstream input(source.c_str(), std::ios::binary);
+            m_is_open = input.is_open();
+            if (m_is_open)
+            { // read the file in one block
+                input.seekg(0, std::ios::end);
+                m_buffer.resize((std::size_t)input.tellg());
+                input.seekg(0, std::ios::beg);
+                input.read(&m_buffer[0], m_buffer.size());
+            }
+        }
+        m_next = m_buffer.data();
+        m_line_begin = m_next;
+        m_line_first = m_next;
+        m_line_last = m_next;
+    } // ctor
+
+    bool Field_Scanner::is_open() const
+    {
+        return m_is_open;
+    } // is_open()
+
+    const std::string& Field_Scanner::get_file_name() const
+    {
+        return m_file_name;
+    } // get_file_name()
+
+    bool Field_Scanner::next_line()
+    {
+        const char* buffer_end = m_buffer.data() + m_buffer.size();
+        while (m_next < buffer_end)
+        {
+            m_line_begin = m_next;
+            const char* line_end = static_cast<const char*>(std::memchr(m_next, '\n', buffer_end - m_next));
+            if (line_end == nullptr)
+            {
+                line_end = buffer_end;
+            }
+            m_next = (line_end == buffer_end) ? buffer_end : line_end + 1;
+            m_line_number++;
+
+            // trim the line, so that white space at its ends does not make up a field
+            const char* first = m_line_begin;
+            const char* last = line_end;
+            while (first != last && std::isspace((unsigned char)*first)) first++;
+            while (last != first && std::isspace((unsigned char)*(last - 1))) last--;
+            if (first == last)
+            {
+                continue; // skip empty lines
+            }
+
+            m_line_first = first;
+            m_line_last = last;
+            m_fields.clear();
+            const char* field_begin = first;
+            for (const char* p = first; ; p++)
+            {
+                bool at_end = (p == last);
+                if (!at_end && std::memchr(m_separators.data(), *p, m_separators.size()) == nullptr)
+                {
+                    continue;
+                }
+                if (p != field_begin || m_keep_empty_fields)
+                { // like boost::char_separator, fields without any characters are skipped (fields with only white space are not)
+                    const char* field_first = field_begin;
+                    const char* field_last = p;
+                    while (field_first != field_last && std::isspace((unsigned char)*field_first)) field_first++; // trim the field
+                    while (field_last != field_first && std::isspace((unsigned char)*(field_last - 1))) field_last--;
+                    m_fields.push_back(std::make_pair(field_first, field_last));
+                }
+                if (at_end)
+                {
+                    break;
+                }
+                field_begin = p + 1;
+            }
+            return true;
+        }
+        m_fields.clear();
+        return false;
+    } // next_line()
+
+    void Field_Scanner::skip_lines(unsigned int n)
+    {
+        const char* buffer_end = m_buffer.data() + m_buffer.size();
+        for (unsigned int i = 0; i < n && m_next < buffer_end; i++)
+        {
+            const char* line_end = static_cast<const char*>(std::memchr(m_next, '\n', buffer_end - m_next));
+            m_next = (line_end == nullptr) ? buffer_end : line_end + 1;
+            m_line_number++;
+        }
+        m_fields.clear();
+    } // skip_lines()
+
+    unsigned int Field_Scanner::line_number() const
+    {
+        return m_line_number;
+    } // line_number()
+
+    std::size_t Field_Scanner::line_offset() const
+    {
+        return m_line_begin - m_buffer.data();
+    } // line_offset()
+
+    void Field_Scanner::seek_line(std::size_t offset)
+    {
+        m_next = m_buffer.data() + std::min(offset, m_buffer.size());
+        m_fields.clear();
+    } // seek_line()
+
+    std::string Field_Scanner::get_line() const
+    {
+        return std::string(m_line_first, m_line_last);
+    } // get_line()
+
+    unsigned int Field_Scanner::field_count() const
+    {
+        return m_fields.size();
+    } // field_count()
+
+    void Field_Scanner::check_field(unsigned int i) const
+    {
+        if (i >= m_fields.size())
+        {
+            std::cerr << "Error in file \"" << m_file_name << "\", line " << m_line_number << ": expected at least "
+                      << i + 1 << " fields but found " << m_fields.size() << ", exiting now..." << std::endl;
+            exit(1);
+        }
+    } // check_field()
+
+    void Field_Scanner::field_error(unsigned int i, const std::string& expected) const
+    {
+        std::cerr << "Error in file \"" << m_file_name << "\", line " << m_line_number << ", column "
+                  << (m_fields[i].first - m_line_begin) + 1 << ": expected " << expected << " but found \""
+                  << std::string(m_fields[i].first, m_fields[i].second) << "\", exiting now..." << std::endl;
+        exit(1);
+    } // field_error()
+
+    bool Field_Scanner::field_is(unsigned int i, const char* s) const
+    {
+        if (i >= m_fields.size())
+        {
+            return false;
+        }
+        std::size_t length = m_fields[i].second - m_fields[i].first;
+        return (std::strlen(s) == length && std::memcmp(m_fields[i].first, s, length) == 0);
+    } // field_is()
+
+    bool Field_Scanner::field_is_empty(unsigned int i) const
+    {
+        check_field(i);
+        return (m_fields[i].first == m_fields[i].second);
+    } // field_is_empty()
+
+    std::string Field_Scanner::get_string(unsigned int i) const
+    {
+        check_field(i);
+        return std::string(m_fields[i].first, m_fields[i].second);
+    } // get_string()
+
+    char Field_Scanner::get_char(unsigned int i) const
+    {
+        check_field(i);
+        if (m_fields[i].first == m_fields[i].second)
+        {
+            field_error(i, "a character");
+        }
+        return *m_fields[i].first;
+    } // get_char()
+
+    int Field_Scanner::get_int(unsigned int i) const
+    {
+        check_field(i);
+        long value;
+        if (!parse_number(m_fields[i].first, m_fields[i].second, value) || value < INT_MIN || value > INT_MAX)
+        {
+            field_error(i, "an integer");
+        }
+        return (int)value;
+    } // get_int()
+
+    unsigned int Field_Scanner::get_uint(unsigned int i) const
+    {
+        check_field(i);
+        unsigned long value;
+        if (!parse_number(m_fields[i].first, m_fields[i].second, value) || value > UINT_MAX)
+        {
+            field_error(i, "an unsigned integer");
+        }
+        return (unsigned int)value;
+    } // get_uint()
+
+    unsigned long Field_Scanner::get_ulong(unsigned int i) const
+    {
+        check_field(i);
+        unsigned long value;
+        if (!parse_number(m_fields[i].first, m_fields[i].second, value))
+        {
+            field_error(i, "an unsigned integer");
+        }
+        return value;
+    } // get_ulong()
+
+    double Field_Scanner::get_double(unsigned int i) const
+    {
+        check_field(i);
+        double value;
+        if (!parse_number(m_fields[i].first, m_fields[i].second, value))
+        {
+            field_error(i, "a number");
+        }
+        return value;
+    } // get_double()
+
+} // namespace BSO
+
+
+#endif // FIELD_SCANNER_HPP
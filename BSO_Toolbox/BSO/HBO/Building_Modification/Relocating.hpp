@@ -6,9 +6,11 @@
 
 #include <BSO/HBO/HBO_Settings.hpp>
 #include <BSO/HBO/Performance_Evaluation/Building_Performances.hpp>
+#include <BSO/HBO/Performance_Evaluation/Candidate_Evaluation.hpp>
 
 #include <iostream>
 #include <vector>
+#include <map>
 #include <cmath>
 
 namespace BSO{ namespace HBO { namespace Building_Modification
@@ -17,7 +19,6 @@ namespace BSO{ namespace HBO { namespace Building_Modification
     BSO::Spatial_Design::MS_Building relocating_spaces( BSO::Spatial_Design::MS_Building& current_design, HBO::Performance_Evaluation::Building_Performances& build_perform, std::vector<int>& spaces_for_removal, Settings& settings)
     {
         BSO::Spatial_Design::MS_Building temp_design = current_design;
-        HBO::Performance_Evaluation::Building_Performances temp_build_perform = build_perform;
 
         int initial_space_count = current_design.obtain_space_count();
         double initial_volume = current_design.get_volume();
@@ -31,31 +32,30 @@ namespace BSO{ namespace HBO { namespace Building_Modification
         // convert to a SC_building and add a layer of cells around it
         BSO::Spatial_Design::SC_Building sc_build = temp_design;
         int amount_of_layers = 1; // 1 layers around the entire building
-        sc_build.add_padding(amount_of_layers * 2);
+        double layer_size = 3000; // [mm] the size of the padding cells
+        sc_build.add_padding(amount_of_layers * 2, amount_of_layers * 2, amount_of_layers * 2, layer_size);
 
-        // get the ids with the best performance
-        std::vector<int> best_ids;
-        for ( unsigned int i = 0 ; i < temp_build_perform.spaces[temp_build_perform.best_space_modified()].space_ID.size() ; i++ )
-        {
-            best_ids.push_back(temp_build_perform.spaces[temp_build_perform.best_space_modified()].space_ID[i]);
-        }
+        // the performances are only read while the cells are evaluated, so they are looked up instead of copied
+        int best_group = build_perform.best_space_modified();
+        std::map<int, double> performances = Performance_Evaluation::space_performances(build_perform);
 
         // check cells around the best spaces
 
-        std::vector<int> adjacent_empty_cells; // stores all empty adjacent cells
-
         std::map<int, double> adjacent_empty_cells; // stores all cells and their performance indicator
         typedef std::map<int, double>::iterator adjacent_ite;
 
-        for ( unsigned int i = 0 ; i < best_ids.size() ; i++ )
+        for ( unsigned int i = 0 ; i < build_perform.groups[best_group].space_ID.size() ; i++ )
         {
-            for ( unsigned int j = 1 ; j < sc_build.b_row_size(best_ids[i]) ; j++ )
+            int room_index = temp_design.get_space_index(build_perform.groups[best_group].space_ID[i]); // the rows of the supercube follow the spaces of the design
+
+            for ( unsigned int j = 1 ; j < sc_build.b_row_size(room_index) ; j++ )
             {
-                    if ( sc_build.request_b(best_ids[i], j )  == 1 )
+                    if ( sc_build.request_b(room_index, j )  == 1 )
                     {
-                        std::vector<int> temp_adjacent_cells = sc_build.adjacent_cells(j);
+                        int temp_adjacent_cells[6];
+                        unsigned int amount_adjacent = sc_build.adjacent_cells(j, temp_adjacent_cells);
 
-                        for (unsigned int k = 0 ; k < temp_adjacent_cells.size() ; k++ )
+                        for (unsigned int k = 0 ; k < amount_adjacent ; k++ )
                         {
                             if ( sc_build.empty_cell( temp_adjacent_cells[k] ) )
                             {
@@ -66,31 +66,42 @@ namespace BSO{ namespace HBO { namespace Building_Modification
             }
         }
 
-        // find the best empty cell
+        // find the performance of each empty cell, the sum of the performances of the spaces next to it
 
+        std::vector<int> candidate_cells;
         for ( adjacent_ite ite = adjacent_empty_cells.begin() ; ite != adjacent_empty_cells.end() ; ite++ )
         {
-            int amount_adjacent = sc_build.adjacent_cells(ite->first).size();
+            candidate_cells.push_back(ite->first);
+        }
+
+        std::vector<double> cell_scores = Performance_Evaluation::evaluate_candidates(candidate_cells.size(), [&](unsigned int c)
+        { // only reads the supercube, the design and the performances, see evaluate_candidates()
+            double score = 0;
+            int temp_adjacent_cells[6];
+            unsigned int amount_adjacent = sc_build.adjacent_cells(candidate_cells[c], temp_adjacent_cells);
 
             for ( unsigned int i = 0 ; i < amount_adjacent ; i++ )
             {
-                if ( !sc_build.empty_cell(ite->first) ) // if the cell is not empty
+                if ( !sc_build.empty_cell(temp_adjacent_cells[i]) ) // if the neighbouring cell is not empty
                 {
-                    // search the for the space id
-                    int id = sc_build.cell_space_id(ite->first);
-                    // get the index from the building performance this id belongs to
-                    int index = build_perform.id_belonging_space(id);
-                    // get the performance of the space
-                    double performance = build_perform.spaces[index].modified_performance;
-
-                    // add the performance to the second part of the adjacent map
-                    adjacent_empty_cells[ite->first] += performance;
+                    // search the for the space id, the supercube numbers the spaces of the design from 1
+                    int id = temp_design.obtain_space(sc_build.get_space_id(temp_adjacent_cells[i]) - 1).ID;
+
+                    // add the performance of the space to the score of the cell
+                    score += Performance_Evaluation::space_performance_of(performances, id);
                 }
-                else { continue; } // if the cell is empty add nothing to the mapped performance
             }
+            return score;
+        }, settings.n_threads);
+
+        for ( unsigned int i = 0 ; i < candidate_cells.size() ; i++ )
+        {
+            adjacent_empty_cells[candidate_cells[i]] = cell_scores[i];
         }
 
-        int best_cell_index;
+        // find the best empty cell
+
+        int best_cell_index = -1;
         double best_cell_performance = 0;
 
         for ( adjacent_ite ite = adjacent_empty_cells.begin() ; ite != adjacent_empty_cells.end() ; ite++ )
@@ -102,6 +113,9 @@ namespace BSO{ namespace HBO { namespace Building_Modification
             }
         }
 
+        // placing the removed spaces at the best cell is not implemented yet, the design is returned without them
+        return temp_design;
+
 
 
 
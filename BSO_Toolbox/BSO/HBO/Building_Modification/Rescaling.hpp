@@ -3,10 +3,13 @@
 
 #include <BSO/Spatial_Design/Movable_Sizable.hpp>
 #include <BSO/HBO/Performance_Evaluation/Building_Performances.hpp>
+#include <BSO/HBO/Performance_Evaluation/Candidate_Evaluation.hpp>
 #include <BSO/HBO/HBO_Settings.hpp>
 
 #include <iostream>
 #include <vector>
+#include <map>
+#include <algorithm>
 #include <cmath>
 
 
@@ -30,7 +33,7 @@ namespace BSO { namespace HBO { namespace Building_Modification
         double ratio_cur_new = initial_volume / new_volume;
 
         // rescale the new design
-        switch (settings::rescaling_options)
+        switch (settings.rescaling)
         {
             // options for scaling of a single axis
         case rescaling_options::X:
@@ -50,9 +53,11 @@ namespace BSO { namespace HBO { namespace Building_Modification
         case rescaling_options::XZ:
             new_design.scale_x(sqrt(ratio_cur_new));
             new_design.scale_z(sqrt(ratio_cur_new));
+            break;
         case rescaling_options::YZ:
             new_design.scale_y(sqrt(ratio_cur_new));
             new_design.scale_z(sqrt(ratio_cur_new));
+            break;
             // option scaling over three axis, cubic root of the ratio is used
         case rescaling_options::XYZ:
             new_design.scale_x(cbrt(ratio_cur_new));
@@ -72,41 +77,33 @@ namespace BSO { namespace HBO { namespace Building_Modification
 
         new_design.search_last_space_id(); // update the last_space_id of the new design
 
-        for ( unsigned int i = 0 ; i < spaces_for_removal.size() ; i++ )
+        // each remaining space is a candidate for a split, scored by the performance of its group (the splits do not modify the performances)
+        std::map<int, double> performances = Performance_Evaluation::space_performances(build_perform);
+        std::vector<int> candidate_IDs;
+        for ( int i = 0 ; i < new_design.obtain_space_count() ; i++ )
         {
-            Performance_Evaluation::Building_Performances temp_build_perform = build_perform;
-            int best_space_index = 0;
-            double best_space_performance = temp_build_perform.spaces[0].modified_performance[0];
-            int spaces_split = 0;
-
-            for ( unsigned int j = 0 ; j < temp_build_perform.spaces.size() ; j++ )
-            {
-                for ( unsigned int k = 0 ; k < temp_build_perform.spaces[j].modified_performance.size() ; k ++)
-                {
-                    if ( temp_build_perform.spaces[j].modified_performance[k] > best_space_performance )
-                    {
-                        best_space_performance = temp_build_perform.spaces[j].modified_performance[k];
-                        best_space_index = j;
-                    }
-                }
-            }
-
-            for ( unsigned j = 0 ; j < temp_build_perform.spaces[best_space_index].space_ID.size() ; j++ )
-            {
-                new_design.split_space(new_design.get_space_index( temp_build_perform.spaces[best_space_index].space_ID[j] ) ) ;
-                spaces_split++;
-
-                // check if the amount of IDs split is reached, since spaces can contain multiple IDs
-                if( spaces_split >= spaces_for_removal.size() )
-                {
-                    goto skip;
-                }
-            }
+            candidate_IDs.push_back(new_design.obtain_space(i).ID);
         }
 
-        skip:
+        std::vector<double> space_scores = Performance_Evaluation::evaluate_candidates(candidate_IDs.size(), [&](unsigned int c)
+        { // only reads the performances, see evaluate_candidates()
+            return Performance_Evaluation::space_performance_of(performances, candidate_IDs[c]);
+        }, settings.n_threads);
+
+        // split as many spaces as have been removed, the best first (the spaces of a group have equal scores and stay in order)
+        std::vector<unsigned int> split_order(candidate_IDs.size());
+        for ( unsigned int i = 0 ; i < split_order.size() ; i++ )
+        {
+            split_order[i] = i;
+        }
+        std::stable_sort(split_order.begin(), split_order.end(), [&](unsigned int a, unsigned int b) { return space_scores[a] > space_scores[b]; });
+
+        for ( unsigned int i = 0 ; i < spaces_for_removal.size() && i < split_order.size() ; i++ )
+        {
+            new_design.split_space(new_design.get_space_index(candidate_IDs[split_order[i]]));
+        }
 
-            return new_design;
+        return new_design;
     }
 
 
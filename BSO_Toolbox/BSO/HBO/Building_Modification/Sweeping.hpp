@@ -28,7 +28,7 @@ namespace BSO { namespace HBO { namespace Building_Modification
             // check if the space is on the removal list
             for ( unsigned int j = 0 ; j < spaces_for_removal.size() ; j++ )
             {
-                if ( current_design.obtain_space(i) == spaces_for_removal[j] )
+                if ( current_design.obtain_space(i).ID == spaces_for_removal[j] )
                 {
                     space_on_list = true;
                 }
@@ -93,11 +93,11 @@ namespace BSO { namespace HBO { namespace Building_Modification
 
             if ( !space_on_list )
             {
-                temp_design.add_space(current_design.obtain_space(i))
+                temp_design.add_space(current_design.obtain_space(i));
             }
         }
 
-        // find the best space and sweep it over the x axis
+        // find the outer spaces in the sweep direction and sweep them over the x axis
         std::vector<int> ids_to_sweep;
         double coordinate_to_sweep = temp_design.obtain_space(0).x;
 
@@ -131,71 +131,30 @@ namespace BSO { namespace HBO { namespace Building_Modification
                 exit(1);
                 break;
             }
-        // create a vector of pointer to sort the performances
-        std::vector<int&> sorted_ids;
-
-        for( unsigned int i = 0 ; i < temp_design.obtain_space_count() ; i++ )
+        // the spaces at that coordinate are swept over the x axis, they are collected first since the design changes while they are swept
+        for ( unsigned int i = 0 ; i < temp_design.obtain_space_count() ; i++ )
         {
             if ( temp_design.obtain_space(i).x == coordinate_to_sweep )
             {
-                for(unsigned int j = 0 ; j < sorted_ids.size() ; j++)
-                {
-                    if ( sorted_ids.empty())
-                    {
-                        sorted_ids.push_back(temp_design.obtain_space(i));
-                    }
-                    else
-                    {
-                        if ( build_perform.spaces[build_perform.id_belonging_space(temp_design.obtain_space(i).ID)].modified_performance[0]
-                    }
-                }
+                ids_to_sweep.push_back(temp_design.obtain_space(i).ID);
             }
         }
 
-            //////////////////////////////////// 26-7-2017
-
-        for ( unsigned int i = 0 ; i < temp_design.obtain_space_count() ; i++ )
+        for ( unsigned int i = 0 ; i < ids_to_sweep.size() ; i++ )
         {
-            if ( temp_design.obtain_space(i).x == coordinate_to_sweep && settings.direction == sweep_direction::POSITIVE )
-            {
-                BSO::Spatial_Design::MS_Space temp_space = temp_design.obtain_space(i);
-                temp_space.width *= 2;
-
-                temp_design.delete_space(i);
-                temp_design.add_space(temp_space);
-            }
-            else if( temp_design.obtain_space(i).x == coordinate_to_sweep && settings.direction == sweep_direction::NEGATIVE )
+            int index = temp_design.get_space_index(ids_to_sweep[i]);
+            BSO::Spatial_Design::MS_Space temp_space = temp_design.obtain_space(index);
+            if ( settings.direction == sweep_direction::NEGATIVE )
             {
-                BSO::Spatial_Design::MS_Space temp_space = temp_design.obtain_space(i);
                 temp_space.x -= temp_space.width;
-                temp_space.width *= 2;
-
-                temp_design.delete_space(i);
-                temp_design.add_space(temp_space);
-            }
-
-        }
-
-        // for each space in the removal list sweep a space over the x axis
-        for ( unsigned i = 0 ; i < spaces_for_removal.size() ; i++ )
-        {
-
-            for ( unsigned int j = 0 ; j < temp_design.obtain_space_count() ; j++ )
-            {
-                int best_peforming_id;
-                double best_performance = 1;
-
-
-                if ( temp_design.obtain_space(j).x ==0 )
-                {
-                    if( )
-                }
             }
+            temp_space.width *= 2;
 
+            temp_design.delete_space(index);
+            temp_design.add_space(temp_space);
         }
 
-
-
+        return temp_design;
     } // x_sweep_building_design()
 
 
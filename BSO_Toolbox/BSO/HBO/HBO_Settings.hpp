@@ -35,25 +35,29 @@ namespace BSO { namespace HBO{
         building_modification modification_options;
 
         aggregate_disciplines aggregate_options;
-        assessment_level space_or_clus;
+        assessment_level individual_or_clus;
         rescaling_options rescaling;
         sweep_direction direction;
 
         std::vector<double> weights; // weight factors for the different performances
         unsigned int space_removal_requested ; // the amount of spaces to be selected for removal, can increase due to spaces with similar performance
         unsigned int space_removal_selected; // the amount of spaces selected for removal
+        unsigned int n_threads; // the number of threads that score candidate modifications (0: one per hardware thread)
 
 
         Settings() // default settings
         {
-            assessment_options = performance_assessment::SOLO_AGGREGATED;
-            selection_options = space_selection::POSITIVE_COEVO;
-            modification_options = building_modification::SCALE_X;
+            assessment_options = performance_assessment::AGGREGATED;
+            selection_options = space_selection::WORST;
+            modification_options = building_modification::SCALE;
 
             aggregate_options = aggregate_disciplines::SUMMATION;
-            individual_or_clus = assessment_level::SPACES;
+            individual_or_clus = assessment_level::INDIVIDUAL;
+            rescaling = rescaling_options::X;
             space_removal_requested = 5;
-            direction = sweep_direction.POSITIVE;
+            space_removal_selected = 0;
+            n_threads = 0;
+            direction = sweep_direction::POSITIVE;
         }
     };
 
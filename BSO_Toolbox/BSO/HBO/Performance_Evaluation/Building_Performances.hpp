@@ -200,20 +200,23 @@ namespace BSO{ namespace HBO { namespace Performance_Evaluation
 
                     space_performance temp_group;
 
-                    for(unsigned int j = 0 ; j < clustered_data_set[i]->m_space_id_list.size() ; j++ )
-                    { // add space ids to the space performance
-                        temp_group.space_ID.push_back(clustered_data_set[i]->m_space_id_list[j]);
+                    for(unsigned int j = 0 ; j < clustered_data_set[i]->m_bit_mask.size() ; j++ )
+                    { // add space ids to the space performance, the data set follows space_id_list
+                        if (clustered_data_set[i]->m_bit_mask[j])
+                        {
+                            temp_group.space_ID.push_back(space_id_list[j]);
+                        }
                     }
                     for(unsigned int j = 0 ; j < clustered_data_set[i]->m_centroid.size() ; j++ )
                     { // add centroid to initial performance
                         temp_group.initial_performance.push_back(clustered_data_set[i]->m_centroid[j]);
                     }
 
-                    groups.push_back(temp_space);
+                    groups.push_back(temp_group);
                 }
-                for (unsigned int i = 0 ; i < spaces[0].initial_performance.size() ; i++ )
+                for (unsigned int i = 0 ; i < groups[0].initial_performance.size() ; i++ )
                 {
-                    weights.push_back(1 / spaces[0].initial_performance.size() );
+                    weights.push_back(1 / groups[0].initial_performance.size() );
                 }
                 break;
                 }
@@ -292,6 +295,10 @@ namespace BSO{ namespace HBO { namespace Performance_Evaluation
                         for ( unsigned int j = 0 ; j < bp_results.m_space_results.size() ; j++ )
                         {
                             if ( BSO::trim_and_cast_int(bp_results.m_space_results[j].m_space_ID) == temp_group.space_ID.back() )
+                            {
+                                temp_group.initial_performance.push_back( bp_results.m_space_results[j].m_rel_performance);
+                                break;
+                            }
                         }
                         groups.push_back(temp_group);
                     }
@@ -346,11 +353,11 @@ namespace BSO{ namespace HBO { namespace Performance_Evaluation
                      return i;
                  }
              }
-
-             // if no space objects can be found with the id give error and exit
-             std::cout<< "Error no space_ID :" << id <<" can be found, exiting now... ( Building_Performances.hpp)"<<std::endl;
-             exit(1);
          }
+
+         // if no space objects can be found with the id give error and exit
+         std::cout<< "Error no space_ID :" << id <<" can be found, exiting now... ( Building_Performances.hpp)"<<std::endl;
+         exit(1);
      }
 
      int Building_Performances::best_space_initial()
@@ -417,7 +424,7 @@ namespace BSO{ namespace HBO { namespace Performance_Evaluation
 
          for ( unsigned int i = 0 ; i < groups.size() ; i++ )
          {
-             for (unsigned int j = 0 ; groups[i].modified_performance.size() ; j++ )
+             for (unsigned int j = 0 ; j < groups[i].modified_performance.size() ; j++ )
              {
                  if ( groups[i].modified_performance[j] < worst_performance )
                  {
@@ -0,0 +1,111 @@
+#ifndef CANDIDATE_EVALUATION_HPP
+#define CANDIDATE_EVALUATION_HPP
+
+#include <BSO/HBO/Performance_Evaluation/Building_Performances.hpp>
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+
+namespace BSO{ namespace HBO { namespace Performance_Evaluation
+{
+    /* Scoring of candidate modifications, the candidates are scored concurrently
+     * against performance data that is shared by reference and not modified */
+
+    template<typename Score_Function>
+    std::vector<double> evaluate_candidates(unsigned int candidate_count, Score_Function score, unsigned int n_threads = 0, unsigned int min_candidates_per_thread = 8)
+    { // returns score(i) for each candidate i (0 threads: one per hardware thread), score may only read shared data, as it is called from several threads at once;
+      // a thread is only started for every min_candidates_per_thread candidates, as a score is cheap compared to starting a thread
+        if (n_threads == 0)
+        {
+            n_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        n_threads = std::max(1u, std::min(n_threads, candidate_count / std::max(1u, min_candidates_per_thread)));
+
+        std::vector<double> scores(candidate_count);
+        std::atomic<unsigned int> next_candidate(0);
+        std::atomic<bool> failed(false);
+
+        auto score_candidates = [&]()
+        { // an exception may not leave a worker thread (that terminates the process), it is reported after all workers are done
+            for ( unsigned int j = next_candidate++ ; j < candidate_count && !failed ; j = next_candidate++ )
+            {
+                try
+                {
+                    scores[j] = score(j);
+                }
+                catch (...)
+                {
+                    failed = true;
+                }
+            }
+        };
+
+        if (n_threads == 1)
+        {
+            score_candidates();
+        }
+        else
+        {
+            std::vector<std::thread> workers;
+            for ( unsigned int i = 0 ; i < n_threads ; i++ )
+            {
+                workers.push_back(std::thread(score_candidates));
+            }
+
+            for ( unsigned int i = 0 ; i < workers.size() ; i++ )
+            {
+                workers[i].join();
+            }
+        }
+
+        if (failed)
+        {
+            std::cout<< "Error, a candidate modification could not be scored, exiting now... (Candidate_Evaluation.hpp)"<<std::endl;
+            exit(1);
+        }
+
+        return scores;
+    } // evaluate_candidates()
+
+    std::map<int, double> space_performances(const Building_Performances& build_perform)
+    { // returns the summed modified performance of the group each space ID belongs to, looked up once instead of searching the groups per candidate
+        std::map<int, double> performances;
+
+        for ( unsigned int i = 0 ; i < build_perform.groups.size() ; i++ )
+        {
+            double performance = 0;
+            for ( unsigned int j = 0 ; j < build_perform.groups[i].modified_performance.size() ; j++ )
+            {
+                performance += build_perform.groups[i].modified_performance[j];
+            }
+
+            for ( unsigned int j = 0 ; j < build_perform.groups[i].space_ID.size() ; j++ )
+            {
+                performances[build_perform.groups[i].space_ID[j]] = performance;
+            }
+        }
+
+        return performances;
+    } // space_performances()
+
+    double space_performance_of(const std::map<int, double>& performances, int id)
+    { // returns the performance of the space with the given ID, see space_performances()
+        std::map<int, double>::const_iterator ite = performances.find(id);
+        if ( ite == performances.end() )
+        {
+            std::cout<< "Error no space_ID :" << id <<" can be found, exiting now... (Candidate_Evaluation.hpp)"<<std::endl;
+            exit(1);
+        }
+        return ite->second;
+    } // space_performance_of()
+
+} // namespace Performance_Evaluation
+} // namespace HBO
+} // namespace BSO
+
+#endif // CANDIDATE_EVALUATION_HPP
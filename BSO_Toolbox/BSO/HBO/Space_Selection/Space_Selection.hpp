@@ -181,7 +181,7 @@ namespace BSO{ namespace HBO{ namespace Space_Selection
     } // select_best_spaces()
 
 
-    std::vector<int> select_one_or_another_worst(Performance_Evaluation::Building_PerformancesU& build_perform, Settings& settings)
+    std::vector<int> select_one_or_another_worst(Performance_Evaluation::Building_Performances& build_perform, Settings& settings)
     {
         Performance_Evaluation::Building_Performances temp_perform = build_perform;
         std::vector<int> selected_spaces;
@@ -196,7 +196,7 @@ namespace BSO{ namespace HBO{ namespace Space_Selection
             }
         }
 
-        while ( selected_spaces < settings.space_removal_requested )
+        while ( selected_spaces.size() < settings.space_removal_requested )
         {
             int critical_space_index = 0;
             double critical_performance;
@@ -259,7 +259,7 @@ namespace BSO{ namespace HBO{ namespace Space_Selection
             {
                 if ( i == 0 )
                 {
-                    selected_performance = temp_perform.groups[0].modified_performance[selected_performance];
+                    critical_performance = temp_perform.groups[0].modified_performance[selected_performance];
                 }
 
                 if ( critical_performance < temp_perform.groups[i].modified_performance[selected_performance] )
@@ -17,11 +17,93 @@
 #include <map>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <memory>
 
 namespace BSO {
     /*
      * Structures to store results of a BP_simulation
      */
+
+    struct space_score
+    {
+        int m_ID;
+        double m_score;
+    }; // space_score
+
+    template <typename T>
+    std::vector<space_score> space_scores(const std::map<int, T>& performances)
+    { // copies the performances of the spaces to a contiguous list, ordered by space ID
+        std::vector<space_score> scores;
+        scores.reserve(performances.size());
+        for (typename std::map<int, T>::const_iterator ite = performances.begin(); ite != performances.end(); ite++)
+        {
+            space_score temp = {ite->first, (double)ite->second};
+            scores.push_back(temp);
+        }
+        return scores;
+    } // space_scores()
+
+    std::vector<int> select_worst_spaces(std::vector<space_score> scores, unsigned int count, double tolerance, bool high_is_worst)
+    { // returns the IDs of the 'count' worst performing spaces, and of the spaces that lie within 'tolerance' of the last of those,
+      // ordered from worst to best (equal performances by ascending ID); only the selected spaces are sorted
+        std::vector<int> space_IDs;
+        if (count > scores.size())
+        {
+            count = scores.size();
+        }
+        if (count == 0)
+        {
+            return space_IDs;
+        }
+
+        auto worse = [high_is_worst](const space_score& a, const space_score& b)
+        {
+            if (a.m_score != b.m_score)
+            {
+                return high_is_worst ? (a.m_score > b.m_score) : (a.m_score < b.m_score);
+            }
+            return a.m_ID < b.m_ID;
+        };
+
+        std::nth_element(scores.begin(), scores.begin() + (count-1), scores.end(), worse);
+        double critical_performance = scores[count-1].m_score;
+        std::vector<space_score>::iterator selection_end = std::partition(scores.begin() + count, scores.end(), [&](const space_score& score)
+        { // the spaces that perform (nearly) as bad as the last of the worst spaces are removed as well
+            return (high_is_worst ? critical_performance - score.m_score : score.m_score - critical_performance) < tolerance;
+        });
+        std::sort(scores.begin(), selection_end, worse);
+
+        for (std::vector<space_score>::iterator ite = scores.begin(); ite != selection_end; ite++)
+        {
+            space_IDs.push_back(ite->m_ID);
+        }
+        return space_IDs;
+    } // select_worst_spaces()
+
+    std::vector<unsigned int> rank_clusters(const std::vector<std::shared_ptr<Cluster> >& clusters)
+    { // returns the indices of the clusters from the largest to the smallest distance of their centroid to the origin, equal distances in their order
+        std::vector<unsigned int> ranking(clusters.size());
+        for (unsigned int i = 0; i < ranking.size(); i++)
+        {
+            ranking[i] = i;
+        }
+        std::stable_sort(ranking.begin(), ranking.end(), [&clusters](unsigned int a, unsigned int b)
+        {
+            return clusters[a]->m_dist_from_origin > clusters[b]->m_dist_from_origin;
+        });
+        return ranking;
+    } // rank_clusters()
+
+    std::map<unsigned int, unsigned int> index_space_IDs(const std::vector<unsigned int>& space_id_list)
+    { // returns the position of each space ID in the list, so that results can be matched to the spaces without scanning the list
+        std::map<unsigned int, unsigned int> space_indices;
+        for (unsigned int i = 0; i < space_id_list.size(); i++)
+        {
+            space_indices[space_id_list[i]] = i;
+        }
+        return space_indices;
+    } // index_space_IDs()
 	
 	#ifdef SD_ANALYSIS_HPP
     Spatial_Design::MS_Building scale_and_subdivide_1(Spatial_Design::MS_Building& current_design,
@@ -34,66 +116,21 @@ namespace BSO {
         double initial_volume = current_design.get_volume();
 
         std::map<int, unsigned int> sd_performances;
-        typedef std::map<int, unsigned int>::iterator space_ite;
 
         for (unsigned int i = 0; i < sd_results.m_spaces.size(); i++)
         {
             sd_performances[sd_results.m_spaces[i].m_ID] = sd_results.m_spaces[i].m_deletion_count;
         }
 
-        std::vector<int> space_performances_ordered;
         // although described in the thesis, below vectors are not used
         //std::vector<int> space_floor_areas_ordered;
         //std::vector<int> space_coords_ordered;
         //std::vector<int> space_ratios_ordered;
 
-        // create an ordered list that maps space performances to their space ID
-        for (space_ite ite = sd_performances.begin(); ite != sd_performances.end(); ite++)
-        {
-            bool space_inserted = false;
-            for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
-            {
-                if (ite->second > sd_performances[space_performances_ordered[i] ])
-                {
-                    space_performances_ordered.insert(space_performances_ordered.begin() + i, ite->first);
-                    space_inserted = true;
-                    break;
-                }
-            }
-            if (!space_inserted)
-            { // if the space's performance is not smaller than that of any of the already inserted spaces, then add it to the back of the vector
-                space_performances_ordered.push_back(ite->first);
-            }
-            space_inserted = false;
-        }
-
-
-        unsigned int delete_pos = space_total - space_total/2;
-        unsigned int deleted_elements = 0;
-
-        for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
-        { // delete the worst performing spaces
-            if (i < delete_pos - 1)
-            {
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else if (i == delete_pos - 1)
-            {
-                deleted_elements = sd_performances[space_performances_ordered[i] ];
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else if (deleted_elements == sd_performances[space_performances_ordered[i] ])
-            {
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else
-            {
-                break;
-            }
-        }
+        // delete the worst performing spaces (deletion counts are whole numbers, so only spaces with the same count are added)
+        std::vector<int> deleted_spaces = select_worst_spaces(space_scores(sd_performances), space_total - space_total/2, 1.0, true);
+        new_design.delete_spaces(deleted_spaces);
+        space_delete_number = deleted_spaces.size();
 
         // all though described in the thesis, the sorted lists below are not used
 /*        // create ordered lists of space ID's
@@ -245,61 +282,16 @@ namespace BSO {
         double initial_volume = current_design.get_volume();
 
         std::map<int, double> sd_performances;
-        typedef std::map<int, double>::iterator space_ite;
 
         for (unsigned int i = 0; i < sd_results.m_spaces.size(); i++)
         {
             sd_performances[sd_results.m_spaces[i].m_ID] = sd_results.m_spaces[i].m_rel_performance;
         }
 
-        std::vector<int> space_performances_ordered;
-
-        // create an ordered list that maps space performances to their space ID
-        for (space_ite ite = sd_performances.begin(); ite != sd_performances.end(); ite++)
-        {
-            bool space_inserted = false;
-            for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
-            {
-                if (ite->second < sd_performances[space_performances_ordered[i] ])
-                {
-                    space_performances_ordered.insert(space_performances_ordered.begin() + i, ite->first);
-                    space_inserted = true;
-                    break;
-                }
-            }
-            if (!space_inserted)
-            { // if the space's performance is not smaller than that of any of the already inserted spaces, then add it to the back of the vector
-                space_performances_ordered.push_back(ite->first);
-            }
-            space_inserted = false;
-        }
-
-        unsigned int delete_pos = space_total - space_total/2;
-        double critical_performance = 0;
-
-        for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
-        { // delete the worst performing spaces
-            if (i < delete_pos - 1)
-            {
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else if (i == delete_pos - 1)
-            {
-                critical_performance = sd_performances[space_performances_ordered[i] ];
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else if (sd_performances[space_performances_ordered[i] ] - critical_performance < 0.0001)
-            {
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else
-            {
-                break;
-            }
-        }
+        // delete the worst performing spaces, and the spaces that perform nearly as bad as the last of those
+        std::vector<int> deleted_spaces = select_worst_spaces(space_scores(sd_performances), space_total - space_total/2, 0.0001, false);
+        new_design.delete_spaces(deleted_spaces);
+        space_delete_number = deleted_spaces.size();
 
         // calculate 'D' the number of divisions
         int D = (int)((1/(1-(double)space_delete_number/(double)space_total))+0.5);
@@ -384,61 +376,16 @@ namespace BSO {
         double initial_volume = current_design.get_volume();
 
         std::map<int, double> bp_performances;
-        typedef std::map<int, double>::iterator space_ite;
 
         for (unsigned int i = 0; i < bp_results.m_space_results.size(); i++)
         {
             bp_performances[trim_and_cast_int(bp_results.m_space_results[i].m_space_ID)] = bp_results.m_space_results[i].m_rel_performance;
         }
 
-        std::vector<int> space_performances_ordered;
-
-        // create an ordered list that maps space performances to their space ID
-        for (space_ite ite = bp_performances.begin(); ite != bp_performances.end(); ite++)
-        {
-            bool space_inserted = false;
-            for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
-            {
-                if (ite->second < bp_performances[space_performances_ordered[i] ])
-                {
-                    space_performances_ordered.insert(space_performances_ordered.begin() + i, ite->first);
-                    space_inserted = true;
-                    break;
-                }
-            }
-            if (!space_inserted)
-            { // if the space's performance is not smaller than that of any of the already inserted spaces, then add it to the back of the vector
-                space_performances_ordered.push_back(ite->first);
-            }
-            space_inserted = false;
-        }
-
-        unsigned int delete_pos = space_total - space_total/2;
-        double critical_performance = 0;
-
-        for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
-        { // delete the worst performing spaces
-            if (i < delete_pos - 1)
-            {
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else if (i == delete_pos - 1)
-            {
-                critical_performance = bp_performances[space_performances_ordered[i] ];
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else if (bp_performances[space_performances_ordered[i] ] - critical_performance < 0.01)
-            {
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else
-            {
-                break;
-            }
-        }
+        // delete the worst performing spaces, and the spaces that perform nearly as bad as the last of those
+        std::vector<int> deleted_spaces = select_worst_spaces(space_scores(bp_performances), space_total - space_total/2, 0.01, false);
+        new_design.delete_spaces(deleted_spaces);
+        space_delete_number = deleted_spaces.size();
 
         // calculate 'D' the number of divisions
         int D = (int)((1/(1-(double)space_delete_number/(double)space_total))+0.5);
@@ -525,7 +472,6 @@ namespace BSO {
         double initial_volume = current_design.get_volume();
 
         std::map<int, double> bp_sd_performances;
-        typedef std::map<int, double>::iterator space_ite;
 
         // below misses error catch, case: when an ID does not get a performance (or no performance at some disciplines)
         for (unsigned int i = 0; i < bp_results.m_space_results.size(); i++)
@@ -539,54 +485,10 @@ namespace BSO {
             bp_sd_performances[sd_results.m_spaces[i].m_ID] /= 2.0;
         }
 
-        std::vector<int> space_performances_ordered;
-
-        // create an ordered list that maps space performances to their space ID
-        for (space_ite ite = bp_sd_performances.begin(); ite != bp_sd_performances.end(); ite++)
-        {
-            bool space_inserted = false;
-            for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
-            {
-                if (ite->second < bp_sd_performances[space_performances_ordered[i] ])
-                {
-                    space_performances_ordered.insert(space_performances_ordered.begin() + i, ite->first);
-                    space_inserted = true;
-                    break;
-                }
-            }
-            if (!space_inserted)
-            { // if the space's performance is not smaller than that of any of the already inserted spaces, then add it to the back of the vector
-                space_performances_ordered.push_back(ite->first);
-            }
-            space_inserted = false;
-        }
-
-        unsigned int delete_pos = space_total - space_total/2;
-        double critical_performance = 0;
-
-        for (unsigned int i = 0; i < space_performances_ordered.size(); i++)
-        { // delete the worst performing spaces
-            if (i < delete_pos - 1)
-            {
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else if (i == delete_pos - 1)
-            {
-                critical_performance = bp_sd_performances[space_performances_ordered[i] ];
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else if (bp_sd_performances[space_performances_ordered[i] ] - critical_performance < 0.01)
-            {
-                new_design.delete_space(new_design.get_space_index(space_performances_ordered[i]));
-                space_delete_number++;
-            }
-            else
-            {
-                break;
-            }
-        }
+        // delete the worst performing spaces, and the spaces that perform nearly as bad as the last of those
+        std::vector<int> deleted_spaces = select_worst_spaces(space_scores(bp_sd_performances), space_total - space_total/2, 0.01, false);
+        new_design.delete_spaces(deleted_spaces);
+        space_delete_number = deleted_spaces.size();
 
         // calculate 'D' the number of divisions
         int D = (int)((1/(1-(double)space_delete_number/(double)space_total))+0.5);
@@ -684,16 +586,15 @@ namespace BSO {
         }
 
         std::vector<bool> match_check(space_id_list.size(), false); // this list will keep track if a performance has been found for each space
+        std::map<unsigned int, unsigned int> space_indices = index_space_IDs(space_id_list); // the position of each space ID in the lists above
 
         for (unsigned int i = 0; i < bp_results.m_space_results.size(); i++)
         { // for each space result
-            for (unsigned int j = 0; j < number_of_spaces; j++)
-            { // and for each space in the design
-                if (space_id_list[j] == BSO::trim_and_cast_uint(bp_results.m_space_results[i].m_space_ID))
-                { // check if space_result matches with a space in the design
-                    (*data_set)[j](0) = bp_results.m_space_results[i].m_total_energy;
-                    match_check[j] = true;
-                }
+            std::map<unsigned int, unsigned int>::iterator ite = space_indices.find(BSO::trim_and_cast_uint(bp_results.m_space_results[i].m_space_ID));
+            if (ite != space_indices.end())
+            { // check if space_result matches with a space in the design
+                (*data_set)[ite->second](0) = bp_results.m_space_results[i].m_total_energy;
+                match_check[ite->second] = true;
             }
         }
 
@@ -709,13 +610,11 @@ namespace BSO {
 
         for (unsigned int i = 0; i < sd_results.m_spaces.size(); i++)
         { // for each space result
-            for (unsigned int j = 0; j < space_id_list.size(); j++)
-            { // and for each space in the design
-                if (space_id_list[j] == (unsigned int)sd_results.m_spaces[i].m_ID)
-                { // check if space_result matches with a space in the design
-                    (*data_set)[j](1) = sd_results.m_spaces[i].m_total_compliance;
-                    match_check[j] = false;
-                }
+            std::map<unsigned int, unsigned int>::iterator ite = space_indices.find((unsigned int)sd_results.m_spaces[i].m_ID);
+            if (ite != space_indices.end())
+            { // check if space_result matches with a space in the design
+                (*data_set)[ite->second](1) = sd_results.m_spaces[i].m_total_compliance;
+                match_check[ite->second] = false;
             }
         }
 
@@ -737,33 +636,34 @@ namespace BSO {
         // remove cluster by cluster the worst performing cluster until half of the spaces has been removed
         // here the distance from a cluster's centroid to the origin is used to asses a cluster
         unsigned int removed_spaces = 0;
-        std::vector<std::shared_ptr<BSO::Cluster> > cp_cluster_set = clustered_data_set; // copy the clustered set of data for
+        std::vector<unsigned int> cluster_ranking = rank_clusters(clustered_data_set); // the clusters from the furthest to the closest distance
+        std::vector<bool> cluster_removed(clustered_data_set.size(), false);
+        std::vector<int> removed_space_IDs;
 
-        while (removed_spaces < number_of_spaces/2)
+        for (unsigned int i = 0; i < cluster_ranking.size() && removed_spaces < number_of_spaces/2; i++)
         { // as long as not half of all spaces are removed
-            double max_distance = 0;
-            unsigned int furthest_cluster = 0;
-            for (unsigned int i = 0; i < cp_cluster_set.size(); i++)
-            { // for each cluster
-                if (max_distance < cp_cluster_set[i]->m_dist_from_origin)
-                { // find cluster that has the centroid with the largest distance from the origin
-                    max_distance = cp_cluster_set[i]->m_dist_from_origin;
-                    furthest_cluster = i;
-                }
-            }
+            unsigned int furthest_cluster = cluster_ranking[i];
 
             // remove all spaces that are in the cluster with the furthest distance
-            for (unsigned int i = 0; i < number_of_spaces; i++)
+            for (unsigned int j = 0; j < number_of_spaces; j++)
             { // for each space in the design
-                if (cp_cluster_set[furthest_cluster]->m_bit_mask[i])
+                if (clustered_data_set[furthest_cluster]->m_bit_mask[j])
                 { // check if it belongs to the cluster
-                    new_design.delete_space(new_design.get_space_index(space_id_list[i])); // remove the space in this cluster
+                    removed_space_IDs.push_back(space_id_list[j]); // remove the space in this cluster
                     removed_spaces++;
                 }
             }
+            cluster_removed[furthest_cluster] = true;
+        }
+        new_design.delete_spaces(removed_space_IDs);
 
-            // remove the cluster from the (copied) clustered data set
-            cp_cluster_set.erase(cp_cluster_set.begin()+furthest_cluster);
+        std::vector<std::shared_ptr<BSO::Cluster> > cp_cluster_set; // the clusters that remain
+        for (unsigned int i = 0; i < clustered_data_set.size(); i++)
+        {
+            if (!cluster_removed[i])
+            {
+                cp_cluster_set.push_back(clustered_data_set[i]);
+            }
         }
 
         // scale the building back to its initial volume
@@ -847,16 +747,15 @@ namespace BSO {
         }
 
         std::vector<bool> match_check(space_id_list.size(), false); // this list will keep track if a performance has been found for each space
+        std::map<unsigned int, unsigned int> space_indices = index_space_IDs(space_id_list); // the position of each space ID in the lists above
 
         for (unsigned int i = 0; i < bp_results.m_space_results.size(); i++)
         { // for each space result
-            for (unsigned int j = 0; j < number_of_spaces; j++)
-            { // and for each space in the design
-                if (space_id_list[j] == BSO::trim_and_cast_uint(bp_results.m_space_results[i].m_space_ID))
-                { // check if space_result matches with a space in the design
-                    (*data_set)[j](0) = bp_results.m_space_results[i].m_total_energy;
-                    match_check[j] = true;
-                }
+            std::map<unsigned int, unsigned int>::iterator ite = space_indices.find(BSO::trim_and_cast_uint(bp_results.m_space_results[i].m_space_ID));
+            if (ite != space_indices.end())
+            { // check if space_result matches with a space in the design
+                (*data_set)[ite->second](0) = bp_results.m_space_results[i].m_total_energy;
+                match_check[ite->second] = true;
             }
         }
 
@@ -878,33 +777,34 @@ namespace BSO {
         // remove cluster by cluster the worst performing cluster until half of the spaces has been removed
         // here the distance from a cluster's centroid to the origin is used to asses a cluster
         unsigned int removed_spaces = 0;
-        std::vector<std::shared_ptr<BSO::Cluster> > cp_cluster_set = clustered_data_set; // copy the clustered set of data for
+        std::vector<unsigned int> cluster_ranking = rank_clusters(clustered_data_set); // the clusters from the furthest to the closest distance
+        std::vector<bool> cluster_removed(clustered_data_set.size(), false);
+        std::vector<int> removed_space_IDs;
 
-        while (removed_spaces < number_of_spaces/2)
+        for (unsigned int i = 0; i < cluster_ranking.size() && removed_spaces < number_of_spaces/2; i++)
         { // as long as not half of all spaces are removed
-            double max_distance = 0;
-            unsigned int furthest_cluster = 0;
-            for (unsigned int i = 0; i < cp_cluster_set.size(); i++)
-            { // for each cluster
-                if (max_distance < cp_cluster_set[i]->m_dist_from_origin)
-                { // find cluster that has the centroid with the largest distance from the origin
-                    max_distance = cp_cluster_set[i]->m_dist_from_origin;
-                    furthest_cluster = i;
-                }
-            }
+            unsigned int furthest_cluster = cluster_ranking[i];
 
             // remove all spaces that are in the cluster with the furthest distance
-            for (unsigned int i = 0; i < number_of_spaces; i++)
+            for (unsigned int j = 0; j < number_of_spaces; j++)
             { // for each space in the design
-                if (cp_cluster_set[furthest_cluster]->m_bit_mask[i])
+                if (clustered_data_set[furthest_cluster]->m_bit_mask[j])
                 { // check if it belongs to the cluster
-                    new_design.delete_space(new_design.get_space_index(space_id_list[i])); // remove the space in this cluster
+                    removed_space_IDs.push_back(space_id_list[j]); // remove the space in this cluster
                     removed_spaces++;
                 }
             }
+            cluster_removed[furthest_cluster] = true;
+        }
+        new_design.delete_spaces(removed_space_IDs);
 
-            // remove the cluster from the (copied) clustered data set
-            cp_cluster_set.erase(cp_cluster_set.begin()+furthest_cluster);
+        std::vector<std::shared_ptr<BSO::Cluster> > cp_cluster_set; // the clusters that remain
+        for (unsigned int i = 0; i < clustered_data_set.size(); i++)
+        {
+            if (!cluster_removed[i])
+            {
+                cp_cluster_set.push_back(clustered_data_set[i]);
+            }
         }
 
         // scale the building back to its initial volume
@@ -991,18 +891,17 @@ namespace BSO {
 
 
         std::vector<bool> match_check(space_id_list.size(), false); // this list will keep track if a performance has been found for each space
+        std::map<unsigned int, unsigned int> space_indices = index_space_IDs(space_id_list); // the position of each space ID in the lists above
 
         if (mode_switch == 0 || mode_switch == 1)
         {
             for (unsigned int i = 0; i < bp_results.m_space_results.size(); i++)
             { // for each space result
-                for (unsigned int j = 0; j < number_of_spaces; j++)
-                { // and for each space in the design
-                    if (space_id_list[j] == BSO::trim_and_cast_uint(bp_results.m_space_results[i].m_space_ID))
-                    { // check if space_result matches with a space in the design
-                        data_set[j](0) = bp_results.m_space_results[i].m_total_energy;
-                        match_check[j] = true;
-                    }
+                std::map<unsigned int, unsigned int>::iterator ite = space_indices.find(BSO::trim_and_cast_uint(bp_results.m_space_results[i].m_space_ID));
+                if (ite != space_indices.end())
+                { // check if space_result matches with a space in the design
+                    data_set[ite->second](0) = bp_results.m_space_results[i].m_total_energy;
+                    match_check[ite->second] = true;
                 }
             }
 
@@ -1021,13 +920,11 @@ namespace BSO {
         {
             for (unsigned int i = 0; i < sd_results.m_spaces.size(); i++)
             { // for each space result
-                for (unsigned int j = 0; j < space_id_list.size(); j++)
-                { // and for each space in the design
-                    if (space_id_list[j] == (unsigned int)sd_results.m_spaces[i].m_ID)
-                    { // check if space_result matches with a space in the design
-                        data_set[j](1) = sd_results.m_spaces[i].m_total_compliance;
-                        match_check[j] = false;
-                    }
+                std::map<unsigned int, unsigned int>::iterator ite = space_indices.find((unsigned int)sd_results.m_spaces[i].m_ID);
+                if (ite != space_indices.end())
+                { // check if space_result matches with a space in the design
+                    data_set[ite->second](1) = sd_results.m_spaces[i].m_total_compliance;
+                    match_check[ite->second] = false;
                 }
             }
 
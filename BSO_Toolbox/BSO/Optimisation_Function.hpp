@@ -7,46 +7,224 @@
 
 #include <BSO/Performance_Indexing.hpp>
 #include <BSO/Heuristics.hpp>
+#include <BSO/Evaluation_Cache.hpp>
 
 #include <iostream>
 #include <vector>
 #include <ctime>
 #include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
 
 namespace BSO {
 
 //bool check_constraint(std::string);
 
-template<typename stream_type>
-void Opt_func_1(std::string input_file, unsigned int n_ite, Spatial_Design::Grammar_Ptr grammar, std::string output_file, stream_type &output)
+void analyse_concurrently(Structural_Design::SD_Analysis& SD_building, Building_Physics::BP_Simulation& BP_building, unsigned int n_threads = 0)
+{ // runs the structural analysis and the thermal simulation at the same time, after both models have been made
+  // (the grammars that make them modify the conformal model, the analyses only read their own model),
+  // n_threads is passed on to BP_Simulation::sim_period()
+    std::thread sd_thread([&SD_building]() { SD_building.analyse(); });
+    BP_building.sim_period(n_threads);
+    sd_thread.join();
+} // analyse_concurrently()
+
+struct Design_Evaluation
 {
+    Structural_Design::SD_Building_Results m_sd_results;
+    Building_Physics::BP_Building_Results m_bp_results;
+}; // Design_Evaluation
+
+std::vector<Design_Evaluation> evaluate_designs(std::vector<Spatial_Design::MS_Building>& designs, Spatial_Design::Grammar_Ptr grammar,
+                                                unsigned int n_threads = 0, unsigned int max_models = 0, Evaluation_Cache* cache = nullptr)
+{ // evaluates a population of candidate designs (conformation, SD analysis, BP simulation and indexing), returns the results in the order of the designs;
+  // each worker evaluates one design at a time, at most max_models designs have their models in memory at once (0: one per worker),
+  // the threads that are left over when there are fewer designs than threads go to the analyses of each design
+    if (n_threads == 0)
+    {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    unsigned int n_workers = std::min(n_threads, std::max(1u, (unsigned int)designs.size()));
+    unsigned int threads_per_design = std::max(1u, n_threads/n_workers);
+    if (max_models == 0 || max_models > n_workers)
+    {
+        max_models = n_workers;
+    }
+
+    std::vector<Design_Evaluation> results(designs.size());
+    std::atomic<unsigned int> next_design(0);
+    std::mutex build_mutex; // the grammars keep counters in static members and read the settings files, so models are made one at a time
+    std::mutex cache_mutex;
+    std::mutex models_mutex;
+    std::condition_variable models_cv;
+    unsigned int models_in_memory = 0;
+
+    auto evaluate = [&]()
+    {
+        for (unsigned int j = next_design++; j < designs.size(); j = next_design++)
+        {
+            Design_Evaluation& result = results[j];
+            bool sd_found = false;
+            bool bp_found = false;
+            if (cache != nullptr)
+            {
+                std::lock_guard<std::mutex> lock(cache_mutex);
+                sd_found = cache->find_sd_results(designs[j], result.m_sd_results);
+                bp_found = cache->find_bp_results(designs[j], result.m_bp_results);
+            }
+
+            if (!sd_found || !bp_found)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(models_mutex);
+                    models_cv.wait(lock, [&]() { return models_in_memory < max_models; });
+                    models_in_memory++;
+                }
+
+                Spatial_Design::MS_Conformal* CF;
+                Structural_Design::SD_Analysis* SD_building = nullptr;
+                Building_Physics::BP_Simulation* BP_building = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(build_mutex);
+                    CF = new Spatial_Design::MS_Conformal(designs[j], grammar);
+                    CF->make_conformal();
+                    if (!sd_found) SD_building = new Structural_Design::SD_Analysis(*CF);
+                    if (!bp_found) BP_building = new Building_Physics::BP_Simulation(*CF);
+                }
+
+                // the analyses only read their own model, so they run outside of the lock
+                if (SD_building != nullptr && BP_building != nullptr && threads_per_design > 1)
+                {
+                    analyse_concurrently(*SD_building, *BP_building, threads_per_design);
+                }
+                else
+                {
+                    if (SD_building != nullptr) SD_building->analyse();
+                    if (BP_building != nullptr) BP_building->sim_period(threads_per_design);
+                }
+                if (SD_building != nullptr)
+                {
+                    result.m_sd_results = SD_building->get_results();
+                    delete SD_building;
+                }
+                if (BP_building != nullptr)
+                {
+                    result.m_bp_results = BP_building->get_results();
+                    delete BP_building;
+                }
+                delete CF;
+
+                {
+                    std::lock_guard<std::mutex> lock(models_mutex);
+                    models_in_memory--;
+                }
+                models_cv.notify_one();
+
+                if (cache != nullptr)
+                {
+                    std::lock_guard<std::mutex> lock(cache_mutex);
+                    if (!sd_found) cache->store_sd_results(designs[j], result.m_sd_results);
+                    if (!bp_found) cache->store_bp_results(designs[j], result.m_bp_results);
+                }
+            }
+
+            SD_compliance_indexing(result.m_sd_results);
+            BP_thermal_demand_indexing(result.m_bp_results);
+        }
+    };
+
+    if (n_workers == 1)
+    { // a single design (or a single thread) is evaluated on the calling thread
+        evaluate();
+        return results;
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < n_workers; i++)
+    {
+        workers.push_back(std::thread(evaluate));
+    }
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    return results;
+} // evaluate_designs()
+
+const unsigned int max_design_variants = 4;
+
+std::vector<Spatial_Design::MS_Building> design_variants(Spatial_Design::MS_Building& current_design, Building_Physics::BP_Building_Results& bp_results,
+                                                         Structural_Design::SD_Building_Results& sd_results, unsigned int n_variants)
+{ // the next designs that the heuristics propose for the current design, the first variant is the one Opt_func_1 always followed;
+  // only heuristics that use the compliance and thermal demand indexing of Opt_func_1 are used (scale_and_subdivide_1 needs the removed mass indexing)
+    n_variants = std::max(1u, std::min(n_variants, max_design_variants));
+    std::vector<Spatial_Design::MS_Building> variants;
+    variants.push_back(change_1_space(current_design, bp_results, sd_results, 0));
+    if (n_variants > 1) variants.push_back(combined_scale_and_subdivide(current_design, bp_results, sd_results));
+    if (n_variants > 2) variants.push_back(BP_scale_and_subdivide(current_design, bp_results));
+    if (n_variants > 3) variants.push_back(scale_and_subdivide_2(current_design, sd_results));
+    return variants;
+} // design_variants()
+
+unsigned int select_design_variant(const std::vector<Design_Evaluation>& evaluations)
+{ // the variant with the lowest sum of its compliance and energy, each normalised over the variants
+  // (a performance that is equal for all variants does not count)
+    double min_c = evaluations[0].m_sd_results.m_total_compliance, max_c = min_c;
+    double min_e = evaluations[0].m_bp_results.m_total_energy, max_e = min_e;
+    for (unsigned int i = 1; i < evaluations.size(); i++)
+    {
+        min_c = std::min(min_c, evaluations[i].m_sd_results.m_total_compliance);
+        max_c = std::max(max_c, evaluations[i].m_sd_results.m_total_compliance);
+        min_e = std::min(min_e, evaluations[i].m_bp_results.m_total_energy);
+        max_e = std::max(max_e, evaluations[i].m_bp_results.m_total_energy);
+    }
+
+    unsigned int selected = 0;
+    double selected_score = 0;
+    for (unsigned int i = 0; i < evaluations.size(); i++)
+    {
+        double score = 0;
+        if (max_c > min_c) score += (evaluations[i].m_sd_results.m_total_compliance - min_c)/(max_c - min_c);
+        if (max_e > min_e) score += (evaluations[i].m_bp_results.m_total_energy - min_e)/(max_e - min_e);
+        if (i == 0 || score < selected_score)
+        {
+            selected = i;
+            selected_score = score;
+        }
+    }
+    return selected;
+} // select_design_variant()
+
+template<typename stream_type>
+void Opt_func_1(std::string input_file, unsigned int n_ite, Spatial_Design::Grammar_Ptr grammar, std::string output_file, stream_type &output, Evaluation_Cache* cache = nullptr,
+                unsigned int n_variants = 1, unsigned int n_threads = 0, unsigned int max_models = 0)
+{ // if a cache is given, designs that have been evaluated before are looked up in it instead of being analysed again;
+  // each iteration evaluates n_variants variants of the current design (at most max_design_variants, see design_variants()) in parallel
+  // and continues with the best one (see select_design_variant()), n_threads and max_models are passed on to evaluate_designs()
     std::vector<Spatial_Design::MS_Building> building_designs;
     std::vector<Structural_Design::SD_Building_Results> sd_results(n_ite+1);
     std::vector<Building_Physics::BP_Building_Results> bp_results(n_ite+1);
 
     // init MS-file
     building_designs.push_back(Spatial_Design::MS_Building(input_file.c_str()));
+    Design_Evaluation current = evaluate_designs(building_designs, grammar, n_threads, max_models, cache)[0];
 
     for (unsigned int i = 0; i < n_ite+1; i++)
     {
-        Spatial_Design::MS_Conformal CF(building_designs[i], grammar);
-        CF.make_conformal();
-
-        Structural_Design::SD_Analysis SD_building(CF);
-        SD_building.analyse();
-        sd_results[i] = SD_building.get_results();
-
-        SD_compliance_indexing(sd_results[i]);
-
-        Building_Physics::BP_Simulation BP_building(CF);
-        BP_building.sim_period();
-
-        bp_results[i] = BP_building.get_results();
-        BP_thermal_demand_indexing(bp_results[i]);
+        sd_results[i] = current.m_sd_results;
+        bp_results[i] = current.m_bp_results;
 
         if (i != n_ite)
-        {
-            building_designs.push_back(change_1_space(building_designs[i], bp_results[i], sd_results[i], 0));
+        { // the next design is the best variant of this one
+            std::vector<Spatial_Design::MS_Building> variants = design_variants(building_designs[i], bp_results[i], sd_results[i], n_variants);
+            std::vector<Design_Evaluation> evaluations = evaluate_designs(variants, grammar, n_threads, max_models, cache);
+            unsigned int selected = select_design_variant(evaluations);
+            building_designs.push_back(variants[selected]);
+            current = evaluations[selected];
         }
 
         output << i << " ";
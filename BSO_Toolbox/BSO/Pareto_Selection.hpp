@@ -4,20 +4,162 @@
 #include <BSO/Spatial_Design/Movable_Sizable.hpp>
 #include <BSO/Spatial_Design/Supercube.hpp>
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Field_Scanner.hpp>
 #include <BSO/Data.hpp>
 
 #include <Eigen/Dense>
-#include <boost/tokenizer.hpp>
-#include <boost/algorithm/string/trim.hpp>
 
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
 #include <map>
+#include <vector>
+#include <limits>
+#include <iterator>
+#include <algorithm>
 
 namespace BSO {
 
-data_point find_utopia_point(std::map<int, data_point> pareto_front);
+data_point find_utopia_point(const std::map<int, data_point>& pareto_front);
+
+/*
+ * Pareto_Front keeps the non-dominated points of a stream of points (objectives are
+ * minimised), so that a front can be selected from an archive without storing the archive.
+ * Each point has an ID (e.g. the position of its line in a file). Of equal points only the
+ * first is kept. With two objectives the front is a staircase ordered by the first
+ * objective, in which a point is checked and inserted in logarithmic time, with more
+ * objectives the front is searched linearly. The utopia point is tracked over all points.
+ */
+
+class Pareto_Front
+{
+private:
+    struct Front_Point
+    {
+        data_point m_point;
+        std::size_t m_ID;
+    };
+
+    unsigned int m_n_objectives;
+    std::map<double, Front_Point> m_staircase; // the front for 2 objectives, the second objective decreases along the first
+    std::vector<Front_Point> m_points; // the front for more objectives
+    data_point m_utopia_point;
+    std::size_t m_count; // the number of points that have been added
+public:
+    Pareto_Front(unsigned int n_objectives);
+
+    bool add(const data_point& point, std::size_t ID); // returns true if the point is not dominated by the current front
+    std::size_t size() const;
+    std::size_t count() const;
+    data_point get_utopia_point() const;
+    std::vector<std::pair<data_point, std::size_t> > get_front() const; // the points of the front and their IDs, ordered by ID
+    std::size_t find_closest_to(const data_point& O) const; // the ID of the point of the front closest to O (the first one if several are)
+}; // Pareto_Front
+
+Pareto_Front::Pareto_Front(unsigned int n_objectives)
+{
+    m_n_objectives = n_objectives;
+    m_utopia_point = data_point::Constant(n_objectives, std::numeric_limits<double>::infinity());
+    m_count = 0;
+} // ctor
+
+bool Pareto_Front::add(const data_point& point, std::size_t ID)
+{
+    m_count++;
+    m_utopia_point = m_utopia_point.cwiseMin(point);
+
+    if (m_n_objectives == 2)
+    {
+        auto it = m_staircase.upper_bound(point(0));
+        if (it != m_staircase.begin() && std::prev(it)->second.m_point(1) <= point(1))
+        { // the point with the largest first objective that is not larger has a second objective that is not larger either
+            return false;
+        }
+
+        // the points that are dominated by the new point follow it directly in the staircase
+        it = m_staircase.lower_bound(point(0));
+        while (it != m_staircase.end() && it->second.m_point(1) >= point(1))
+        {
+            it = m_staircase.erase(it);
+        }
+        m_staircase.insert(it, std::make_pair(point(0), Front_Point{point, ID}));
+        return true;
+    }
+
+    for (unsigned int i = 0; i < m_points.size(); i++)
+    { // check if a point of the front is not larger than the new point in each objective
+        if ((m_points[i].m_point.array() <= point.array()).all())
+        {
+            return false;
+        }
+    }
+
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < m_points.size(); i++)
+    { // remove the points that are dominated by the new point
+        if (!(point.array() <= m_points[i].m_point.array()).all())
+        {
+            m_points[n++] = m_points[i];
+        }
+    }
+    m_points.resize(n);
+    m_points.push_back(Front_Point{point, ID});
+    return true;
+} // add()
+
+std::size_t Pareto_Front::size() const
+{
+    return (m_n_objectives == 2) ? m_staircase.size() : m_points.size();
+} // size()
+
+std::size_t Pareto_Front::count() const
+{
+    return m_count;
+} // count()
+
+data_point Pareto_Front::get_utopia_point() const
+{
+    return m_utopia_point;
+} // get_utopia_point()
+
+std::vector<std::pair<data_point, std::size_t> > Pareto_Front::get_front() const
+{
+    std::vector<std::pair<data_point, std::size_t> > front;
+    for (auto it = m_staircase.begin(); it != m_staircase.end(); it++)
+    {
+        front.push_back(std::make_pair(it->second.m_point, it->second.m_ID));
+    }
+    for (unsigned int i = 0; i < m_points.size(); i++)
+    {
+        front.push_back(std::make_pair(m_points[i].m_point, m_points[i].m_ID));
+    }
+    std::sort(front.begin(), front.end(), [](const std::pair<data_point, std::size_t>& a, const std::pair<data_point, std::size_t>& b)
+              { return a.second < b.second; });
+    return front;
+} // get_front()
+
+std::size_t Pareto_Front::find_closest_to(const data_point& O) const
+{
+    std::vector<std::pair<data_point, std::size_t> > front = get_front();
+    if (front.empty())
+    {
+        std::cerr << "Error, looked for the closest point of an empty pareto front, exiting now... (Pareto_Selection.hpp)" << std::endl;
+        exit(1);
+    }
+
+    unsigned int min_index = 0;
+    double min = (front[0].first - O).squaredNorm();
+    for (unsigned int i = 1; i < front.size(); i++)
+    {
+        double dist = (front[i].first - O).squaredNorm();
+        if (dist < min)
+        {
+            min_index = i;
+            min = dist;
+        }
+    }
+    return front[min_index].second;
+} // find_closest_to()
 
 enum class p_front_selection
 {
@@ -28,11 +170,9 @@ enum class p_front_selection
 std::vector<Spatial_Design::MS_Building> pareto_selection(std::string file_name, unsigned int n_disciplines, p_front_selection select_option)
 {
     std::vector<Spatial_Design::MS_Building> selected_designs;
-    std::map<int, data_point> SC_output;
-    std::map<int, data_point>::iterator SC_it;
 
     // start reading in the pareto front data points
-    std::ifstream input(file_name.c_str());
+    Field_Scanner input(file_name, "\t; "); // reads the file, fields are separated by tabs, semicolons and spaces
 
     if (!input.is_open())
     {
@@ -40,67 +180,48 @@ std::vector<Spatial_Design::MS_Building> pareto_selection(std::string file_name,
         exit(1);
     }
 
-    unsigned int file_ptr;
-    std::string line; // will hold the next line in the file
-    boost::char_separator<char> sep("\t; "); // defines what separates tokens in a string
-    typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
-
-    while(!input.eof())
-    { // read in all the data points
-        file_ptr = input.tellg(); // safes the location of this line
-        getline(input, line); // get the next line from the file
-        boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
-        if (line == "") //skip empty lines (tokenizer does not like it)
-        {
-            continue; // continue to next line
-        }
-
-        t_tokenizer tok(line, sep); // tokenize the line
-        t_tokenizer::iterator token = tok.begin(); // set iterator to first token
+    if (select_option != p_front_selection::KNEE_POINT && select_option != p_front_selection::CLOSEST_TO_ZERO)
+    { // if no selection method has been selected
+        std::cerr << "ERROR in Pareto_Selection.hpp: no selection method found, exiting now" << std::endl;
+        exit(1);
+    }
 
-        // initialise the data point
-        data_point d_point = Eigen::VectorXd(n_disciplines);
-        token++; // skip the stamp
+    // the point closest to the utopia point lies on the pareto front, so only the front is kept while reading,
+    // the point closest to the origin need not (if objectives can be negative), so it is tracked separately
+    Pareto_Front front(n_disciplines);
+    data_point d_point = Eigen::VectorXd(n_disciplines);
+    double min_dist = std::numeric_limits<double>::infinity();
+    std::size_t selected_point_ptr = 0;
 
+    while (input.next_line())
+    { // read in all the data points, empty lines are skipped
         for (unsigned int i = 0; i < n_disciplines; i++)
-        { // for each disciplinary performance
-            d_point[i] = trim_and_cast_double(*token);
-            token++;
+        { // for each disciplinary performance (after the stamp)
+            d_point[i] = input.get_double(i + 1);
         }
 
-        SC_output[file_ptr] = d_point;
+        if (select_option == p_front_selection::KNEE_POINT)
+        {
+            front.add(d_point, input.line_offset()); // the location of this line
+        }
+        else if (d_point.squaredNorm() < min_dist)
+        { // closest to the origin so far
+            min_dist = d_point.squaredNorm();
+            selected_point_ptr = input.line_offset();
+        }
     }
 
-    // initialise what distance function is used to select the design
-    dist_function d_func; // default euclidian;
-
-    // find the desired point in the pareto front
-    data_point closest_to_this;
     if (select_option == p_front_selection::KNEE_POINT)
-    { // if the knee point should be selected
-        closest_to_this = find_utopia_point(SC_output); // this is the utopia point
-    }
-    else if (select_option == p_front_selection::CLOSEST_TO_ZERO)
-    { // if the point closest to the origin should be selected
-        closest_to_this = Eigen::VectorXd::Zero(n_disciplines); // this is the origin
-    }
-    else
-    { // if no selection method has been selected
-        std::cerr << "ERROR in Pareto_Selection.hpp: no selection method found, exiting now" << std::endl;
-        exit(1);
+    { // select the point closest to the utopia point
+        selected_point_ptr = front.find_closest_to(front.get_utopia_point());
     }
 
-
-    unsigned int selected_point_ptr = BSO::find_closest_to(SC_output, closest_to_this, d_func)->first;
-
-    // retrieve the design that has been selected from the pareto front from "file_name"
-    input.close();
-    input = std::ifstream(file_name.c_str());
-    input.seekg(selected_point_ptr);
-    getline(input, line);
+    // retrieve the design that has been selected from the pareto front
+    input.seek_line(selected_point_ptr);
+    input.next_line();
+    std::string line = input.get_line(); // without white space at its start and end
 
     // remove the data that is not needed from the string
-    boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
     unsigned int split_index = 0;
     unsigned int delim_count = 0;
 
@@ -119,7 +240,6 @@ std::vector<Spatial_Design::MS_Building> pareto_selection(std::string file_name,
     }
 
     line.erase(line.begin(), line.begin()+split_index);
-    input.close();
 
     // initialise the design that has been selected into MS format
     BSO::Spatial_Design::SC_Building SC(line,1);
@@ -128,9 +248,9 @@ std::vector<Spatial_Design::MS_Building> pareto_selection(std::string file_name,
     return selected_designs;
 } // pareto_selection()
 
-data_point find_utopia_point(std::map<int, BSO::data_point> pareto_front)
+data_point find_utopia_point(const std::map<int, BSO::data_point>& pareto_front)
 {
-    std::map<int, BSO::data_point>::iterator it = pareto_front.begin();
+    std::map<int, BSO::data_point>::const_iterator it = pareto_front.begin();
     BSO::data_point utopia_point = it->second;
     it++;
 
@@ -2,6 +2,7 @@
 #define PERFORMANCE_INDEXING_HPP
 
 #include <iostream>
+#include <cstdlib>
 
 #ifdef BP_SIMULATION_HPP
 #include <BSO/Building_Physics/BP_Results.hpp>
@@ -55,6 +56,12 @@ namespace BSO {
 	#ifdef SD_ANALYSIS_HPP
     void SD_removed_mass_indexing(Structural_Design::SD_Building_Results& SD)
     {
+        if (SD.m_partial)
+        {
+            std::cerr << "Error, removed mass indexing needs the element results, which partial SD results (e.g. from an evaluation cache) do not have, exiting now... (Performance_Indexing.hpp)" << std::endl;
+            exit(1);
+        }
+
         double sum_volume; // sum of element volumes encountered in a space so far
         double element_volume; // temp container for element volume
         double sum_reduced_volume; // sum of reduced (density) element volumes encountered in a space so far
@@ -117,6 +124,12 @@ namespace BSO {
 	#ifdef SD_ANALYSIS_HPP
     void SD_removed_element_indexing(Structural_Design::SD_Building_Results& SD, unsigned int n)
     {
+        if (SD.m_partial)
+        {
+            std::cerr << "Error, removed element indexing needs the element results, which partial SD results (e.g. from an evaluation cache) do not have, exiting now... (Performance_Indexing.hpp)" << std::endl;
+            exit(1);
+        }
+
         // remove first 'n' element clusters
         SD.delete_clusters(n);
 
@@ -0,0 +1,279 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+/*
+ * Instrumentation of the hot paths of the toolbox: scoped timers, counters and histograms.
+ * The instrumentation is only compiled in if BSO_PROFILING is defined (e.g. -DBSO_PROFILING),
+ * otherwise the macros below expand to nothing and their arguments are not evaluated.
+ *
+ * BSO_PROFILE_SCOPE(name)          times the enclosing scope, nested scopes form a call tree
+ * BSO_PROFILE_COUNT(name, n)       adds n to a counter
+ * BSO_PROFILE_SAMPLE(name, value)  adds a value to a histogram (buckets of powers of two)
+ *
+ * At exit the call tree is written to the file given by the environment variable BSO_PROFILE
+ * (default "bso_profile.folded") as folded stacks, i.e. one line "scope;inner scope;... <us>"
+ * per call path with its self time in microseconds, which is the input of flamegraph.pl.
+ * The calls, total and self times of the call tree, the counters and the histograms are
+ * written as text to the same file name with ".txt" appended.
+ *
+ * Each thread keeps its own stack of open scopes, so scopes opened in a worker thread
+ * start at the root of the call tree instead of below the scope that started the thread.
+ */
+
+#ifdef BSO_PROFILING
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+
+namespace BSO { namespace Profiler
+{
+
+    struct Profile_Node
+    { // a scope in the call tree, identified by its name and the path of scopes above it
+        std::string m_name;
+        Profile_Node* m_parent;
+        std::map<std::string, Profile_Node*> m_children;
+        unsigned long long m_calls = 0;
+        double m_total_us = 0; // including the time spent in the children
+    }; // Profile_Node
+
+    struct Histogram
+    {
+        unsigned long long m_count = 0;
+        double m_sum = 0;
+        double m_min = 0;
+        double m_max = 0;
+        std::vector<unsigned long long> m_buckets; // bucket 0 holds the values below 1, bucket i those in [2^(i-1), 2^i)
+    }; // Histogram
+
+    class Profile
+    {
+    private:
+        std::mutex m_mutex;
+        Profile_Node m_root;
+        std::map<std::string, unsigned long long> m_counters;
+        std::map<std::string, Histogram> m_histograms;
+
+        void delete_children(Profile_Node* node);
+        void write_folded(std::ostream& output, Profile_Node* node, std::string path);
+        void write_tree(std::ostream& output, Profile_Node* node, unsigned int depth);
+    public:
+        Profile();
+        ~Profile(); // writes the report
+
+        Profile_Node* enter(Profile_Node* parent, const char* name);
+        void leave(Profile_Node* node, double us);
+        void count(const char* name, unsigned long long n);
+        void sample(const char* name, double value);
+        void write_report(std::string file_name);
+    }; // Profile
+
+    Profile::Profile()
+    {
+        m_root.m_name = "root";
+        m_root.m_parent = nullptr;
+    } // ctor
+
+    Profile::~Profile()
+    {
+        const char* file_name = std::getenv("BSO_PROFILE");
+        write_report((file_name != nullptr) ? file_name : "bso_profile.folded");
+        delete_children(&m_root);
+    } // dtor
+
+    void Profile::delete_children(Profile_Node* node)
+    {
+        for (auto child : node->m_children)
+        {
+            delete_children(child.second);
+            delete child.second;
+        }
+        node->m_children.clear();
+    } // delete_children()
+
+    Profile_Node* Profile::enter(Profile_Node* parent, const char* name)
+    { // returns the node of scope 'name' below parent (the root if parent is a null pointer)
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (parent == nullptr)
+        {
+            parent = &m_root;
+        }
+        Profile_Node*& node = parent->m_children[name];
+        if (node == nullptr)
+        {
+            node = new Profile_Node;
+            node->m_name = name;
+            node->m_parent = parent;
+        }
+        return node;
+    } // enter()
+
+    void Profile::leave(Profile_Node* node, double us)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        node->m_calls++;
+        node->m_total_us += us;
+    } // leave()
+
+    void Profile::count(const char* name, unsigned long long n)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_counters[name] += n;
+    } // count()
+
+    void Profile::sample(const char* name, double value)
+    {
+        unsigned int bucket = 0;
+        for (double bound = 1; value >= bound && bucket < 64; bound *= 2)
+        {
+            bucket++;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Histogram& histogram = m_histograms[name];
+        if (histogram.m_count == 0 || value < histogram.m_min) histogram.m_min = value;
+        if (histogram.m_count == 0 || value > histogram.m_max) histogram.m_max = value;
+        histogram.m_count++;
+        histogram.m_sum += value;
+        if (histogram.m_buckets.size() <= bucket)
+        {
+            histogram.m_buckets.resize(bucket + 1, 0);
+        }
+        histogram.m_buckets[bucket]++;
+    } // sample()
+
+    void Profile::write_folded(std::ostream& output, Profile_Node* node, std::string path)
+    { // one line per node with its self time, the children follow their parent
+        double self_us = node->m_total_us;
+        for (auto child : node->m_children)
+        {
+            self_us -= child.second->m_total_us;
+        }
+        if (node != &m_root && self_us >= 1)
+        {
+            output << path << " " << (unsigned long long)self_us << std::endl;
+        }
+
+        for (auto child : node->m_children)
+        {
+            write_folded(output, child.second, (node == &m_root) ? child.first : path + ";" + child.first);
+        }
+    } // write_folded()
+
+    void Profile::write_tree(std::ostream& output, Profile_Node* node, unsigned int depth)
+    {
+        double self_us = node->m_total_us;
+        for (auto child : node->m_children)
+        {
+            self_us -= child.second->m_total_us;
+        }
+        output << std::string(2*depth, ' ') << node->m_name
+               << "  calls: " << node->m_calls
+               << "  total: " << node->m_total_us/1000 << " ms"
+               << "  self: " << self_us/1000 << " ms" << std::endl;
+
+        for (auto child : node->m_children)
+        {
+            write_tree(output, child.second, depth + 1);
+        }
+    } // write_tree()
+
+    void Profile::write_report(std::string file_name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::ofstream folded(file_name.c_str());
+        std::ofstream text((file_name + ".txt").c_str());
+        if (!folded || !text)
+        {
+            std::cerr << "Error, could not write profile \"" << file_name << "\" (Profiler.hpp)" << std::endl;
+            return;
+        }
+
+        write_folded(folded, &m_root, "");
+
+        text << std::fixed << std::setprecision(3);
+        text << "Scopes:" << std::endl;
+        for (auto child : m_root.m_children)
+        {
+            write_tree(text, child.second, 1);
+        }
+
+        text << std::endl << "Counters:" << std::endl;
+        for (auto counter : m_counters)
+        {
+            text << "  " << counter.first << ": " << counter.second << std::endl;
+        }
+
+        text << std::endl << "Histograms:" << std::endl;
+        for (auto& histogram : m_histograms)
+        {
+            const Histogram& h = histogram.second;
+            text << "  " << histogram.first << "  count: " << h.m_count << "  mean: " << h.m_sum/h.m_count
+                 << "  min: " << h.m_min << "  max: " << h.m_max << std::endl;
+            for (unsigned int i = 0; i < h.m_buckets.size(); i++)
+            {
+                if (h.m_buckets[i] == 0) continue;
+                text << "    [" << ((i == 0) ? 0.0 : std::ldexp(1.0, i - 1)) << ", " << std::ldexp(1.0, i) << "): "
+                     << h.m_buckets[i] << std::endl;
+            }
+        }
+    } // write_report()
+
+    Profile& profile()
+    { // the profile of this process, written when the process exits
+        static Profile process_profile;
+        return process_profile;
+    } // profile()
+
+    thread_local Profile_Node* current_scope = nullptr; // the innermost open scope of this thread, null at the root
+
+    class Scoped_Timer
+    {
+    private:
+        Profile_Node* m_node;
+        Profile_Node* m_parent;
+        std::chrono::steady_clock::time_point m_start;
+    public:
+        Scoped_Timer(const char* name)
+        {
+            m_parent = current_scope;
+            m_node = profile().enter(m_parent, name);
+            current_scope = m_node;
+            m_start = std::chrono::steady_clock::now();
+        } // ctor
+
+        ~Scoped_Timer()
+        {
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            profile().leave(m_node, std::chrono::duration<double, std::micro>(end - m_start).count());
+            current_scope = m_parent;
+        } // dtor
+    }; // Scoped_Timer
+
+} // namespace Profiler
+} // namespace BSO
+
+#define BSO_PROFILE_CONCAT_(a, b) a##b
+#define BSO_PROFILE_CONCAT(a, b) BSO_PROFILE_CONCAT_(a, b)
+#define BSO_PROFILE_SCOPE(name) BSO::Profiler::Scoped_Timer BSO_PROFILE_CONCAT(bso_profile_scope_, __LINE__)(name)
+#define BSO_PROFILE_COUNT(name, n) BSO::Profiler::profile().count(name, n)
+#define BSO_PROFILE_SAMPLE(name, value) BSO::Profiler::profile().sample(name, value)
+
+#else
+
+#define BSO_PROFILE_SCOPE(name)
+#define BSO_PROFILE_COUNT(name, n)
+#define BSO_PROFILE_SAMPLE(name, value)
+
+#endif // BSO_PROFILING
+
+#endif // PROFILER_HPP
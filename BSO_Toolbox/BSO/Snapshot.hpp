@@ -0,0 +1,333 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+namespace BSO
+{
+
+    /*
+     * A snapshot is a binary file that holds one or more models (e.g. a conformal
+     * model and the structural model made from it), so that they can be loaded again
+     * without repeating the steps that created them. The file starts with the magic
+     * "BSO_SNAP" and the version, after which each model writes a section that starts
+     * with a tag of four characters. Objects refer to each other by their index in the
+     * snapshot, the pointers are restored after all objects of a model have been created.
+     *
+     * Values are written in the byte order of the machine, so a snapshot is meant to be
+     * loaded on the machine (or the same kind of machine) that wrote it.
+     */
+
+    const char snapshot_magic[8] = {'B','S','O','_','S','N','A','P'};
+    const uint32_t snapshot_version = 2;
+    const uint32_t snapshot_null_index = 0xFFFFFFFF; // the index of a null pointer
+
+    // Class definitions
+
+    class Snapshot_Writer
+    {
+    private:
+        std::string m_file_name;
+        std::ofstream m_stream;
+    public:
+        Snapshot_Writer(std::string file_name);
+        ~Snapshot_Writer();
+
+        void write_tag(const char* tag); // starts a section, tag holds four characters
+        template<typename T> void write(const T& value);
+        template<typename T> void write_vector(const std::vector<T>& values);
+        void write_string(const std::string& s);
+        void write_index(uint32_t index);
+        void close();
+    }; // Snapshot_Writer
+
+    class Snapshot_Reader
+    {
+    private:
+        std::string m_file_name;
+        std::string m_buffer; // the contents of the file
+        std::size_t m_position;
+        bool m_exit_on_error;
+        bool m_failed;
+
+        void fail(const std::string& message);
+        bool check_size(std::size_t n);
+    public:
+        Snapshot_Reader(std::string file_name, bool exit_on_error = true); // if exit_on_error is false, an unreadable file only sets failed()
+
+        void expect_tag(const char* tag); // checks that the next section has this tag
+        template<typename T> T read();
+        uint32_t read_count(std::size_t element_size); // reads the number of elements that follow, each takes at least element_size bytes
+        template<typename T> std::vector<T> read_vector();
+        std::string read_string();
+        uint32_t read_index();
+        bool at_end();
+        bool failed(); // true if the file could not be read, the values read since are zero or empty
+    }; // Snapshot_Reader
+
+
+    // Implementation of member functions:
+
+    Snapshot_Writer::Snapshot_Writer(std::string file_name)
+    {
+        m_file_name = file_name;
+        m_stream.open(file_name.c_str(), std::ios::binary);
+        if (!m_stream)
+        {
+            std::cerr << "Error, could not open snapshot file \"" << file_name << "\", exiting now... (Snapshot.hpp)" << std::endl;
+            exit(1);
+        }
+        m_stream.write(snapshot_magic, sizeof(snapshot_magic));
+        write(snapshot_version);
+    } // ctor
+
+    Snapshot_Writer::~Snapshot_Writer()
+    {
+        close();
+    } // dtor
+
+    void Snapshot_Writer::write_tag(const char* tag)
+    {
+        m_stream.write(tag, 4);
+    } // write_tag()
+
+    template<typename T>
+    void Snapshot_Writer::write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only values that can be copied byte by byte are written directly");
+        m_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    } // write()
+
+    template<typename T>
+    void Snapshot_Writer::write_vector(const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only values that can be copied byte by byte are written directly");
+        write((uint32_t)values.size());
+        if (!values.empty())
+        {
+            m_stream.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
+        }
+    } // write_vector()
+
+    void Snapshot_Writer::write_string(const std::string& s)
+    {
+        write((uint32_t)s.size());
+        m_stream.write(s.data(), s.size());
+    } // write_string()
+
+    void Snapshot_Writer::write_index(uint32_t index)
+    {
+        write(index);
+    } // write_index()
+
+    void Snapshot_Writer::close()
+    {
+        if (!m_stream.is_open()) return;
+        m_stream.close();
+        if (m_stream.fail())
+        {
+            std::cerr << "Error, could not write snapshot file \"" << m_file_name << "\", exiting now... (Snapshot.hpp)" << std::endl;
+            exit(1);
+        }
+    } // close()
+
+    Snapshot_Reader::Snapshot_Reader(std::string file_name, bool exit_on_error)
+    {
+        m_file_name = file_name;
+        m_position = 0;
+        m_exit_on_error = exit_on_error;
+        m_failed = false;
+        std::ifstream input(file_name.c_str(), std::ios::binary);
+        if (!input.is_open())
+        {
+            fail("could not open snapshot file \"" + file_name + "\"");
+            return;
+        }
+        // read the file in one block, the models are created from this buffer
+        input.seekg(0, std::ios::end);
+        m_buffer.resize((std::size_t)input.tellg());
+        input.seekg(0, std::ios::beg);
+        input.read(&m_buffer[0], m_buffer.size());
+
+        if (!input || m_buffer.size() < sizeof(snapshot_magic) || std::memcmp(m_buffer.data(), snapshot_magic, sizeof(snapshot_magic)) != 0)
+        {
+            fail("\"" + file_name + "\" is not a snapshot file");
+            return;
+        }
+        m_position = sizeof(snapshot_magic);
+        uint32_t version = read<uint32_t>();
+        if (!m_failed && version != snapshot_version)
+        {
+            fail("snapshot file \"" + file_name + "\" has version " + std::to_string(version) + " but version "
+                 + std::to_string(snapshot_version) + " is expected");
+        }
+    } // ctor
+
+    void Snapshot_Reader::fail(const std::string& message)
+    {
+        if (m_exit_on_error)
+        {
+            std::cerr << "Error, " << message << ", exiting now... (Snapshot.hpp)" << std::endl;
+            exit(1);
+        }
+        m_failed = true;
+    } // fail()
+
+    bool Snapshot_Reader::check_size(std::size_t n)
+    {
+        if (m_failed) return false;
+        if (m_buffer.size() - m_position < n)
+        {
+            fail("snapshot file \"" + m_file_name + "\" ends unexpectedly");
+            return false;
+        }
+        return true;
+    } // check_size()
+
+    void Snapshot_Reader::expect_tag(const char* tag)
+    {
+        if (!check_size(4)) return;
+        if (std::memcmp(m_buffer.data() + m_position, tag, 4) != 0)
+        {
+            fail("expected section \"" + std::string(tag, 4) + "\" in snapshot file \"" + m_file_name
+                 + "\" but found \"" + std::string(m_buffer.data() + m_position, 4) + "\"");
+            return;
+        }
+        m_position += 4;
+    } // expect_tag()
+
+    template<typename T>
+    T Snapshot_Reader::read()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only values that can be copied byte by byte are read directly");
+        T value = T();
+        if (!check_size(sizeof(T))) return value;
+        std::memcpy(&value, m_buffer.data() + m_position, sizeof(T));
+        m_position += sizeof(T);
+        return value;
+    } // read()
+
+    uint32_t Snapshot_Reader::read_count(std::size_t element_size)
+    { // a count that does not fit in the rest of the file is an error, so that no vector is sized from a damaged count
+        uint32_t count = read<uint32_t>();
+        if (!check_size((std::size_t)count*element_size)) return 0;
+        return count;
+    } // read_count()
+
+    template<typename T>
+    std::vector<T> Snapshot_Reader::read_vector()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only values that can be copied byte by byte are read directly");
+        uint32_t size = read_count(sizeof(T));
+        std::vector<T> values(size);
+        if (size > 0)
+        {
+            std::memcpy(values.data(), m_buffer.data() + m_position, size*sizeof(T));
+        }
+        m_position += size*sizeof(T);
+        return values;
+    } // read_vector()
+
+    std::string Snapshot_Reader::read_string()
+    {
+        uint32_t size = read_count(1);
+        std::string s(m_buffer.data() + m_position, size);
+        m_position += size;
+        return s;
+    } // read_string()
+
+    uint32_t Snapshot_Reader::read_index()
+    {
+        return read<uint32_t>();
+    } // read_index()
+
+    bool Snapshot_Reader::at_end()
+    {
+        return !m_failed && m_position == m_buffer.size();
+    } // at_end()
+
+    bool Snapshot_Reader::failed()
+    {
+        return m_failed;
+    } // failed()
+
+
+    // Functions to write and read pointers as the index of the object in a vector of objects:
+
+    template<typename T>
+    std::map<T*, uint32_t> snapshot_indices(const std::vector<T*>& objects)
+    { // the index of each object in the snapshot
+        std::map<T*, uint32_t> indices;
+        for (unsigned int i = 0; i < objects.size(); i++)
+        {
+            indices[objects[i]] = i;
+        }
+        return indices;
+    } // snapshot_indices()
+
+    template<typename T>
+    void write_snapshot_pointers(Snapshot_Writer& snapshot, std::map<T*, uint32_t>& indices, T* const* pointers, unsigned int n)
+    { // writes the indices of n pointers, a pointer to an object that is not in the snapshot is an error
+        for (unsigned int i = 0; i < n; i++)
+        {
+            if (pointers[i] == nullptr)
+            {
+                snapshot.write_index(snapshot_null_index);
+                continue;
+            }
+            typename std::map<T*, uint32_t>::iterator ite = indices.find(pointers[i]);
+            if (ite == indices.end())
+            {
+                std::cerr << "Error, cannot write a snapshot of a pointer to an object that is not in the snapshot, exiting now... (Snapshot.hpp)" << std::endl;
+                exit(1);
+            }
+            snapshot.write_index(ite->second);
+        }
+    } // write_snapshot_pointers()
+
+    template<typename T>
+    void write_snapshot_pointers(Snapshot_Writer& snapshot, std::map<T*, uint32_t>& indices, const std::vector<T*>& pointers)
+    { // writes the number of pointers and their indices
+        snapshot.write((uint32_t)pointers.size());
+        write_snapshot_pointers(snapshot, indices, pointers.data(), pointers.size());
+    } // write_snapshot_pointers()
+
+    template<typename T>
+    T* read_snapshot_pointer(Snapshot_Reader& snapshot, const std::vector<T*>& objects)
+    { // reads an index and returns the restored object at that index
+        uint32_t index = snapshot.read_index();
+        if (index == snapshot_null_index)
+        {
+            return nullptr;
+        }
+        if (index >= objects.size())
+        {
+            std::cerr << "Error, snapshot refers to object " << index << " of " << objects.size()
+                      << ", exiting now... (Snapshot.hpp)" << std::endl;
+            exit(1);
+        }
+        return objects[index];
+    } // read_snapshot_pointer()
+
+    template<typename T>
+    std::vector<T*> read_snapshot_pointers(Snapshot_Reader& snapshot, const std::vector<T*>& objects)
+    { // reads the number of pointers and their indices
+        std::vector<T*> pointers(snapshot.read_count(sizeof(uint32_t)));
+        for (unsigned int i = 0; i < pointers.size(); i++)
+        {
+            pointers[i] = read_snapshot_pointer(snapshot, objects);
+        }
+        return pointers;
+    } // read_snapshot_pointers()
+
+} // namespace BSO
+
+#endif // SNAPSHOT_HPP
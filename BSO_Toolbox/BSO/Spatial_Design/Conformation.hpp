@@ -2,6 +2,8 @@
 #define MS_CONFORMAL_HPP
 
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Snapshot.hpp>
+#include <BSO/Profiler.hpp>
 #include <BSO/Spatial_Design/Movable_Sizable.hpp> //ms_building en of niet ms_space
 #include <BSO/Spatial_Design/Geometry/Geometry.hpp> //cf_buildin en miss geometry from utilities
 
@@ -55,8 +57,11 @@ private:
 public:
     MS_Conformal(std::string file_name, Grammar_Ptr);
     MS_Conformal(MS_Building&, Grammar_Ptr);
+    MS_Conformal(Snapshot_Reader&, Grammar_Ptr); // restores a model written by write_snapshot()
     ~MS_Conformal();
 
+    void write_snapshot(Snapshot_Writer&);
+
     void add_grammars(BP_Grammar_Ptr, SD_Grammar_Ptr);
     void add_grammars(BP_Grammar_Ptr);
     void add_grammars(SD_Grammar_Ptr);
@@ -196,6 +201,7 @@ SD_Grammar_Ptr MS_Conformal::request_SD_grammar()
 
 void MS_Conformal::make_conformal()
 {
+    BSO_PROFILE_SCOPE("MS_Conformal::make_conformal");
     // check for intersections
     Geometry::Vertex* temp_ptr = new Geometry::Vertex; // to store possible intersection points
     for (unsigned int i = 0; i < m_rectangles.size(); i++) // check line-rectangle intersections
@@ -527,4 +533,6 @@ unsigned int MS_Conformal::get_vertex_count()
 } // namespace Spatial_Design
 } // namespace BSO
 
+#include <BSO/Spatial_Design/Conformation_Snapshot.cpp>
+
 #endif // MS_CONFORMAL_HPP
@@ -0,0 +1,322 @@
+#ifndef MS_CONFORMAL_SNAPSHOT_CPP
+#define MS_CONFORMAL_SNAPSHOT_CPP
+
+/*
+ * Writing and restoring a conformal model in a snapshot (see BSO/Snapshot.hpp).
+ * The section holds the geometry in two parts: first each object with the objects
+ * it is made of (so that it can be created from objects that are already restored),
+ * then the associations between the objects and the types and tags that grammars
+ * and zoning assigned to them. Included by Conformation.hpp.
+ */
+
+namespace BSO { namespace Spatial_Design {
+
+void write_snapshot_coords(Snapshot_Writer& snapshot, const Eigen::Vector3d& coords)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        snapshot.write(coords(i));
+    }
+} // write_snapshot_coords()
+
+Eigen::Vector3d read_snapshot_coords(Snapshot_Reader& snapshot)
+{
+    Eigen::Vector3d coords;
+    for (int i = 0; i < 3; i++)
+    {
+        coords(i) = snapshot.read<double>();
+    }
+    return coords;
+} // read_snapshot_coords()
+
+void MS_Conformal::write_snapshot(Snapshot_Writer& snapshot)
+{
+    using namespace Geometry;
+    std::map<Vertex*, uint32_t> vertex_indices = snapshot_indices(m_vertices);
+    std::map<Line*, uint32_t> line_indices = snapshot_indices(m_lines);
+    std::map<Rectangle*, uint32_t> rectangle_indices = snapshot_indices(m_rectangles);
+    std::map<Cuboid*, uint32_t> cuboid_indices = snapshot_indices(m_cubes);
+    std::map<Point*, uint32_t> point_indices = snapshot_indices(m_points);
+    std::map<Edge*, uint32_t> edge_indices = snapshot_indices(m_edges);
+    std::map<Surface*, uint32_t> surface_indices = snapshot_indices(m_surfaces);
+    std::map<Space*, uint32_t> space_indices = snapshot_indices(m_spaces);
+
+    snapshot.write_tag("MSCF");
+    snapshot.write((uint32_t)m_vertices.size());
+    snapshot.write((uint32_t)m_lines.size());
+    snapshot.write((uint32_t)m_rectangles.size());
+    snapshot.write((uint32_t)m_cubes.size());
+    snapshot.write((uint32_t)m_points.size());
+    snapshot.write((uint32_t)m_edges.size());
+    snapshot.write((uint32_t)m_surfaces.size());
+    snapshot.write((uint32_t)m_spaces.size());
+
+    // the objects, each with the objects it is made of
+    for (auto v : m_vertices)
+    {
+        write_snapshot_coords(snapshot, v->m_coords);
+        snapshot.write(v->m_structural);
+        snapshot.write(v->zoned);
+    }
+    for (auto l : m_lines)
+    {
+        write_snapshot_pointers(snapshot, vertex_indices, l->m_vertices, 2);
+        write_snapshot_coords(snapshot, l->m_center_vertex.m_coords);
+        snapshot.write(l->m_deletion);
+        snapshot.write(l->m_structural);
+        snapshot.write(l->zoned);
+        snapshot.write(l->constraint);
+        snapshot.write(l->thickness);
+    }
+    for (auto r : m_rectangles)
+    {
+        write_snapshot_pointers(snapshot, line_indices, r->m_lines, 4);
+        write_snapshot_pointers(snapshot, vertex_indices, r->m_vertices, 4);
+        write_snapshot_coords(snapshot, r->m_normal_vector);
+        write_snapshot_coords(snapshot, r->m_center_vertex.m_coords);
+        snapshot.write(r->m_deletion);
+        snapshot.write(r->m_structural);
+        snapshot.write(r->m_lines_associated);
+        snapshot.write(r->zoned);
+        snapshot.write(r->horizontal);
+        snapshot.write(r->thickness);
+        snapshot.write(r->loading);
+    }
+    for (auto c : m_cubes)
+    {
+        write_snapshot_pointers(snapshot, rectangle_indices, c->m_rectangles, 6);
+        write_snapshot_pointers(snapshot, line_indices, c->m_lines, 12);
+        write_snapshot_pointers(snapshot, vertex_indices, c->m_vertices, 8);
+        write_snapshot_coords(snapshot, c->m_center_vertex.m_coords);
+        snapshot.write(c->m_deletion);
+        snapshot.write(c->ID);
+        snapshot.write_vector(c->zone_IDs);
+    }
+    for (auto p : m_points)
+    {
+        write_snapshot_pointers(snapshot, vertex_indices, &p->m_vertex, 1);
+    }
+    for (auto e : m_edges)
+    {
+        write_snapshot_pointers(snapshot, line_indices, e->m_lines.data(), 1); // the initial line
+        write_snapshot_pointers(snapshot, point_indices, e->m_points, 2);
+    }
+    for (auto s : m_surfaces)
+    {
+        write_snapshot_pointers(snapshot, rectangle_indices, s->m_rectangles.data(), 1); // the initial rectangle
+        write_snapshot_pointers(snapshot, edge_indices, s->m_edges, 4);
+    }
+    for (auto s : m_spaces)
+    {
+        snapshot.write(s->m_space_ID);
+        write_snapshot_pointers(snapshot, cuboid_indices, s->m_cuboids.data(), 1); // the initial cuboid
+        write_snapshot_pointers(snapshot, surface_indices, s->m_surfaces, 6);
+    }
+
+    // the associations between the objects and the assigned types
+    for (auto v : m_vertices)
+    {
+        write_snapshot_pointers(snapshot, point_indices, v->m_points);
+    }
+    for (auto l : m_lines)
+    {
+        write_snapshot_pointers(snapshot, edge_indices, l->m_edges);
+        write_snapshot_pointers(snapshot, rectangle_indices, l->m_rectangle_ptrs);
+    }
+    for (auto r : m_rectangles)
+    {
+        write_snapshot_pointers(snapshot, surface_indices, r->m_surfaces);
+    }
+    for (auto c : m_cubes)
+    {
+        write_snapshot_pointers(snapshot, space_indices, c->m_spaces);
+    }
+    for (auto p : m_points)
+    {
+        write_snapshot_pointers(snapshot, edge_indices, p->m_edge_ptrs);
+        write_snapshot_pointers(snapshot, surface_indices, p->m_surface_ptrs);
+        write_snapshot_pointers(snapshot, space_indices, p->m_space_ptrs);
+    }
+    for (auto e : m_edges)
+    {
+        write_snapshot_pointers(snapshot, line_indices, e->m_lines);
+        write_snapshot_pointers(snapshot, vertex_indices, e->m_vertices);
+        write_snapshot_pointers(snapshot, surface_indices, e->m_surface_ptrs);
+        write_snapshot_pointers(snapshot, space_indices, e->m_space_ptrs);
+        snapshot.write_string(e->m_edge_type);
+    }
+    for (auto s : m_surfaces)
+    {
+        write_snapshot_pointers(snapshot, rectangle_indices, s->m_rectangles);
+        write_snapshot_pointers(snapshot, vertex_indices, s->m_vertices);
+        write_snapshot_pointers(snapshot, space_indices, s->m_space_ptrs);
+        snapshot.write((uint32_t)s->m_facing.size());
+        for (unsigned int i = 0; i < s->m_facing.size(); i++)
+        {
+            snapshot.write(s->m_facing[i].first);
+            snapshot.write(s->m_facing[i].second);
+        }
+        snapshot.write_string(s->m_surface_type);
+    }
+    for (auto s : m_spaces)
+    {
+        write_snapshot_pointers(snapshot, cuboid_indices, s->m_cuboids);
+        write_snapshot_pointers(snapshot, vertex_indices, s->m_vertices);
+        snapshot.write_vector(s->m_cuboid_IDs);
+        write_snapshot_pointers(snapshot, edge_indices, s->m_edges, 12);
+        write_snapshot_pointers(snapshot, point_indices, s->m_points, 8);
+        snapshot.write_string(s->m_space_type);
+    }
+} // write_snapshot()
+
+MS_Conformal::MS_Conformal(Snapshot_Reader& snapshot, Grammar_Ptr grammar)
+{
+    using namespace Geometry;
+    snapshot.expect_tag("MSCF");
+    m_vertices.resize(snapshot.read_count(1));
+    m_lines.resize(snapshot.read_count(1));
+    m_rectangles.resize(snapshot.read_count(1));
+    m_cubes.resize(snapshot.read_count(1));
+    m_points.resize(snapshot.read_count(1));
+    m_edges.resize(snapshot.read_count(1));
+    m_surfaces.resize(snapshot.read_count(1));
+    m_spaces.resize(snapshot.read_count(1));
+
+    // the objects, each is created from the objects it is made of
+    for (auto& v : m_vertices)
+    {
+        v = new Vertex(read_snapshot_coords(snapshot));
+        v->m_structural = snapshot.read<bool>();
+        v->zoned = snapshot.read<bool>();
+    }
+    for (auto& l : m_lines)
+    {
+        l = new Line;
+        l->m_store_ptr = this;
+        for (int i = 0; i < 2; i++) l->m_vertices[i] = read_snapshot_pointer(snapshot, m_vertices);
+        l->m_center_vertex = Vertex(read_snapshot_coords(snapshot));
+        l->m_deletion = snapshot.read<bool>();
+        l->m_structural = snapshot.read<bool>();
+        l->zoned = snapshot.read<bool>();
+        l->constraint = snapshot.read<bool>();
+        l->thickness = snapshot.read<unsigned int>();
+    }
+    for (auto& r : m_rectangles)
+    {
+        r = new Rectangle;
+        r->m_store_ptr = this;
+        for (int i = 0; i < 4; i++) r->m_lines[i] = read_snapshot_pointer(snapshot, m_lines);
+        for (int i = 0; i < 4; i++) r->m_vertices[i] = read_snapshot_pointer(snapshot, m_vertices);
+        r->m_normal_vector = read_snapshot_coords(snapshot);
+        r->m_center_vertex = Vertex(read_snapshot_coords(snapshot));
+        r->m_deletion = snapshot.read<bool>();
+        r->m_structural = snapshot.read<bool>();
+        r->m_lines_associated = snapshot.read<bool>();
+        r->zoned = snapshot.read<bool>();
+        r->horizontal = snapshot.read<bool>();
+        r->thickness = snapshot.read<unsigned int>();
+        r->loading = snapshot.read<double>();
+    }
+    for (auto& c : m_cubes)
+    {
+        c = new Cuboid;
+        c->m_store_ptr = this;
+        for (int i = 0; i < 6; i++) c->m_rectangles[i] = read_snapshot_pointer(snapshot, m_rectangles);
+        for (int i = 0; i < 12; i++) c->m_lines[i] = read_snapshot_pointer(snapshot, m_lines);
+        for (int i = 0; i < 8; i++) c->m_vertices[i] = read_snapshot_pointer(snapshot, m_vertices);
+        c->m_center_vertex = Vertex(read_snapshot_coords(snapshot));
+        c->m_deletion = snapshot.read<bool>();
+        c->ID = snapshot.read<unsigned int>();
+        c->zone_IDs = snapshot.read_vector<int>();
+    }
+    for (auto& p : m_points)
+    {
+        p = new Point(read_snapshot_pointer(snapshot, m_vertices));
+    }
+    for (auto& e : m_edges)
+    { // the ctor creates the encasing line from the points
+        Line* initial_line = read_snapshot_pointer(snapshot, m_lines);
+        Point* p_1 = read_snapshot_pointer(snapshot, m_points);
+        Point* p_2 = read_snapshot_pointer(snapshot, m_points);
+        e = new Edge(initial_line, p_1, p_2);
+    }
+    for (auto& s : m_surfaces)
+    { // the ctor creates the encasing rectangle from the edges
+        Rectangle* initial_rectangle = read_snapshot_pointer(snapshot, m_rectangles);
+        Edge* e[4];
+        for (int i = 0; i < 4; i++) e[i] = read_snapshot_pointer(snapshot, m_edges);
+        s = new Surface(initial_rectangle, e[0], e[1], e[2], e[3]);
+    }
+    for (auto& s : m_spaces)
+    { // the ctor creates the encasing cuboid from the surfaces
+        int ID = snapshot.read<int>();
+        Cuboid* initial_cuboid = read_snapshot_pointer(snapshot, m_cubes);
+        Surface* f[6];
+        for (int i = 0; i < 6; i++) f[i] = read_snapshot_pointer(snapshot, m_surfaces);
+        s = new Space(ID, initial_cuboid, f[0], f[1], f[2], f[3], f[4], f[5]);
+    }
+
+    // the associations between the objects and the assigned types
+    for (auto v : m_vertices)
+    {
+        v->m_points = read_snapshot_pointers(snapshot, m_points);
+    }
+    for (auto l : m_lines)
+    {
+        l->m_edges = read_snapshot_pointers(snapshot, m_edges);
+        l->m_rectangle_ptrs = read_snapshot_pointers(snapshot, m_rectangles);
+    }
+    for (auto r : m_rectangles)
+    {
+        r->m_surfaces = read_snapshot_pointers(snapshot, m_surfaces);
+    }
+    for (auto c : m_cubes)
+    {
+        c->m_spaces = read_snapshot_pointers(snapshot, m_spaces);
+    }
+    for (auto p : m_points)
+    {
+        p->m_edge_ptrs = read_snapshot_pointers(snapshot, m_edges);
+        p->m_surface_ptrs = read_snapshot_pointers(snapshot, m_surfaces);
+        p->m_space_ptrs = read_snapshot_pointers(snapshot, m_spaces);
+    }
+    for (auto e : m_edges)
+    {
+        e->m_lines = read_snapshot_pointers(snapshot, m_lines);
+        e->m_vertices = read_snapshot_pointers(snapshot, m_vertices);
+        e->m_surface_ptrs = read_snapshot_pointers(snapshot, m_surfaces);
+        e->m_space_ptrs = read_snapshot_pointers(snapshot, m_spaces);
+        e->m_edge_type = snapshot.read_string();
+    }
+    for (auto s : m_surfaces)
+    {
+        s->m_rectangles = read_snapshot_pointers(snapshot, m_rectangles);
+        s->m_vertices = read_snapshot_pointers(snapshot, m_vertices);
+        s->m_space_ptrs = read_snapshot_pointers(snapshot, m_spaces);
+        s->m_facing.resize(snapshot.read_count(2*sizeof(double)));
+        for (unsigned int i = 0; i < s->m_facing.size(); i++)
+        {
+            s->m_facing[i].first = snapshot.read<double>();
+            s->m_facing[i].second = snapshot.read<double>();
+        }
+        s->m_surface_type = snapshot.read_string();
+    }
+    for (auto s : m_spaces)
+    {
+        s->m_cuboids = read_snapshot_pointers(snapshot, m_cubes);
+        s->m_vertices = read_snapshot_pointers(snapshot, m_vertices);
+        s->m_cuboid_IDs = snapshot.read_vector<unsigned int>();
+        for (int i = 0; i < 12; i++) s->m_edges[i] = read_snapshot_pointer(snapshot, m_edges);
+        for (int i = 0; i < 8; i++) s->m_points[i] = read_snapshot_pointer(snapshot, m_points);
+        s->m_space_type = snapshot.read_string();
+    }
+
+    // execute grammar
+    grammar(this);
+
+} // ctor
+
+} // namespace Spatial_Design
+} // namespace BSO
+
+#endif // MS_CONFORMAL_SNAPSHOT_CPP
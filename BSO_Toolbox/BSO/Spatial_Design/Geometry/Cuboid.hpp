@@ -7,6 +7,7 @@ namespace BSO { namespace Spatial_Design { namespace Geometry
 class Cuboid
 {
 private:
+    friend class Spatial_Design::MS_Conformal; // restores the geometry from a snapshot
     std::vector<Space*> m_spaces; // if .size() > 1 there are overlapping spaces.
     Vertex_Store* m_store_ptr;
     Rectangle* m_rectangles[6];
@@ -7,6 +7,7 @@ namespace BSO { namespace Spatial_Design { namespace Geometry
 class Edge
 {
 private:
+    friend class Spatial_Design::MS_Conformal; // restores the geometry from a snapshot
     // members are:
     std::vector<Line*> m_lines; // this edge is represented by one or more lines (at least 1, the initial line, see ctor)
     std::vector<Vertex*> m_vertices; // the vertices that represent this edge
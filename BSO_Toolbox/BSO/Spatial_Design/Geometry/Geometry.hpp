@@ -13,7 +13,11 @@
  * This file serves as a forward declaration of the required classes in the conformation process
  */
 
-namespace BSO { namespace Spatial_Design { namespace Geometry
+namespace BSO { namespace Spatial_Design
+{
+    class MS_Conformal; // friend of the classes, see MS_Conformal::write_snapshot()
+
+namespace Geometry
 {
     // forward declaration of the classes
     class Vertex;
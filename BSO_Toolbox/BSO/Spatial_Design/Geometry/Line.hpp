@@ -7,6 +7,7 @@ namespace BSO { namespace Spatial_Design { namespace Geometry
 class Line
 {
 private:
+    friend class Spatial_Design::MS_Conformal; // restores the geometry from a snapshot
     std::vector<Edge*> m_edges; // this line belongs to a number of edges
     std::vector<Rectangle*> m_rectangle_ptrs; // the rectangles that this line is part of
     Vertex_Store* m_store_ptr; // pointer towards the vector in which this object of the Line class is stored
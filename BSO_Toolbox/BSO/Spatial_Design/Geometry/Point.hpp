@@ -7,6 +7,7 @@ namespace BSO { namespace Spatial_Design { namespace Geometry
 class Point
 {
 private:
+    friend class Spatial_Design::MS_Conformal; // restores the geometry from a snapshot
     // members are:
     Vertex* m_vertex; // this point is represented by one vertex
 
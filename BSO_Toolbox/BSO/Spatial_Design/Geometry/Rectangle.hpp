@@ -7,6 +7,7 @@ namespace BSO { namespace Spatial_Design { namespace Geometry
 class Rectangle
 {
 private:
+    friend class Spatial_Design::MS_Conformal; // restores the geometry from a snapshot
     std::vector<Surface*> m_surfaces;
     Vertex_Store* m_store_ptr; // pointer towards the vector in which this object of the Rectangle class is stored
     Line* m_lines[4];
@@ -7,6 +7,7 @@ namespace BSO { namespace Spatial_Design { namespace Geometry
 class Space
 {
 private:
+    friend class Spatial_Design::MS_Conformal; // restores the geometry from a snapshot
     // members are:
     std::vector<Cuboid*> m_cuboids; // this space is represented by one or more cuboid
     std::vector<Vertex*> m_vertices;
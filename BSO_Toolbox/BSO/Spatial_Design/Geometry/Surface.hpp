@@ -7,6 +7,7 @@ namespace BSO { namespace Spatial_Design { namespace Geometry
 class Surface
 {
 private:
+    friend class Spatial_Design::MS_Conformal; // restores the geometry from a snapshot
     // members are:
     std::vector<Rectangle*> m_rectangles; // this surface is represented by one or more rectangles
     std::vector<Vertex*> m_vertices; // the vertices that represent this surface
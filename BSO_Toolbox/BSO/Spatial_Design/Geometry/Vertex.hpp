@@ -7,6 +7,7 @@ namespace BSO { namespace Spatial_Design { namespace Geometry {
 class Vertex
 {
 private:
+    friend class Spatial_Design::MS_Conformal; // restores the geometry from a snapshot
     std::vector<Point*> m_points;
     Vectors::Point m_coords;
 
@@ -3,8 +3,8 @@
 
 #include <BSO/Spatial_Design/Supercube.hpp> // for operator overloading, this also loads in <string> and <vector>
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Field_Scanner.hpp>
 
-#include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <iostream>
@@ -109,6 +109,7 @@ namespace BSO { namespace Spatial_Design
 
         void add_space(MS_Space); // adds a space to the building
         void delete_space(int space_index); // deletes a space from the building
+        void delete_spaces(std::vector<int> space_IDs); // deletes the spaces with the given IDs from the building, in one pass
 
         void split_space(int space_index); // splits a space across its largest dimensions
         void split_space(int space_index, int axis); // splits in the middle across axis: [0,1,2] for respectively [x,y,z]
@@ -153,14 +154,11 @@ namespace BSO { namespace Spatial_Design
             int d_index = S.get_d_index(cell_index);
             int h_index = S.get_h_index(cell_index);
 
-            for (unsigned int i = 0; i < S.b_size(); i++) // check each room for the considered cell, whether it describes a room
+            if (!S.empty_cell(cell_index)) // if the cell describes a room, then update the origin indexes
             {
-                if (S.request_b(i, cell_index) == 1) // if it does describe a room, then update the origin indexes
-                    {
-                        if (w_index < w_origin) { w_origin = w_index; } // update the indexes containing the origin of the MS representation
-                        if (d_index < d_origin) { d_origin = d_index; }
-                        if (h_index < h_origin) { h_origin = h_index; }
-                    }
+                if (w_index < w_origin) { w_origin = w_index; } // update the indexes containing the origin of the MS representation
+                if (d_index < d_origin) { d_origin = d_index; }
+                if (h_index < h_origin) { h_origin = h_index; }
             }
         }
 
@@ -240,55 +238,33 @@ namespace BSO { namespace Spatial_Design
 
     void MS_Building::read_file(std::string file_name)
     {
-        std::ifstream input(file_name.c_str()); // initialize input stream from file: file_name
-		if (!input.is_open() && file_name != "empty")
+        if (file_name == "empty")
+        {
+            return;
+        }
+        Field_Scanner input(file_name, ","); // reads the file, fields are separated by a ','
+		if (!input.is_open())
 			throw std::runtime_error("Could not open file: " + file_name);
-		
-        std::string line;
-        boost::char_separator<char> sep(","); // defines what separates tokens in a string
-        typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
 
-        while (!input.eof() && file_name != "empty") // continue while the End Of File has not been reached
+        while (input.next_line()) // continue while the End Of File has not been reached, empty lines are skipped
         {
+            unsigned int number_of_tokens = input.field_count(); // TG_22-03-2017  determine number of tokens within a line of the input file
 
-            getline(input,line); // get next line from the file
-            boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
-            if (line == "") //skip empty lines (tokenizer does not like it)
-            {
-                continue; // continue to next line
-            }
-
-            t_tokenizer tok(line, sep); // tokenize the line
-            t_tokenizer::iterator token = tok.begin(); // set iterator to first token
-            int number_of_tokens = std::distance( tok.begin(), tok.end() ); // TG_22-03-2017  determine number of tokens within a line of the input file
-
-            if (*token != "R")
+            if (!input.field_is(0, "R"))
             {
                 continue; // continue to next line in text file
             }
             else // if the first token is an "R" then this line describes a space
             {
 				MS_Space temp_space; // this MS_Space structure will temporarily hold the space described by the considered line
-                token++; // this is the 'ID'
-                temp_space.ID = trim_and_cast_int(*token);
-
-                token++; // this is 'width'
-                temp_space.width = trim_and_cast_double(*token);
-
-                token++; // this is 'depth'
-                temp_space.depth = trim_and_cast_double(*token);
-
-                token++; // this is 'height'
-                temp_space.height = trim_and_cast_double(*token);
-
-                token++; // this is 'x-coordinate'
-                temp_space.x = trim_and_cast_double(*token);
-
-                token++; // this is 'y-coordinate'
-                temp_space.y = trim_and_cast_double(*token);
-
-                token++; // this is 'z-coordinate'
-                temp_space.z = trim_and_cast_double(*token);
+                temp_space.ID = input.get_int(1); // this is the 'ID'
+                temp_space.width = input.get_double(2); // this is 'width'
+                temp_space.depth = input.get_double(3); // this is 'depth'
+                temp_space.height = input.get_double(4); // this is 'height'
+                temp_space.x = input.get_double(5); // this is 'x-coordinate'
+                temp_space.y = input.get_double(6); // this is 'y-coordinate'
+                temp_space.z = input.get_double(7); // this is 'z-coordinate'
+                unsigned int token = 8;
 
                 switch (number_of_tokens) // TG_22-03-2017  defines boolean of surface given
                 {
@@ -298,45 +274,24 @@ namespace BSO { namespace Spatial_Design
                 }
                 case 9:
                 {
-                    token++; // space_type
-                    temp_space.m_space_type = *token;
-                    boost::algorithm::trim(temp_space.m_space_type);
+                    temp_space.m_space_type = input.get_string(token++); // space_type
                     temp_space.space_type_given = true;
                     break;
                 }
                 case 15:
                 {
-                    token++; // space_type
-                    temp_space.m_space_type = *token;
-                    boost::algorithm::trim(temp_space.m_space_type);
+                    temp_space.m_space_type = input.get_string(token++); // space_type
                     temp_space.space_type_given = true;
 					// NOTE no break, so we continue to the next case!
                 }
                 case 14:
                 {
-                    token++; // TG_22-03-2017  this is 'north-surface'
-                    temp_space.surface_type[0] = *token;
-                    boost::algorithm::trim(temp_space.surface_type[0]);
-
-                    token++; // TG_22-03-2017  this is 'east-surface'
-                    temp_space.surface_type[1] = *token;
-                    boost::algorithm::trim(temp_space.surface_type[1]);
-
-                    token++; // TG_22-03-2017  this is 'south-surface'
-                    temp_space.surface_type[2] = *token;
-                    boost::algorithm::trim(temp_space.surface_type[2]);
-
-                    token++; // TG_22-03-2017  this is 'west-surface'
-                    temp_space.surface_type[3] = *token;
-                    boost::algorithm::trim(temp_space.surface_type[3]);
-
-                    token++; // TG_22-03-2017  this is 'top-surface'
-                    temp_space.surface_type[4] = *token;
-                    boost::algorithm::trim(temp_space.surface_type[4]);
-
-                    token++; // TG_22-03-2017  this is 'bottom-surface'
-                    temp_space.surface_type[5] = *token;
-                    boost::algorithm::trim(temp_space.surface_type[5]);
+                    temp_space.surface_type[0] = input.get_string(token++); // TG_22-03-2017  this is 'north-surface'
+                    temp_space.surface_type[1] = input.get_string(token++); // TG_22-03-2017  this is 'east-surface'
+                    temp_space.surface_type[2] = input.get_string(token++); // TG_22-03-2017  this is 'south-surface'
+                    temp_space.surface_type[3] = input.get_string(token++); // TG_22-03-2017  this is 'west-surface'
+                    temp_space.surface_type[4] = input.get_string(token++); // TG_22-03-2017  this is 'top-surface'
+                    temp_space.surface_type[5] = input.get_string(token++); // TG_22-03-2017  this is 'bottom-surface'
 
                     temp_space.surfaces_given  = true;
                     break;
@@ -461,6 +416,35 @@ namespace BSO { namespace Spatial_Design
         m_spaces.erase(m_spaces.begin() + space_index);
     }
 
+    void MS_Building::delete_spaces(std::vector<int> space_IDs)
+    {
+        std::sort(space_IDs.begin(), space_IDs.end());
+        unsigned int deleted_count = 0;
+        unsigned int kept_count = 0;
+        for (unsigned int i = 0; i < m_spaces.size(); i++)
+        { // keep the spaces that are not listed, in their order
+            if (std::binary_search(space_IDs.begin(), space_IDs.end(), m_spaces[i].ID))
+            {
+                deleted_count++;
+            }
+            else
+            {
+                if (kept_count != i)
+                {
+                    m_spaces[kept_count] = m_spaces[i];
+                }
+                kept_count++;
+            }
+        }
+
+        if (deleted_count != (unsigned int)(std::unique(space_IDs.begin(), space_IDs.end()) - space_IDs.begin()))
+        {
+            std::cerr << "Could not find space by its ID (Movable_Sizable.hpp), exiting now... " << std::endl;
+            exit(1);
+        }
+        m_spaces.resize(kept_count);
+    }
+
     void MS_Building::split_space(int space_index)
     {
         if (m_spaces[space_index].width < 0.9999 * m_spaces[space_index].depth)
@@ -594,8 +578,6 @@ namespace BSO { namespace Spatial_Design
         y_values.erase(unique(y_values.begin(), y_values.end()), y_values.end());
         z_values.erase(unique(z_values.begin(), z_values.end()), z_values.end());
 
-        double x_origin = x_values[0], y_origin = y_values[0], z_origin = z_values[0]; // saves the coordinates of the super cube's origin
-
         for (unsigned int i = 0; i < x_values.size()-1; i++)    // computes widths of super cube grid and puts them in the w_values vector
             { S.stack_w_value(x_values[i+1] - x_values[i]); }
         for (unsigned int i = 0; i < y_values.size()-1; i++)    // computes depths of super cube grid and puts them in the d_values vector
@@ -608,12 +590,26 @@ namespace BSO { namespace Spatial_Design
 
         for (unsigned int i = 0; i < m_spaces.size(); i++)  // computes a row of the b_values matrix and adds these to the matrix for each room
         {
-            b_values_row.clear(); // clears the vector's data from previous iteration
-            b_values_row.push_back(i + 1); // index 0 contains the room ID, for the super cube the count starts again from 1.
-
-            for (int cell_index = 1; cell_index <= cube_size; cell_index++) // checks each cell within the super cube if it belongs to room with ID: i
+            b_values_row.assign(cube_size+1, 0); // clears the vector's data from previous iteration
+            b_values_row[0] = i + 1; // index 0 contains the room ID, for the super cube the count starts again from 1.
+
+            // the grid lines are the coordinates of the spaces, so each space spans a range of grid indices in each direction
+            int w_begin = std::lower_bound(x_values.begin(), x_values.end(), m_spaces[i].x) - x_values.begin();
+            int w_end = std::lower_bound(x_values.begin(), x_values.end(), m_spaces[i].x + m_spaces[i].width) - x_values.begin();
+            int d_begin = std::lower_bound(y_values.begin(), y_values.end(), m_spaces[i].y) - y_values.begin();
+            int d_end = std::lower_bound(y_values.begin(), y_values.end(), m_spaces[i].y + m_spaces[i].depth) - y_values.begin();
+            int h_begin = std::lower_bound(z_values.begin(), z_values.end(), m_spaces[i].z) - z_values.begin();
+            int h_end = std::lower_bound(z_values.begin(), z_values.end(), m_spaces[i].z + m_spaces[i].height) - z_values.begin();
+
+            for (int w = w_begin; w < w_end; w++)
             {
-                b_values_row.push_back((check_cell(S, cell_index, i, x_origin, y_origin, z_origin) ? 1 : 0)); // If a cell belongs to the room assign 1 to index, if not 0
+                for (int d = d_begin; d < d_end; d++)
+                {
+                    for (int h = h_begin; h < h_end; h++)
+                    {
+                        b_values_row[S.get_cell_index(w, d, h)] = 1; // the cell belongs to the room with ID: i
+                    }
+                }
             }
 
             S.stack_b_value_row(b_values_row); // adds the row to the b_values matrix
@@ -2,8 +2,8 @@
 #define SUPERCUBE_HPP
 
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Field_Scanner.hpp>
 
-#include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <vector>
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <cstdint>
 
 namespace BSO { namespace Spatial_Design
 {
@@ -27,6 +28,8 @@ namespace BSO { namespace Spatial_Design
         std::vector<double> d_values; // contains all depths of the cube's grid in y-direction
         std::vector<double> h_values; // contains all heights of the cube's grid in z-direction
         std::vector<std::vector<int> > b_values; // contains all room information, for each room it is described whether a cell belongs to that room or not
+        std::vector<int> m_cell_owner; // for each cell index the b_values row of the first room the cell belongs to, -1 if the cell is empty
+        std::vector<std::vector<uint64_t> > m_cell_bits; // for each room the b_values row packed into bits, 64 cells per word
 
         friend class MS_Building;
 
@@ -34,6 +37,8 @@ namespace BSO { namespace Spatial_Design
         void stack_d_value(double d_value); // adds a value to the d_values vector
         void stack_h_value(double h_value); // adds a value to the h_values vector
         void stack_b_value_row(std::vector<int> b_value_row); // adds a value to the b_values vector
+        void index_b_value_row(unsigned int room_index); // adds a b_values row to the cell owners and cell bits
+        void index_cells(); // rebuilds the cell owners and cell bits from b_values, after b_values has been changed
     protected:
 
     public:
@@ -57,6 +62,8 @@ namespace BSO { namespace Spatial_Design
         unsigned int b_size(); // returns size of the b_values vector
         unsigned int b_row_size(int room_ID); // returns size of the specified b_values row
         int get_space_id(int cell_index); // returns the space ID if the cell belongs the space WARNING exits when the cell does not belong to a space
+        unsigned int cell_space_count(int cell_index); // returns the number of spaces the cell belongs to
+        bool spaces_overlap(int room_index_1, int room_index_2); // returns true if the two spaces (b_values rows) share a cell
 
         double request_w(int index); // returns a value from the w_values vector
         double request_d(int index); // returns a value from the d_values vector
@@ -68,6 +75,7 @@ namespace BSO { namespace Spatial_Design
         //TS added functions
         bool empty_cell(int cell_index); // returns true if a cell is empty
         std::vector<int> adjacent_cells(int cell_index); // returns a list with all cells adjacent to the given index
+        unsigned int adjacent_cells(int cell_index, int* adjacent_cell_indices); // writes the (at most 6) cells adjacent to the given index to the array, returns their number
     }; // SC_Building
 
     // Implementation of member functions:
@@ -84,16 +92,14 @@ namespace BSO { namespace Spatial_Design
     {
         if (n < -1) std::cout << "";
 
-        boost::char_separator<char> sep("\t; "); // defines what separates tokens in a string
-        typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
+        Field_Scanner input(line, "\t; ", false, scanner_source::TEXT); // the line is the source
+        input.next_line();
+        unsigned int token = 0;
 
-        t_tokenizer tok(line, sep); // tokenize the line
-        t_tokenizer::iterator token = tok.begin(); // set iterator to first token
-
-        unsigned int w = BSO::trim_and_cast_uint(*token); token++;
-        unsigned int d = BSO::trim_and_cast_uint(*token); token++;
-        unsigned int h = BSO::trim_and_cast_uint(*token); token++;
-        unsigned int b = BSO::trim_and_cast_uint(*token); token++;
+        unsigned int w = input.get_uint(token++);
+        unsigned int d = input.get_uint(token++);
+        unsigned int h = input.get_uint(token++);
+        unsigned int b = input.get_uint(token++);
 
         w_values = std::vector<double>(w);
         d_values = std::vector<double>(d);
@@ -102,20 +108,17 @@ namespace BSO { namespace Spatial_Design
 
         for (unsigned int i = 0; i < w; i++)
         { // for each w_value
-            w_values[i] = (int)1000*BSO::trim_and_cast_double(*token); // add the dimension
-            token++;
+            w_values[i] = (int)1000*input.get_double(token++); // add the dimension
         }
 
         for (unsigned int i = 0; i < d; i++)
         { // for each d_value
-            d_values[i] = (int)1000*BSO::trim_and_cast_double(*token); // add the dimension
-            token++;
+            d_values[i] = (int)1000*input.get_double(token++); // add the dimension
         }
 
         for (unsigned int i = 0; i < h; i++)
         { // for each h_value
-            h_values[i] = (int)1000*BSO::trim_and_cast_double(*token); // add the dimension
-            token++;
+            h_values[i] = (int)1000*input.get_double(token++); // add the dimension
         }
 
         for (unsigned int i = 0; i < b; i++)
@@ -123,10 +126,11 @@ namespace BSO { namespace Spatial_Design
             b_values[i].push_back(i+1); // add a space ID
             for (unsigned int j = 0; j < w*d*h; j++)
             { // and for each cell in the supercube
-                b_values[i].push_back(BSO::trim_and_cast_double(*token)); // add the value of cell j for space i to the b_values container
-                token++;
+                b_values[i].push_back(input.get_double(token++)); // add the value of cell j for space i to the b_values container
             }
         }
+
+        index_cells();
     } // ctor
 
     SC_Building::SC_Building()
@@ -141,76 +145,53 @@ namespace BSO { namespace Spatial_Design
 
     void SC_Building::read_file(std::string file_name)
     {
-        std::ifstream input(file_name.c_str()); // initialize input stream from file: file_name
+        Field_Scanner input(file_name, ","); // reads the file, fields are separated by a ','
 
         if (!input.is_open())
             throw std::runtime_error("Could not open file: " + file_name);
 
-        std::string line;
-        std::string temp; // to temporarily hold tokens
         char type_ID = ' ';
-        boost::char_separator<char> sep(","); // defines what separates tokens in a string
-        typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
 
-        while (!input.eof()) // continue while the End Of File has not been reached
+        while (input.next_line()) // continue while the End Of File has not been reached, empty lines are skipped
         {
-            getline(input,line); // get next line from the file
-            boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
-            if (line == "") //skip empty lines (tokenizer does not like it)
-            {
-                continue; // continue to next line
-            }
-
-            t_tokenizer tok(line, sep); // tokenize the line
-            t_tokenizer::iterator token = tok.begin(); // set iterator to first token
-            type_ID = BSO::trim_and_cast_char(*token); // interpret first token as type ID
-            token++;
+            type_ID = input.get_char(0); // interpret first token as type ID
+            unsigned int token_count = input.field_count();
 
             switch (type_ID)
             {
             case 'w':
                 {
-                    while (token != tok.end())
+                    for (unsigned int token = 1; token < token_count; token++)
                     {
-                        temp = *token;
-                        w_values.push_back(trim_and_cast_double(temp));
-                        token++;
+                        w_values.push_back(input.get_double(token));
                     }
                     break;
                 }
             case 'd':
                 {
-                    while (token != tok.end())
+                    for (unsigned int token = 1; token < token_count; token++)
                     {
-                        temp = *token;
-                        d_values.push_back(trim_and_cast_double(temp));
-                        token++;
+                        d_values.push_back(input.get_double(token));
                     }
                     break;
                 }
             case 'h':
                 {
-                    while (token != tok.end())
+                    for (unsigned int token = 1; token < token_count; token++)
                     {
-                        temp = *token;
-                        h_values.push_back(trim_and_cast_double(temp));
-                        token++;
+                        h_values.push_back(input.get_double(token));
                     }
                     break;
                 }
             case 'b':
                 {
-                    temp = *token;
-                    int ID = trim_and_cast_int(temp);
+                    int ID = input.get_int(1);
                     std::vector<int> row; row.push_back(ID);
                     b_values.push_back(row);
-                    token++;
 
-                    while (token != tok.end())
+                    for (unsigned int token = 2; token < token_count; token++)
                     {
-                        temp = *token;
-                        b_values[ID-1].push_back(trim_and_cast_int(temp));
-                        token++;
+                        b_values[ID-1].push_back(input.get_int(token));
                     }
                     break;
                 }
@@ -220,6 +201,8 @@ namespace BSO { namespace Spatial_Design
                 }
             } // end of switch statement
         } // end of while
+
+        index_cells();
     } // read_file()
 
     void SC_Building::write_file(std::string filename)
@@ -326,16 +309,42 @@ namespace BSO { namespace Spatial_Design
 
     int SC_Building::get_space_id(int cell_index)
     {
-        for ( unsigned int i = 0 ; i < b_values.size() ; i++ )
+        if (cell_index > 0 && (unsigned int)cell_index < m_cell_owner.size() && m_cell_owner[cell_index] != -1)
         {
-            if(b_values[i][cell_index] == 1)
-                {return b_values[i][0];}
+            return b_values[m_cell_owner[cell_index]][0];
         }
 
         std::cerr<< "Error, could not find space using cell index: " << cell_index <<"exiting now... (Supercube.hpp)"<<std::endl;
         exit(1);
     } // get_space_id()
 
+    unsigned int SC_Building::cell_space_count(int cell_index)
+    {
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < m_cell_bits.size(); i++)
+        {
+            if (cell_index > 0 && (unsigned int)cell_index/64 < m_cell_bits[i].size())
+            {
+                count += (m_cell_bits[i][cell_index/64] >> (cell_index%64)) & 1;
+            }
+        }
+        return count;
+    } // cell_space_count()
+
+    bool SC_Building::spaces_overlap(int room_index_1, int room_index_2)
+    {
+        const std::vector<uint64_t>& bits_1 = m_cell_bits[room_index_1];
+        const std::vector<uint64_t>& bits_2 = m_cell_bits[room_index_2];
+        for (unsigned int i = 0; i < bits_1.size() && i < bits_2.size(); i++)
+        {
+            if ((bits_1[i] & bits_2[i]) != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    } // spaces_overlap()
+
     void SC_Building::add_padding(unsigned int w, unsigned int d, unsigned int h, double magnitude)
     {
         for (unsigned int i = 0; i < w; i++)
@@ -400,6 +409,8 @@ namespace BSO { namespace Spatial_Design
 
             h_values.push_back(magnitude); // always add padding to the back (i.e. the top; +z face)
         }
+
+        index_cells();
     } // add_padding()
 
     double SC_Building::request_w(int index) // see header
@@ -440,8 +451,42 @@ namespace BSO { namespace Spatial_Design
     void SC_Building::stack_b_value_row(std::vector<int> b_value_row)
     {
         b_values.push_back(b_value_row);
+        index_b_value_row(b_values.size()-1);
     } // stack_b_value_row()
 
+    void SC_Building::index_b_value_row(unsigned int room_index)
+    {
+        const std::vector<int>& row = b_values[room_index]; // index 0 holds the room ID, cell indices start at 1
+        if (m_cell_owner.size() < row.size())
+        {
+            m_cell_owner.resize(row.size(), -1);
+        }
+        m_cell_bits.push_back(std::vector<uint64_t>((row.size()+63)/64, 0));
+        std::vector<uint64_t>& bits = m_cell_bits.back();
+
+        for (unsigned int j = 1; j < row.size(); j++)
+        {
+            if (row[j] == 1)
+            {
+                bits[j/64] |= uint64_t(1) << (j%64);
+                if (m_cell_owner[j] == -1)
+                {
+                    m_cell_owner[j] = room_index;
+                }
+            }
+        }
+    } // index_b_value_row()
+
+    void SC_Building::index_cells()
+    {
+        m_cell_owner.assign(w_values.size()*d_values.size()*h_values.size()+1, -1);
+        m_cell_bits.clear();
+        for (unsigned int i = 0; i < b_values.size(); i++)
+        {
+            index_b_value_row(i);
+        }
+    } // index_cells()
+
     int SC_Building::get_w_index(int cell_index)
     {
         return ((cell_index-1)/(h_values.size()*d_values.size()));
@@ -464,53 +509,51 @@ namespace BSO { namespace Spatial_Design
 
     bool SC_Building::empty_cell(int cell_index)
     {
-        for ( unsigned int i = 0 ; i < b_values.size() ; i++ )
-        {
-
-            if ( b_values[i][cell_index] == 1)
-            {
-                return false;
-            }
-        }
-        return true;
+        return cell_index <= 0 || (unsigned int)cell_index >= m_cell_owner.size() || m_cell_owner[cell_index] == -1;
     } // empty_cell()
 
-    std::vector<int> SC_Building::adjacent_cells(int cell_index)
+    unsigned int SC_Building::adjacent_cells(int cell_index, int* adjacent_cell_indices)
     {
         unsigned int h_index = get_h_index(cell_index);
         unsigned int w_index = get_w_index(cell_index);
         unsigned int d_index = get_d_index(cell_index);
+        unsigned int count = 0;
 
-        std::vector<int> adjacent_cell_indices;
-
-        if (h_index < h_values.size())
+        if (h_index+1 < h_values.size())
         {
-            adjacent_cell_indices.push_back(get_cell_index(w_index, d_index, h_index + 1 ));
+            adjacent_cell_indices[count++] = get_cell_index(w_index, d_index, h_index + 1);
         }
-        if (h_index > 1)
+        if (h_index > 0)
         {
-            adjacent_cell_indices.push_back(get_cell_index(w_index, d_index, h_index - 1 ));
+            adjacent_cell_indices[count++] = get_cell_index(w_index, d_index, h_index - 1);
         }
 
-        if (w_index < w_values.size())
+        if (w_index+1 < w_values.size())
         {
-            adjacent_cell_indices.push_back(get_cell_index(w_index + 1, d_index, h_index ));
+            adjacent_cell_indices[count++] = get_cell_index(w_index + 1, d_index, h_index);
         }
-        if(w_index > 1 )
+        if (w_index > 0)
         {
-            adjacent_cell_indices.push_back(get_cell_index(w_index - 1, d_index, h_index ));
+            adjacent_cell_indices[count++] = get_cell_index(w_index - 1, d_index, h_index);
         }
 
-        if (d_index > 1)
+        if (d_index > 0)
         {
-            adjacent_cell_indices.push_back(get_cell_index(w_index, d_index - 1, h_index));
+            adjacent_cell_indices[count++] = get_cell_index(w_index, d_index - 1, h_index);
         }
-        if (d_index < d_values.size())
+        if (d_index+1 < d_values.size())
         {
-            adjacent_cell_indices.push_back(get_cell_index(w_index, d_index + 1, h_index));
+            adjacent_cell_indices[count++] = get_cell_index(w_index, d_index + 1, h_index);
         }
 
-        return adjacent_cell_indices;
+        return count;
+    } // adjacent_cells()
+
+    std::vector<int> SC_Building::adjacent_cells(int cell_index)
+    {
+        int adjacent_cell_indices[6];
+        unsigned int count = adjacent_cells(cell_index, adjacent_cell_indices);
+        return std::vector<int>(adjacent_cell_indices, adjacent_cell_indices + count);
     } //adjacent_cells()
 
 } // namespace Spatial_Design
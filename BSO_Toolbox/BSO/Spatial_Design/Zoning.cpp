@@ -16,9 +16,21 @@ Zoned_Design::Zoned_Design(MS_Conformal* CF)
 	adaptive_thickness = zoning_settings.adaptive_thickness;
 } // ctor
 
+Zoned_Design::Zoned_Design(MS_Conformal* CF, const Grammar::Zoning_Settings& settings)
+{ // used for the zoned designs created by a root design, avoids re-reading the settings file for each of them
+	m_CF = CF;
+	zoning_settings = settings;
+	max_span = zoning_settings.max_span;
+	min_span = zoning_settings.min_span;
+	whole_space_zones = zoning_settings.whole_space_zones;
+	delete_expanded_designs = zoning_settings.delete_expanded_designs;
+	zone_floors = zoning_settings.zone_floors;
+	adaptive_thickness = zoning_settings.adaptive_thickness;
+} // ctor
+
 Zoned_Design::~Zoned_Design()
 {
-
+	// zoned designs in m_owned_designs are released by their shared pointers
 } // dtor
 
 bool Zoned_Design::check_double_zones(Zone* zone)
@@ -1143,12 +1155,73 @@ std::vector<Zone*> Zoned_Design::get_zones()
     return m_zones;
 } // get_zones()
 
-bool Zoned_Design::check_double_designs(Zoned_Design* zoned)
+unsigned int Zoned_Design::get_zone_bit(Zone* zone)
+{
+    std::map<Zone*, unsigned int>::iterator it = m_zone_bit.find(zone);
+    if (it != m_zone_bit.end())
+    {
+        return it->second;
+    }
+
+    // first time the zone is used in a candidate: give it a bit and grow the arena along
+    unsigned int bit = m_zone_pool.size();
+    m_zone_pool.push_back(zone);
+    m_zone_bit[zone] = bit;
+    for (unsigned int i = 0; i < m_candidates.size(); i++)
+    {
+        m_candidates[i].m_zone_bits.resize(m_zone_pool.size());
+    }
+    for (unsigned int i = 0; i < m_temp_candidates.size(); i++)
+    {
+        m_temp_candidates[i].m_zone_bits.resize(m_zone_pool.size());
+    }
+    return bit;
+} // get_zone_bit()
+
+Zoned_Candidate Zoned_Design::make_candidate(Zone* zone, unsigned int type)
+{
+    Zoned_Candidate candidate;
+    Zoned_Design::get_zone_bit(zone);
+    candidate.m_zone_bits.resize(m_zone_pool.size());
+    candidate.m_cuboid_bits.resize(m_cuboids.size());
+    Zoned_Design::add_candidate_zone(candidate, zone);
+    candidate.base_type = type;
+    return candidate;
+} // make_candidate()
+
+void Zoned_Design::add_candidate_zone(Zoned_Candidate& candidate, Zone* zone)
+{
+    unsigned int bit = Zoned_Design::get_zone_bit(zone);
+    if (candidate.m_zone_bits.size() < m_zone_pool.size())
+    {
+        candidate.m_zone_bits.resize(m_zone_pool.size());
+    }
+    candidate.m_zone_bits.set(bit);
+    for (unsigned int i = 0; i < zone->get_cuboid_count(); i++)
+    {
+        candidate.m_cuboid_bits.set(zone->get_cuboid(i)->get_ID() - 1); // cuboid IDs start at 1
+    }
+} // add_candidate_zone()
+
+bool Zoned_Design::check_double_cuboids(const Zoned_Candidate& candidate, Zone* zone)
+{
+    for (unsigned int i = 0; i < zone->get_cuboid_count(); i++)
+    {
+        if (candidate.m_cuboid_bits.test(zone->get_cuboid(i)->get_ID() - 1))
+        {
+            return true;
+        }
+    }
+    return false;
+} // check_double_cuboids()
+
+bool Zoned_Design::check_double_designs(const Zoned_Candidate& candidate)
 {
     bool found = false;
-    for (unsigned int i = 0; i < m_zoned.size(); i++)
+    for (unsigned int i = 0; i < m_candidates.size(); i++)
     {
-        if (zoned->get_zones() == m_zoned[i]->get_zones())
+        if (candidate.m_cuboid_bits == m_candidates[i].m_cuboid_bits &&
+            candidate.m_zone_bits == m_candidates[i].m_zone_bits)
         {
             found = true;
             break;
@@ -1157,12 +1230,13 @@ bool Zoned_Design::check_double_designs(Zoned_Design* zoned)
     return found;
 } // check_double_designs()
 
-bool Zoned_Design::check_double_temp_designs(Zoned_Design* zoned)
+bool Zoned_Design::check_double_temp_designs(const Zoned_Candidate& candidate)
 {
     bool found = false;
-    for (unsigned int i = 0; i < m_temp_zoned.size(); i++)
+    for (unsigned int i = 0; i < m_temp_candidates.size(); i++)
     {
-        if (zoned->get_zones() == m_temp_zoned[i]->get_zones())
+        if (candidate.m_cuboid_bits == m_temp_candidates[i].m_cuboid_bits &&
+            candidate.m_zone_bits == m_temp_candidates[i].m_zone_bits)
         {
             found = true;
             break;
@@ -1171,17 +1245,35 @@ bool Zoned_Design::check_double_temp_designs(Zoned_Design* zoned)
     return found;
 } // check_double_temp_designs()
 
-void Zoned_Design::get_missing_cuboids(Zoned_Design* zoned)
+void Zoned_Design::get_missing_cuboids(const Zoned_Candidate& candidate)
 {
     m_temp_cuboids.clear();
     for (unsigned int i = 0; i < m_cuboids.size(); i++)
     {
-        if (std::find(zoned->m_cuboids.begin(), zoned->m_cuboids.end(), m_cuboids[i]) == zoned->m_cuboids.end())
+        if (candidate.m_cuboid_bits.test(i) == false)
             m_temp_cuboids.push_back(m_cuboids[i]);
     }
     std::sort(m_temp_cuboids.begin(), m_temp_cuboids.end());
 } // get_missing_cuboids()
 
+Zoned_Design* Zoned_Design::materialize(const Zoned_Candidate& candidate)
+{
+    std::shared_ptr<Zoned_Design> zoned(new Zoned_Design(m_CF, zoning_settings));
+    for (size_t i = candidate.m_zone_bits.find_first(); i != boost::dynamic_bitset<>::npos; i = candidate.m_zone_bits.find_next(i))
+    {
+        zoned->m_zones.push_back(m_zone_pool[i]);
+    }
+    for (size_t i = candidate.m_cuboid_bits.find_first(); i != boost::dynamic_bitset<>::npos; i = candidate.m_cuboid_bits.find_next(i))
+    {
+        zoned->m_cuboids.push_back(m_cuboids[i]);
+    }
+    std::sort(zoned->m_zones.begin(), zoned->m_zones.end());
+    std::sort(zoned->m_cuboids.begin(), zoned->m_cuboids.end());
+    zoned->base_type = candidate.base_type;
+    m_owned_designs.push_back(zoned);
+    return zoned.get();
+} // materialize()
+
 bool Zoned_Design::check_double_appendix_zones(Zone* zone)
 {
     bool found = false;
@@ -1797,13 +1889,6 @@ void Zoned_Design::create_appendix_zones(unsigned int base_type)
     }
 } // create_appendix_zones()
 
-void Zoned_Design::duplicate(Zoned_Design* zoned)
-{
-    m_cuboids = zoned->m_cuboids;
-    m_zones = zoned->m_zones;
-    base_type = zoned->base_type;
-} // duplicate()
-
 std::vector<Zone*> Zoned_Design::get_intersecting_zones(Zone* zone, unsigned int n)
 {
     std::vector<Zone*> intersecting_zones;
@@ -1879,6 +1964,7 @@ unsigned int Zoned_Design::get_vertex_count()
 
 void Zoned_Design::make_zoning()
 {
+    BSO_PROFILE_SCOPE("Zoned_Design::make_zoning");
     unsigned int cuboid_count = m_CF->get_cuboid_count();
         // add cuboid ID's and check maximum span
         for (unsigned int i = 0; i < cuboid_count; i++)
@@ -2244,6 +2330,9 @@ void Zoned_Design::make_zoning()
         m_cuboids.push_back(m_CF->get_cuboid(i));
     }
 
+    // candidates are kept as bitsets in the arena and only turned into Zoned_Design objects at the end
+    m_candidates.clear();
+    m_temp_candidates.clear();
     size_t designs = 0;
     size_t temp_designs = 0;
     unsigned int expansion = 0;
@@ -2258,15 +2347,11 @@ void Zoned_Design::make_zoning()
             {
                 if (m_zones[i]->get_type() == 10)
                 {
-                    Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                    temp_zoned->m_zones.push_back(m_zones[i]);
-                    temp_zoned->add_cuboids(m_zones[i]);
-                    temp_zoned->base_type = 1;
-                    m_zoned.push_back(temp_zoned);
+                    m_candidates.push_back(Zoned_Design::make_candidate(m_zones[i], 1));
                 }
             }
 
-            designs = m_zoned.size();
+            designs = m_candidates.size();
             if (designs > 0)
             {
                 for (size_t i = 0; i < designs; i++)
@@ -2274,26 +2359,21 @@ void Zoned_Design::make_zoning()
                     expansion = 0;
                     for (unsigned int j = 0; j < m_zones.size(); j++)
                     {
-
-                        Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                        temp_zoned->duplicate(m_zoned[i]);
-                        if (m_zones[j]->get_type() == 10 && temp_zoned->check_double_cuboids(m_zones[j]) == false)
+                        if (m_zones[j]->get_type() == 10 && Zoned_Design::check_double_cuboids(m_candidates[i], m_zones[j]) == false)
                         {
                             expansion++;
-                            temp_zoned->m_zones.push_back(m_zones[j]);
-                            temp_zoned->add_cuboids(m_zones[j]);
-                            std::sort(temp_zoned->m_zones.begin(), temp_zoned->m_zones.end());
-                            std::sort(temp_zoned->m_cuboids.begin(), temp_zoned->m_cuboids.end());
-                            if (Zoned_Design::check_double_designs(temp_zoned) == false)
+                            Zoned_Candidate temp_candidate = m_candidates[i];
+                            Zoned_Design::add_candidate_zone(temp_candidate, m_zones[j]);
+                            if (Zoned_Design::check_double_designs(temp_candidate) == false)
                             {
-                                m_zoned.push_back(temp_zoned);
+                                m_candidates.push_back(temp_candidate);
                                 designs++;
                             }
                         }
                     }
                     if (expansion > 0)
                     {
-                        m_zoned.erase(m_zoned.begin() + i);
+                        m_candidates.erase(m_candidates.begin() + i);
                         designs--;
                         i--;
                     }
@@ -2303,16 +2383,14 @@ void Zoned_Design::make_zoning()
                 {
                     if (m_zones[i]->get_type() != 10)
                     {
-                        for (unsigned int j = 0; j < m_zoned.size(); j++)
+                        for (unsigned int j = 0; j < m_candidates.size(); j++)
                         {
-                            Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                            temp_zoned->duplicate(m_zoned[j]);
-                            if (temp_zoned->check_double_cuboids(m_zones[i]) == false)
+                            if (Zoned_Design::check_double_cuboids(m_candidates[j], m_zones[i]) == false)
                             {
-                                temp_zoned->m_zones.push_back(m_zones[i]);
-                                temp_zoned->add_cuboids(m_zones[i]);
-                                temp_zoned->base_type = m_zones[i]->get_type();
-                                m_zoned.push_back(temp_zoned);
+                                Zoned_Candidate temp_candidate = m_candidates[j];
+                                Zoned_Design::add_candidate_zone(temp_candidate, m_zones[i]);
+                                temp_candidate.base_type = m_zones[i]->get_type();
+                                m_candidates.push_back(temp_candidate);
                             }
                         }
                     }
@@ -2324,80 +2402,69 @@ void Zoned_Design::make_zoning()
         {
             for (unsigned int i = 0; i < m_zones.size(); i++)
             {
-                Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                temp_zoned->m_zones.push_back(m_zones[i]);
-                temp_zoned->add_cuboids(m_zones[i]);
-                temp_zoned->base_type = m_zones[i]->get_type();
-                m_zoned.push_back(temp_zoned);
+                m_candidates.push_back(Zoned_Design::make_candidate(m_zones[i], m_zones[i]->get_type()));
             }
         }
 
-        designs = m_zoned.size();
+        designs = m_candidates.size();
         for (size_t i = 0; i < designs; i++)
         {
             expansion = 0;
             for (unsigned int j = 0; j < m_zones.size(); j++)
             {
-
-                Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                temp_zoned->duplicate(m_zoned[i]);
-                if (temp_zoned->check_double_cuboids(m_zones[j]) == false &&
-                    temp_zoned->base_type != 4 &&
+                if (Zoned_Design::check_double_cuboids(m_candidates[i], m_zones[j]) == false &&
+                    m_candidates[i].base_type != 4 &&
                     (m_zones[j]->get_type() == 1 || m_zones[j]->get_type() == 2 || m_zones[j]->get_type() == 3))
                 {
                     if (delete_expanded_designs == true)
                     {
                         expansion++;
                     }
-                    temp_zoned->m_zones.push_back(m_zones[j]);
-                    temp_zoned->add_cuboids(m_zones[j]);
-                    std::sort(temp_zoned->m_zones.begin(), temp_zoned->m_zones.end());
-                    std::sort(temp_zoned->m_cuboids.begin(), temp_zoned->m_cuboids.end());
-                    if (Zoned_Design::check_double_designs(temp_zoned) == false)
+                    Zoned_Candidate temp_candidate = m_candidates[i];
+                    Zoned_Design::add_candidate_zone(temp_candidate, m_zones[j]);
+                    if (Zoned_Design::check_double_designs(temp_candidate) == false)
                     {
-                        m_zoned.push_back(temp_zoned);
+                        m_candidates.push_back(temp_candidate);
                         designs++;
                     }
                 }
-                else if (temp_zoned->check_double_cuboids(m_zones[j]) == false &&
-                    temp_zoned->base_type == 4 &&
+                else if (Zoned_Design::check_double_cuboids(m_candidates[i], m_zones[j]) == false &&
+                    m_candidates[i].base_type == 4 &&
                     (m_zones[j]->get_type() == 1 || m_zones[j]->get_type() == 4))
                 {
                     //if (delete_expanded_designs == true)
                     {
                         expansion++;
                     }
-                    temp_zoned->m_zones.push_back(m_zones[j]);
-                    temp_zoned->add_cuboids(m_zones[j]);
-                    std::sort(temp_zoned->m_zones.begin(), temp_zoned->m_zones.end());
-                    std::sort(temp_zoned->m_cuboids.begin(), temp_zoned->m_cuboids.end());
-                    if (Zoned_Design::check_double_designs(temp_zoned) == false)
+                    Zoned_Candidate temp_candidate = m_candidates[i];
+                    Zoned_Design::add_candidate_zone(temp_candidate, m_zones[j]);
+                    if (Zoned_Design::check_double_designs(temp_candidate) == false)
                     {
-                        m_zoned.push_back(temp_zoned);
+                        m_candidates.push_back(temp_candidate);
                         designs++;
                     }
                 }
             }
             if (expansion > 0)
             {
-                m_zoned.erase(m_zoned.begin() + i);
+                m_candidates.erase(m_candidates.begin() + i);
                 designs--;
                 i--;
             }
         }
 
         // create appendix zones:
-        designs = m_zoned.size();
+        designs = m_candidates.size();
         for (size_t i = 0; i < designs; i++)
         {
-            if (m_zoned[i]->m_cuboids.size() < m_cuboids.size())
+            if (m_candidates[i].m_cuboid_bits.count() < m_cuboids.size())
             {
                 unsigned int last_appendix = m_zones.size();
-                Zoned_Design::get_missing_cuboids(m_zoned[i]);
-                Zoned_Design::create_appendix_zones(m_zoned[i]->base_type);
+                Zoned_Design::get_missing_cuboids(m_candidates[i]);
+                Zoned_Design::create_appendix_zones(m_candidates[i].base_type);
                 for (unsigned int j = 0; j < m_appendix_zones.size(); j++)
                 {
-                    if (m_zoned[i]->base_type != 4 && m_appendix_zones[j]->get_type() != 8)
+                    if (m_candidates[i].base_type != 4 && m_appendix_zones[j]->get_type() != 8)
                     {
                         if (Zoned_Design::check_double_zones(m_appendix_zones[j]) == false)
                         {
@@ -2410,7 +2477,7 @@ void Zoned_Design::make_zoning()
                             last_appendix--;
                         }
                     }
-                    else if (m_zoned[i]->base_type == 4)
+                    else if (m_candidates[i].base_type == 4)
                     {
                         if (Zoned_Design::check_double_zones(m_appendix_zones[j]) == false)
                         {
@@ -2426,68 +2493,59 @@ void Zoned_Design::make_zoning()
                     }
                 }
                 m_appendix_zones.clear();
-                m_temp_zoned.push_back(m_zoned[i]);
-                m_zoned.erase(m_zoned.begin() + i);
+                m_temp_candidates.push_back(m_candidates[i]);
+                m_candidates.erase(m_candidates.begin() + i);
                 i--;
                 designs--;
-                temp_designs = m_temp_zoned.size();
+                temp_designs = m_temp_candidates.size();
                 for (size_t j = 0; j < temp_designs; j++)
                 {
                     expansion = 0;
                     for (unsigned int k = last_appendix; k < m_zones.size(); k++)
                     {
-
-                        Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                        temp_zoned->duplicate(m_temp_zoned[j]);
-                        if (temp_zoned->check_double_cuboids(m_zones[k]) == false &&
-                            temp_zoned->base_type != 4) //&& m_zones[k]->get_type() != 8)
+                        if (Zoned_Design::check_double_cuboids(m_temp_candidates[j], m_zones[k]) == false &&
+                            m_temp_candidates[j].base_type != 4) //&& m_zones[k]->get_type() != 8)
                         {
                             expansion++;
-                            temp_zoned->m_zones.push_back(m_zones[k]);
-                            temp_zoned->add_cuboids(m_zones[k]);
-                            std::sort(temp_zoned->m_zones.begin(), temp_zoned->m_zones.end());
-                            std::sort(temp_zoned->m_cuboids.begin(), temp_zoned->m_cuboids.end());
-                            if (Zoned_Design::check_double_temp_designs(temp_zoned) == false)
+                            Zoned_Candidate temp_candidate = m_temp_candidates[j];
+                            Zoned_Design::add_candidate_zone(temp_candidate, m_zones[k]);
+                            if (Zoned_Design::check_double_temp_designs(temp_candidate) == false)
                             {
-                                m_temp_zoned.push_back(temp_zoned);
+                                m_temp_candidates.push_back(temp_candidate);
                                 temp_designs++;
                             }
                         }
-                        if (temp_zoned->check_double_cuboids(m_zones[k]) == false &&
-                            temp_zoned->base_type == 4 &&
+                        if (Zoned_Design::check_double_cuboids(m_temp_candidates[j], m_zones[k]) == false &&
+                            m_temp_candidates[j].base_type == 4 &&
                             (m_zones[k]->get_type() == 5 || m_zones[k]->get_type() == 1 ||
                             m_zones[k]->get_type() == 4 || m_zones[k]->get_type() == 8))
                         {
                             expansion++;
-                            temp_zoned->m_zones.push_back(m_zones[k]);
-                            temp_zoned->add_cuboids(m_zones[k]);
-                            std::sort(temp_zoned->m_zones.begin(), temp_zoned->m_zones.end());
-                            std::sort(temp_zoned->m_cuboids.begin(), temp_zoned->m_cuboids.end());
-                            if (Zoned_Design::check_double_temp_designs(temp_zoned) == false)
+                            Zoned_Candidate temp_candidate = m_temp_candidates[j];
+                            Zoned_Design::add_candidate_zone(temp_candidate, m_zones[k]);
+                            if (Zoned_Design::check_double_temp_designs(temp_candidate) == false)
                             {
-                                m_temp_zoned.push_back(temp_zoned);
+                                m_temp_candidates.push_back(temp_candidate);
                                 temp_designs++;
                             }
                         }
                     }
                     if (expansion > 0)
                     {
-                        m_temp_zoned.erase(m_temp_zoned.begin() + j);
+                        m_temp_candidates.erase(m_temp_candidates.begin() + j);
                         temp_designs--;
                         j--;
                     }
                 }
-                for (unsigned int j = 0; j < m_temp_zoned.size(); j++)
+                for (unsigned int j = 0; j < m_temp_candidates.size(); j++)
                 {
-                    Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                    temp_zoned->duplicate(m_temp_zoned[j]);
-                    if (Zoned_Design::check_double_designs(temp_zoned) == false)
+                    if (Zoned_Design::check_double_designs(m_temp_candidates[j]) == false)
                     {
-                    m_zoned.push_back(temp_zoned);
+                    m_candidates.push_back(m_temp_candidates[j]);
                     designs++;
                     }
                 }
-                m_temp_zoned.clear();
+                m_temp_candidates.clear();
 
             } // if zoned.cuboids < cuboids
         } // create appendix zones
@@ -2504,15 +2562,11 @@ void Zoned_Design::make_zoning()
             {
                 if (m_zones[i]->get_type() == 10)
                 {
-                    Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                    temp_zoned->m_zones.push_back(m_zones[i]);
-                    temp_zoned->add_cuboids(m_zones[i]);
-                    temp_zoned->base_type = 1;
-                    m_zoned.push_back(temp_zoned);
+                    m_candidates.push_back(Zoned_Design::make_candidate(m_zones[i], 1));
                 }
             }
 
-            designs = m_zoned.size();
+            designs = m_candidates.size();
             if (designs > 0)
             {
                 for (size_t i = 0; i < designs; i++)
@@ -2520,26 +2574,21 @@ void Zoned_Design::make_zoning()
                     expansion = 0;
                     for (unsigned int j = 0; j < m_zones.size(); j++)
                     {
-
-                        Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                        temp_zoned->duplicate(m_zoned[i]);
-                        if (m_zones[j]->get_type() == 10 && temp_zoned->check_double_cuboids(m_zones[j]) == false)
+                        if (m_zones[j]->get_type() == 10 && Zoned_Design::check_double_cuboids(m_candidates[i], m_zones[j]) == false)
                         {
                             expansion++;
-                            temp_zoned->m_zones.push_back(m_zones[j]);
-                            temp_zoned->add_cuboids(m_zones[j]);
-                            std::sort(temp_zoned->m_zones.begin(), temp_zoned->m_zones.end());
-                            std::sort(temp_zoned->m_cuboids.begin(), temp_zoned->m_cuboids.end());
-                            if (Zoned_Design::check_double_designs(temp_zoned) == false)
+                            Zoned_Candidate temp_candidate = m_candidates[i];
+                            Zoned_Design::add_candidate_zone(temp_candidate, m_zones[j]);
+                            if (Zoned_Design::check_double_designs(temp_candidate) == false)
                             {
-                                m_zoned.push_back(temp_zoned);
+                                m_candidates.push_back(temp_candidate);
                                 designs++;
                             }
                         }
                     }
                     if (expansion > 0)
                     {
-                        m_zoned.erase(m_zoned.begin() + i);
+                        m_candidates.erase(m_candidates.begin() + i);
                         designs--;
                         i--;
                     }
@@ -2549,16 +2598,14 @@ void Zoned_Design::make_zoning()
                 {
                     if (m_zones[i]->get_type() == 1 || m_zones[i]->get_type() == 4)
                     {
-                        for (unsigned int j = 0; j < m_zoned.size(); j++)
+                        for (unsigned int j = 0; j < m_candidates.size(); j++)
                         {
-                            Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                            temp_zoned->duplicate(m_zoned[j]);
-                            if (temp_zoned->check_double_cuboids(m_zones[i]) == false)
+                            if (Zoned_Design::check_double_cuboids(m_candidates[j], m_zones[i]) == false)
                             {
-                                temp_zoned->m_zones.push_back(m_zones[i]);
-                                temp_zoned->add_cuboids(m_zones[i]);
-                                temp_zoned->base_type = m_zones[i]->get_type();
-                                m_zoned.push_back(temp_zoned);
+                                Zoned_Candidate temp_candidate = m_candidates[j];
+                                Zoned_Design::add_candidate_zone(temp_candidate, m_zones[i]);
+                                temp_candidate.base_type = m_zones[i]->get_type();
+                                m_candidates.push_back(temp_candidate);
                             }
                         }
                     }
@@ -2572,59 +2619,50 @@ void Zoned_Design::make_zoning()
             {
                 if (m_zones[i]->get_type() == 1 || m_zones[i]->get_type() == 4)
                 {
-                    Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                    temp_zoned->m_zones.push_back(m_zones[i]);
-                    temp_zoned->add_cuboids(m_zones[i]);
-                    temp_zoned->base_type = m_zones[i]->get_type();
-                    m_zoned.push_back(temp_zoned);
+                    m_candidates.push_back(Zoned_Design::make_candidate(m_zones[i], m_zones[i]->get_type()));
                 }
             }
         }
 
-        designs = m_zoned.size();
+        designs = m_candidates.size();
         for (size_t i = 0; i < designs; i++)
         {
             expansion = 0;
             for (unsigned int j = 0; j < m_zones.size(); j++)
             {
-
-                Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                temp_zoned->duplicate(m_zoned[i]);
-                if (temp_zoned->check_double_cuboids(m_zones[j]) == false &&
+                if (Zoned_Design::check_double_cuboids(m_candidates[i], m_zones[j]) == false &&
                     (m_zones[j]->get_type() == 1 || m_zones[j]->get_type() == 4))
                 {
-                    //if (delete_expanded_designs == true && m_zoned[i]->base_type != 4)
+                    //if (delete_expanded_designs == true && m_candidates[i].base_type != 4)
                     {
                         expansion++;
                     }
-                    temp_zoned->m_zones.push_back(m_zones[j]);
-                    temp_zoned->add_cuboids(m_zones[j]);
-                    std::sort(temp_zoned->m_zones.begin(), temp_zoned->m_zones.end());
-                    std::sort(temp_zoned->m_cuboids.begin(), temp_zoned->m_cuboids.end());
-                    if (Zoned_Design::check_double_designs(temp_zoned) == false)
+                    Zoned_Candidate temp_candidate = m_candidates[i];
+                    Zoned_Design::add_candidate_zone(temp_candidate, m_zones[j]);
+                    if (Zoned_Design::check_double_designs(temp_candidate) == false)
                     {
-                        m_zoned.push_back(temp_zoned);
+                        m_candidates.push_back(temp_candidate);
                         designs++;
                     }
                 }
             }
             if (expansion > 0)
             {
-                m_zoned.erase(m_zoned.begin() + i);
+                m_candidates.erase(m_candidates.begin() + i);
                 designs--;
                 i--;
             }
         }
 
         // create appendix zones:
-        designs = m_zoned.size();
+        designs = m_candidates.size();
         for (size_t i = 0; i < designs; i++)
         {
-            if (m_zoned[i]->m_cuboids.size() < m_cuboids.size())
+            if (m_candidates[i].m_cuboid_bits.count() < m_cuboids.size())
             {
                 unsigned int last_appendix = m_zones.size();
-                Zoned_Design::get_missing_cuboids(m_zoned[i]);
-                Zoned_Design::create_appendix_zones(m_zoned[i]->base_type);
+                Zoned_Design::get_missing_cuboids(m_candidates[i]);
+                Zoned_Design::create_appendix_zones(m_candidates[i].base_type);
                 for (unsigned int j = 0; j < m_appendix_zones.size(); j++)
                 {
                     if (Zoned_Design::check_double_zones(m_appendix_zones[j]) == false)
@@ -2639,58 +2677,58 @@ void Zoned_Design::make_zoning()
                     }
                 }
                 m_appendix_zones.clear();
-                m_temp_zoned.push_back(m_zoned[i]);
-                m_zoned.erase(m_zoned.begin() + i);
+                m_temp_candidates.push_back(m_candidates[i]);
+                m_candidates.erase(m_candidates.begin() + i);
                 i--;
                 designs--;
-                temp_designs = m_temp_zoned.size();
+                temp_designs = m_temp_candidates.size();
                 for (size_t j = 0; j < temp_designs; j++)
                 {
                     expansion = 0;
                     for (unsigned int k = last_appendix; k < m_zones.size(); k++)
                     {
-
-                        Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                        temp_zoned->duplicate(m_temp_zoned[j]);
-                        if (temp_zoned->check_double_cuboids(m_zones[k]) == false &&
+                        if (Zoned_Design::check_double_cuboids(m_temp_candidates[j], m_zones[k]) == false &&
                             (m_zones[k]->get_type() == 5 || m_zones[k]->get_type() == 1 ||
                             m_zones[k]->get_type() == 4|| m_zones[k]->get_type() == 8))
                         {
                             expansion++;
-                            temp_zoned->m_zones.push_back(m_zones[k]);
-                            temp_zoned->add_cuboids(m_zones[k]);
-                            std::sort(temp_zoned->m_zones.begin(), temp_zoned->m_zones.end());
-                            std::sort(temp_zoned->m_cuboids.begin(), temp_zoned->m_cuboids.end());
-                            if (Zoned_Design::check_double_temp_designs(temp_zoned) == false)
+                            Zoned_Candidate temp_candidate = m_temp_candidates[j];
+                            Zoned_Design::add_candidate_zone(temp_candidate, m_zones[k]);
+                            if (Zoned_Design::check_double_temp_designs(temp_candidate) == false)
                             {
-                                m_temp_zoned.push_back(temp_zoned);
+                                m_temp_candidates.push_back(temp_candidate);
                                 temp_designs++;
                             }
                         }
                     }
                     if (expansion > 0)
                     {
-                        m_temp_zoned.erase(m_temp_zoned.begin() + j);
+                        m_temp_candidates.erase(m_temp_candidates.begin() + j);
                         temp_designs--;
                         j--;
                     }
                 }
-                for (unsigned int j = 0; j < m_temp_zoned.size(); j++)
+                for (unsigned int j = 0; j < m_temp_candidates.size(); j++)
                 {
-                    Zoned_Design* temp_zoned = new Zoned_Design(m_CF);
-                    temp_zoned->duplicate(m_temp_zoned[j]);
-                    if (Zoned_Design::check_double_designs(temp_zoned) == false)
+                    if (Zoned_Design::check_double_designs(m_temp_candidates[j]) == false)
                     {
-                    m_zoned.push_back(temp_zoned);
+                    m_candidates.push_back(m_temp_candidates[j]);
                     designs++;
                     }
                 }
-                m_temp_zoned.clear();
+                m_temp_candidates.clear();
 
             } // if zoned.cuboids < cuboids
         } // create appendix zones
     } // switch: whole spaces only
 
+    // materialize the remaining candidates into zoned designs and release the arena
+    for (unsigned int i = 0; i < m_candidates.size(); i++)
+    {
+        m_zoned.push_back(Zoned_Design::materialize(m_candidates[i]));
+    }
+    m_candidates.clear();
+    m_candidates.shrink_to_fit();
     // delete unused zones
     zones = m_zones.size();
     for (size_t i = 0; i < zones; i++)
@@ -2792,7 +2830,9 @@ void Zoned_Design::make_zoning()
 
 Zoned_Design* Zoned_Design::make_zoning2(const std::vector<unsigned int>& zoneIDs) {
     std::cout << "test 0 start make zoning" << std::endl;
-    Zoned_Design* newZonedDesign = new Zoned_Design(m_CF);
+    std::shared_ptr<Zoned_Design> owned_design(new Zoned_Design(m_CF, zoning_settings));
+    m_owned_designs.push_back(owned_design);
+    Zoned_Design* newZonedDesign = owned_design.get();
     std::cout << "input: ";
     for (const auto& id : zoneIDs) {
         std::cout << id << " ";
@@ -2,9 +2,14 @@
 #define ZONING_HPP
 
 #include <vector>
+#include <map>
+#include <memory>
 #include <algorithm>
 #include <iostream>
 
+#include <boost/dynamic_bitset.hpp>
+
+#include <BSO/Profiler.hpp>
 #include <BSO/Spatial_Design/Conformation.hpp>
 #include <BSO/Spatial_Design/Zoning/Zone.hpp>
 #include <BSO/Spatial_Design/Geometry/Geometry.hpp>
@@ -12,6 +17,19 @@
 
 namespace BSO { namespace Spatial_Design { namespace Zoning {
 
+struct Zoned_Candidate
+{ // compact representation of a zoned design while it is being generated in make_zoning()
+	boost::dynamic_bitset<> m_zone_bits; // bit i is set if zone i of the root's zone pool is part of the candidate
+	boost::dynamic_bitset<> m_cuboid_bits; // bit i is set if cuboid i is covered by one of the candidate's zones
+	unsigned int base_type = 0;
+}; // Zoned_Candidate
+
+struct Zoned_SD_Results
+{ // structural performance of one zoned design, see Zoned_Design::analyse_zoned_designs()
+	double m_total_compliance = 0;
+	double m_struct_volume = 0;
+}; // Zoned_SD_Results
+
 class Zoned_Design
 {
 private:
@@ -24,7 +42,11 @@ private:
 	std::vector<int> m_floors;
 	std::vector<int> m_floor_coords;
 	std::vector<Zoned_Design*> m_zoned;
-	std::vector<Zoned_Design*> m_temp_zoned;
+	std::vector<std::shared_ptr<Zoned_Design> > m_owned_designs; // designs created by this root, released with it
+	std::vector<Zone*> m_zone_pool; // every zone that is referenced by a candidate, indexed by its bit
+	std::map<Zone*, unsigned int> m_zone_bit; // bit of each zone in m_zone_pool
+	std::vector<Zoned_Candidate> m_candidates; // arena of candidate designs, materialized into m_zoned
+	std::vector<Zoned_Candidate> m_temp_candidates;
 	std::vector<Geometry::Cuboid*> m_temp_cuboids;
 	std::vector<Geometry::Space*> m_spaces;
 	std::vector<Geometry::Vertex*> m_vertices;
@@ -50,6 +72,16 @@ private:
 	int ID;
 	// switches
 
+	Zoned_Design(MS_Conformal* CF, const Grammar::Zoning_Settings& settings);
+	unsigned int get_zone_bit(Zone*);
+	Zoned_Candidate make_candidate(Zone*, unsigned int);
+	void add_candidate_zone(Zoned_Candidate&, Zone*);
+	bool check_double_cuboids(const Zoned_Candidate&, Zone*);
+	bool check_double_designs(const Zoned_Candidate&);
+	bool check_double_temp_designs(const Zoned_Candidate&);
+	void get_missing_cuboids(const Zoned_Candidate&);
+	Zoned_Design* materialize(const Zoned_Candidate&);
+
 public:
 	Zoned_Design(MS_Conformal* CF);
 	~Zoned_Design();
@@ -70,14 +102,10 @@ public:
 	bool check_double_cuboids(Zone*);
 	void add_cuboids(Zone*);
 	std::vector<Zone*> get_zones();
-	bool check_double_designs(Zoned_Design*);
-	bool check_double_temp_designs(Zoned_Design*);
-	void get_missing_cuboids(Zoned_Design*);
 	bool check_double_appendix_zones(Zone*);
 	unsigned int get_double_appendix_zone(Zone*);
 	void add_appendix_zone(Zone*, unsigned int);
 	void create_appendix_zones(unsigned int);
-	void duplicate(Zoned_Design*);
 	std::vector<Zone*> get_intersecting_zones(Zone*, unsigned int);
 	std::vector<Zoned_Design*> get_designs();
 	std::vector<Geometry::Cuboid*> get_cuboids();
@@ -97,6 +125,8 @@ public:
 	double get_unzoned_compliance();
 	std::pair<double, unsigned int> get_min_compliance();
 	double get_compliance(unsigned int);
+	std::vector<Zoned_SD_Results> analyse_zoned_designs(unsigned int n_threads = 0); // requires BSO/Structural_Design/SD_Analysis.hpp, builds the models serially in the shared CF and analyses them in parallel
+	std::vector<Zoned_SD_Results> screen_zoned_designs_shared(); // as analyse_zoned_designs(), but on one shared mesh for all zoned designs, requires BSO/Structural_Design/SD_Analysis.hpp
 
 	Zone* get_zone_by_ID(int ID);
 	void make_zoning();
@@ -125,4 +155,8 @@ public:
 
 #include <BSO/Spatial_Design/Zoning.cpp>
 
+#ifdef SD_ANALYSIS_HPP
+#include <BSO/Spatial_Design/Zoning/Zoned_SD_Analysis.cpp>
+#endif // SD_ANALYSIS_HPP
+
 #endif //ZONING_HPP
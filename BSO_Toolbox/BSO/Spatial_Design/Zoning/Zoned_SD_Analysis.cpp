@@ -0,0 +1,188 @@
+#ifndef ZONED_SD_ANALYSIS_CPP
+#define ZONED_SD_ANALYSIS_CPP
+
+/*
+ * Batch structural evaluation of the zoned designs of a Zoned_Design,
+ * either one model per zoned design or one shared mesh for all of them.
+ * Both build their models from the tags that prepare_zoned_SD_model() sets in
+ * the shared conformal model, so the models are built one at a time on the
+ * calling thread and the tags are cleared again when the evaluation is done.
+ * Included by Zoning.hpp and SD_Analysis.hpp, whichever comes last.
+ */
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <algorithm>
+
+namespace BSO { namespace Spatial_Design { namespace Zoning {
+
+std::vector<Zoned_SD_Results> Zoned_Design::analyse_zoned_designs(unsigned int n_threads)
+{
+    if (n_threads == 0)
+    {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<Zoned_SD_Results> results(m_zoned.size());
+    std::deque<std::pair<unsigned int, Structural_Design::SD_Analysis*> > models; // models waiting to be analysed
+    std::mutex models_mutex;
+    std::condition_variable models_cv;
+    bool all_models_built = false;
+
+    // the workers only analyse models that are already built, a built model holds its own points, components and mesh
+    // and does not read the conformal model, which is changed by the calling thread in the meantime (see below)
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < n_threads; i++)
+    {
+        workers.push_back(std::thread([&]()
+        {
+            while (true)
+            {
+                std::pair<unsigned int, Structural_Design::SD_Analysis*> model;
+                {
+                    std::unique_lock<std::mutex> lock(models_mutex);
+                    models_cv.wait(lock, [&]() { return !models.empty() || all_models_built; });
+                    if (models.empty())
+                    {
+                        return;
+                    }
+                    model = models.front();
+                    models.pop_front();
+                }
+                models_cv.notify_all(); // a slot in the queue came free
+
+                model.second->analyse();
+                Structural_Design::SD_Building_Results sd_results = model.second->get_results();
+                results[model.first].m_total_compliance = sd_results.m_total_compliance;
+                results[model.first].m_struct_volume = sd_results.m_struct_volume;
+                delete model.second;
+            }
+        }));
+    }
+
+    // building a model is not parallel: prepare_zoned_SD_model() tags the shared conformal model for design i and the
+    // SD grammar reads (and adds to) these tags, so the models are built one at a time on this thread while the workers
+    // analyse the models built before; at most n_threads built models are kept waiting
+    for (unsigned int i = 0; i < m_zoned.size(); i++)
+    {
+        Zoned_Design::reset_SD_model();
+        Zoned_Design::prepare_zoned_SD_model(i);
+        Structural_Design::SD_Analysis* SD_Building = new Structural_Design::SD_Analysis(*m_CF);
+
+        std::unique_lock<std::mutex> lock(models_mutex);
+        models_cv.wait(lock, [&]() { return models.size() < n_threads; });
+        models.push_back(std::make_pair(i, SD_Building));
+        lock.unlock();
+        models_cv.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(models_mutex);
+        all_models_built = true;
+    }
+    models_cv.notify_all();
+
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    // clear the zoning tags from the conformal model and store the compliances with the zoned designs
+    Zoned_Design::reset_SD_model();
+    for (unsigned int i = 0; i < results.size(); i++)
+    {
+        Zoned_Design::add_compliance(results[i].m_total_compliance, i);
+    }
+
+    return results;
+} // analyse_zoned_designs()
+
+std::vector<Zoned_SD_Results> Zoned_Design::screen_zoned_designs_shared()
+{ // meshes the models of all zoned designs once as one model: a component that is the same in several zoned designs (see Component::same_as())
+  // is meshed once, a component that differs (e.g. another adaptive thickness, a ghost floor, or a member that another design replaces by a
+  // flat shell) is added as a variant of its own; each zoned design is then analysed as the selection of its own components, so the results
+  // equal those of analyse_zoned_designs() and are stored with the zoned designs in the same way
+    Structural_Design::SD_Analysis SD_Building;
+    std::vector<std::vector<unsigned int> > design_components(m_zoned.size()); // the components of the shared model that make each zoned design
+
+    for (unsigned int i = 0; i < m_zoned.size(); i++)
+    {
+        Zoned_Design::reset_SD_model();
+        Zoned_Design::prepare_zoned_SD_model(i);
+        Structural_Design::SD_Analysis* SD_design = (i == 0) ? &SD_Building : new Structural_Design::SD_Analysis;
+        m_CF->request_SD_grammar()(m_CF, SD_design);
+
+        for (unsigned int j = 0; j < SD_design->m_points.size(); j++)
+        { // a selection of components only carries the loads and constraints of these components
+            std::vector<bool> constraints = SD_design->m_points[j]->get_constraints();
+            if (!SD_design->m_points[j]->get_loads().empty() || std::find(constraints.begin(), constraints.end(), true) != constraints.end())
+            {
+                std::cerr << "Error, the SD grammar put loads or constraints on a point instead of a component, "
+                          << "cannot share a mesh between the zoned designs, exiting now... (Zoned_SD_Analysis.cpp)" << std::endl;
+                exit(1);
+            }
+        }
+
+        if (i == 0)
+        { // the model of the first zoned design is the start of the shared model
+            for (unsigned int j = 0; j < SD_Building.m_components.size(); j++)
+            {
+                design_components[0].push_back(j);
+            }
+            continue;
+        }
+
+        // each component of the shared model can be used once per zoned design (a design may hold two equal components)
+        std::vector<bool> used(SD_Building.m_components.size(), false);
+        for (unsigned int j = 0; j < SD_design->m_components.size(); j++)
+        {
+            Structural_Design::Components::Component* comp_ptr = SD_design->m_components[j];
+            unsigned int k = 0;
+            while (k < used.size() && (used[k] || !SD_Building.m_components[k]->same_as(comp_ptr)))
+            {
+                k++;
+            }
+
+            if (k == used.size())
+            { // a variant that is not in the shared model yet
+                comp_ptr->merge_points(SD_Building.m_points);
+                SD_Building.m_components.push_back(comp_ptr);
+                SD_design->m_components[j] = nullptr; // now owned by SD_Building
+                used.push_back(true);
+            }
+            used[k] = true;
+            design_components[i].push_back(k);
+        }
+        SD_design->m_components.erase(std::remove(SD_design->m_components.begin(), SD_design->m_components.end(), nullptr), SD_design->m_components.end());
+        delete SD_design; // with its points and the components that are shared
+    }
+    Zoned_Design::reset_SD_model(); // clear the zoning tags from the conformal model
+
+    SD_Building.mesh_shared(SD_Building.m_mesh_division);
+
+    std::vector<Zoned_SD_Results> results(m_zoned.size());
+    for (unsigned int i = 0; i < m_zoned.size(); i++)
+    {
+        std::vector<bool> active_components(SD_Building.m_components.size(), false);
+        for (unsigned int j = 0; j < design_components[i].size(); j++)
+        {
+            active_components[design_components[i][j]] = true;
+        }
+
+        SD_Building.activate_components(active_components);
+        SD_Building.analyse();
+        Structural_Design::SD_Building_Results sd_results = SD_Building.get_results();
+        results[i].m_total_compliance = sd_results.m_total_compliance;
+        results[i].m_struct_volume = sd_results.m_struct_volume;
+        Zoned_Design::add_compliance(results[i].m_total_compliance, i);
+    }
+
+    return results;
+} // screen_zoned_designs_shared()
+
+} // namespace Zoning
+} // namespace Spatial_Design
+} // namespace BSO
+
+#endif // ZONED_SD_ANALYSIS_CPP
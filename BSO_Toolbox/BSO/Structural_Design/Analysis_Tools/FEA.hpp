@@ -2,14 +2,14 @@
 #define FEA_HPP
 
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Field_Scanner.hpp>
+#include <BSO/Profiler.hpp>
 #include <BSO/Structural_Design/Components/Component.hpp>
 #include <BSO/Structural_Design/Elements/Node_Ele.hpp>
 #include <BSO/Structural_Design/Elements/Truss_Ele.hpp>
 #include <BSO/Structural_Design/Elements/Beam_Ele.hpp>
 #include <BSO/Structural_Design/Elements/Flat_Shell_Ele.hpp>
 
-#include <boost/tokenizer.hpp>
-#include <boost/algorithm/string/trim.hpp>
 
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
@@ -31,7 +31,7 @@ namespace BSO { namespace Structural_Design {
     {
     private:
         friend class SD_Analysis;
-        friend void topopt_SIMP(FEA* fea_ptr, double f, double r_min, double penal, double x_move, double tol);
+        friend void topopt_SIMP(FEA* fea_ptr, double f, double r_min, double penal, double x_move, double tol, unsigned int max_loops);
         friend void topopt_SIMP_diff_elements(FEA* fea_ptr, double f, double r_min, double penal, double x_move, double tol);
         friend void topopt_SIMP_old(FEA* fea_ptr, double f, double r_min, double penal, double x_move, double tol);
         friend void topopt_SIMP_old2(FEA* fea_ptr, double f, double r_min, double penal, double x_move, double tol);
@@ -40,6 +40,7 @@ namespace BSO { namespace Structural_Design {
         std::map<unsigned long, Elements::Node*> m_node_map;
 
         std::vector<Elements::Element*> m_elements;
+        std::vector<bool> m_active_elements; // elements that are assembled into the system, if empty all elements are
 
         unsigned long m_dof_count;
         std::vector<unsigned int> m_load_cases;
@@ -52,6 +53,9 @@ namespace BSO { namespace Structural_Design {
         void add_node(unsigned long ID, double x, double y, double z); // adds a node to the node map, but checks for duplicate ID's first
 		void add_node(Components::Point* point); // adds a point and the loads and constraints acting on it
         void add_node(Components::Point* point, bool activate_dofs); // adds a point and the loads and constraints acting on it
+        void update_node(Components::Point* point, bool activate_dofs); // resets the node of a point and adds the loads and constraints acting on it again
+        void set_active_elements(const std::vector<bool>& active_elements); // only the active elements are assembled into the system
+        bool is_active(unsigned int n); // checks if element n is assembled into the system
         void add_elements(Components::Component* component); // adds all elements in a component
         Elements::Node* get_node(unsigned long ID);
         void generate_system(); // generates freedom tables etc.
@@ -84,7 +88,7 @@ namespace BSO { namespace Structural_Design {
 
     FEA::FEA(std::string file_name)
     {
-        std::ifstream input(file_name.c_str()); // initialize input stream from file: file_name
+        Field_Scanner input(file_name, ","); // reads the file, fields are separated by a ','
 
         if (!input.is_open())
         {
@@ -92,45 +96,22 @@ namespace BSO { namespace Structural_Design {
             exit(1);
         }
 
-        std::string line;
-        boost::char_separator<char> sep(","); // defines what separates tokens in a string
-        typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
-        std::string type_ID; // holds information about what type of information is described by the line currently read
-
-        while (!input.eof())
-        {
-            getline(input,line); // get next line from the file
-            boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
-            if (line == "") //skip empty lines (tokenizer does not like it)
-            {
-                continue; // continue to next line
-            }
-
-            t_tokenizer tok(line, sep); // tokenize the line
-            t_tokenizer::iterator token = tok.begin(); // set iterator to first token
-            type_ID = *token; // interpret first token as type ID
-            boost::algorithm::trim(type_ID);
-
-            if (type_ID == "N")
+        while (input.next_line()) // empty lines are skipped
+        { // the first token holds information about what type of information is described by the line
+            if (input.field_is(0, "N"))
             {   // this reads a node
-                token++; // next token is ID
-                unsigned long ID = BSO::trim_and_cast_ulong(*token);
-                token++; // next token is x-coordinate
-                int x = BSO::trim_and_cast_double(*token);
-                token++; // next token is y-coordinate
-                int y = BSO::trim_and_cast_double(*token);
-                token++; // next token is z-coordinate
-                int z = BSO::trim_and_cast_double(*token);
+                unsigned long ID = input.get_ulong(1); // ID
+                int x = input.get_double(2); // x-coordinate
+                int y = input.get_double(3); // y-coordinate
+                int z = input.get_double(4); // z-coordinate
 
                 add_node(ID,x,y,z);
             }
 
-            else if (type_ID == "T")
+            else if (input.field_is(0, "T"))
             {   // this reads a truss element
-                token++; // next token is n1, first node_ID
-                unsigned long n1 = BSO::trim_and_cast_ulong(*token);
-                token++; // next token is n2, first node_ID
-                unsigned long n2 = BSO::trim_and_cast_ulong(*token);
+                unsigned long n1 = input.get_ulong(1); // n1, first node_ID
+                unsigned long n2 = input.get_ulong(2); // n2, second node_ID
 
                 double A = 1000;
                 double E = 200000;
@@ -141,12 +122,10 @@ namespace BSO { namespace Structural_Design {
                 m_elements.push_back(new Elements::Truss(A, E, n_ptr_1, n_ptr_2));
             }
 
-            else if (type_ID == "B")
+            else if (input.field_is(0, "B"))
             {   // this reads a beam element
-                token++; // next token is n1, first node_ID
-                unsigned long n1 = BSO::trim_and_cast_int(*token);
-                token++; // next token is n2, first node_ID
-                unsigned long n2 = BSO::trim_and_cast_int(*token);
+                unsigned long n1 = input.get_int(1); // n1, first node_ID
+                unsigned long n2 = input.get_int(2); // n2, second node_ID
 
                 double b = 300;
                 double h = 300;
@@ -159,16 +138,12 @@ namespace BSO { namespace Structural_Design {
                 m_elements.push_back(new Elements::Beam(b, h, E, v, n_ptr_1, n_ptr_2));
             }
 
-            else if (type_ID == "A")
+            else if (input.field_is(0, "A"))
             {   // this reads a shell element
-                token++; // next token is the first node of the element
-                unsigned long n1 = BSO::trim_and_cast_int(*token);
-                token++; // second node
-                unsigned long n2 = BSO::trim_and_cast_int(*token);
-                token++; // third node
-                unsigned long n3 = BSO::trim_and_cast_int(*token);
-                token++; // fourth node
-                unsigned long n4 = BSO::trim_and_cast_int(*token);
+                unsigned long n1 = input.get_int(1); // the first node of the element
+                unsigned long n2 = input.get_int(2); // second node
+                unsigned long n3 = input.get_int(3); // third node
+                unsigned long n4 = input.get_int(4); // fourth node
 
                 double t = 150;
                 double E = 30000;
@@ -182,17 +157,12 @@ namespace BSO { namespace Structural_Design {
                 m_elements.push_back(new Elements::Flat_Shell(t, E, v, n_ptr_1, n_ptr_2, n_ptr_3, n_ptr_4));
             }
 
-            else if (type_ID == "F")
+            else if (input.field_is(0, "F"))
             {   // this reads a load
-                token++; // next token is the node_ID on which the load acts
-                unsigned long fnID = BSO::trim_and_cast_ulong(*token);
-                token++; // next token is the direction in which the load acts
-                std::string direction = *token;
-                boost::algorithm::trim(direction);
-                token++; // next token is the magnitude of the load
-                double load = BSO::trim_and_cast_double(*token);
-                token++; // next token is the ID of the load combination to which the load belongs
-                unsigned int lc = BSO::trim_and_cast_uint(*token);
+                unsigned long fnID = input.get_ulong(1); // the node_ID on which the load acts
+                std::string direction = input.get_string(2); // the direction in which the load acts
+                double load = input.get_double(3); // the magnitude of the load
+                unsigned int lc = input.get_uint(4); // the ID of the load combination to which the load belongs
 
                 if (std::find(m_load_cases.begin(), m_load_cases.end(), lc) == m_load_cases.end())
                 { // the load case does not yet exist
@@ -207,13 +177,10 @@ namespace BSO { namespace Structural_Design {
                 temp_ptr->add_load(lc, direction, load); // add the load to the node
             }
 
-            else if (type_ID == "D")
+            else if (input.field_is(0, "D"))
             {   // this reads constraint
-                token++; // next token is the node_ID on which the constraint acts
-                int cnID = BSO::trim_and_cast_int(*token);
-                token++; // next token is the degree of freedom in which the constraint prevents displacement
-                std::string dof = *token;
-                boost::algorithm::trim(dof);
+                int cnID = input.get_int(1); // the node_ID on which the constraint acts
+                std::string dof = input.get_string(2); // the degree of freedom in which the constraint prevents displacement
 
                 Elements::Node* temp_ptr = get_node(cnID);
 
@@ -226,7 +193,6 @@ namespace BSO { namespace Structural_Design {
             else {continue;}
         } // end if
 
-        input.close(); // close the input file
         generate_system(); // generate the global stiffness matrix and global load vector
     } // ctor
 
@@ -250,6 +216,7 @@ namespace BSO { namespace Structural_Design {
             delete m_elements[i];
         }
         m_elements.clear();
+        m_active_elements.clear();
 
         m_dof_count = 0;
         m_load_cases.clear();
@@ -285,9 +252,14 @@ namespace BSO { namespace Structural_Design {
         Eigen::Vector3d coords = point->get_coords();
 
         add_node(ID,coords(0),coords(1),coords(2));
+        update_node(point, activate_dofs);
+    } // add_node(Point*)
 
-        // retrieve the pointer to the newly created node
-        Elements::Node* node_ptr = get_node(ID);
+    void FEA::update_node(Components::Point* point, bool activate_dofs)
+    {
+        // retrieve the pointer to the node of the point
+        Elements::Node* node_ptr = get_node(point->get_ID());
+        node_ptr->reset_settings();
 		if (activate_dofs)
 		{
 			Eigen::Vector6i init_NFS;
@@ -342,7 +314,30 @@ namespace BSO { namespace Structural_Design {
             }
         }
 
-    } // add_node(Point*)
+    } // update_node()
+
+    void FEA::set_active_elements(const std::vector<bool>& active_elements)
+    { // the nodes must have been reset with update_node() before, their freedom signatures are then rebuilt from the active elements
+        if (active_elements.size() != m_elements.size())
+        {
+            std::cerr << "Error, size of element activation mask does not match the element count (FEA.hpp), exiting now..." << std::endl;
+            exit(1);
+        }
+        m_active_elements = active_elements;
+
+        for (unsigned int i = 0; i < m_elements.size(); i++)
+        {
+            if (m_active_elements[i])
+            {
+                m_elements[i]->update_NFS();
+            }
+        }
+    } // set_active_elements()
+
+    bool FEA::is_active(unsigned int n)
+    {
+        return (m_active_elements.empty() || m_active_elements[n]);
+    } // is_active()
 
     void FEA::add_elements(Components::Component* component)
     {
@@ -449,6 +444,8 @@ namespace BSO { namespace Structural_Design {
         m_dof_count = dof_count;
 
         // map the loads to m_all_loads
+        m_all_loads.clear();
+        m_all_displacements.clear();
         for (unsigned int i = 0; i < m_load_cases.size(); i++)
         { // for all load cases
             double load = 0; // assigned to zero to avoid compiler warning about use of uninitialized variable
@@ -477,6 +474,7 @@ namespace BSO { namespace Structural_Design {
         // generate freedom table in each element instance
         for (unsigned int i = 0; i < m_elements.size(); i++)
         {
+            if (!is_active(i)) continue;
             m_elements[i]->generate_EFT();
         }
 
@@ -486,6 +484,8 @@ namespace BSO { namespace Structural_Design {
 
     void FEA::generate_GSM()
     {
+        BSO_PROFILE_SCOPE("FEA::generate_GSM");
+        BSO_PROFILE_SAMPLE("FEA degrees of freedom", m_dof_count);
         // initialise the sparse global stiffness matrix:
         m_sp_GSM.resize(0,0); // clears any contents that may have been in the sparse matrix
         m_sp_GSM.resize(m_dof_count, m_dof_count); // sets the size of the stiffness matrix to the number of dof's
@@ -495,6 +495,7 @@ namespace BSO { namespace Structural_Design {
 
         for (unsigned int i = 0; i < m_elements.size(); i++)
         {
+            if (!is_active(i)) continue;
             temp_element_list = m_elements[i]->get_SM_triplets();
             triplet_list.insert(triplet_list.end(), temp_element_list.begin(), temp_element_list.end());
             temp_element_list.clear();
@@ -507,6 +508,7 @@ namespace BSO { namespace Structural_Design {
 
 	std::map<Elements::Node*, std::vector<unsigned int> > FEA::get_nodes_with_free_dofs(double x)
 	{
+		BSO_PROFILE_SCOPE("FEA::get_nodes_with_free_dofs");
 		Eigen::JacobiSVD<Eigen::MatrixXd> svd(m_sp_GSM,Eigen::ComputeFullV);
 
 		auto S = svd.singularValues();
@@ -558,30 +560,31 @@ namespace BSO { namespace Structural_Design {
 			}
 		}
 
+		BSO_PROFILE_SAMPLE("FEA nodes with free dofs", nodes_with_free_dofs.size());
 		return nodes_with_free_dofs;
 	}
 
     
     void FEA::solve()
     {
+        BSO_PROFILE_SCOPE("FEA::solve");
         // SparseLLT decomposition
         Eigen::SimplicialLLT<Eigen::SparseMatrix<double> > solver;
         solver.compute(m_sp_GSM);
 
-        int zeroRows = 0;
-        for (int i = 0; i < m_sp_GSM.rows(); i++) {
-            bool rowIsZero = true;
-            for (int j = 0; j < m_sp_GSM.cols(); j++) {
-                if (m_sp_GSM.coeff(i, j) != 0) {
-                    rowIsZero = false;
-                    break; // Exit the loop early if we find a non-zero element
+        #ifdef BSO_PROFILING
+        { // count the rows of the GSM without non-zero entries, from the stored entries only
+            std::vector<bool> row_is_zero(m_sp_GSM.rows(), true);
+            for (int j = 0; j < m_sp_GSM.outerSize(); j++)
+            {
+                for (Eigen::SparseMatrix<double>::InnerIterator it(m_sp_GSM, j); it; ++it)
+                {
+                    if (it.value() != 0) row_is_zero[it.row()] = false;
                 }
             }
-            if (rowIsZero) {
-                zeroRows++;
-            }
+            BSO_PROFILE_COUNT("FEA zero rows in GSM", std::count(row_is_zero.begin(), row_is_zero.end(), true));
         }
-        std::cout << "Number of zero rows: " << zeroRows << std::endl;
+        #endif // BSO_PROFILING
 
 
         if(solver.info() != Eigen::Success)
@@ -611,6 +614,7 @@ namespace BSO { namespace Structural_Design {
         // calculate the strain energy in each element
         for (unsigned int i = 0; i < m_elements.size(); i++)
         {
+            if (!is_active(i)) continue;
             m_elements[i]->calc_energies(m_load_cases);
         }
 
@@ -1013,6 +1017,7 @@ namespace BSO { namespace Structural_Design {
 	*/
 	std::map<std::pair<Elements::Node*, unsigned int>, double> FEA::get_nodes_singular_values()
 	{
+		BSO_PROFILE_SCOPE("FEA::get_nodes_singular_values");
 		Eigen::JacobiSVD<Eigen::MatrixXd> svd(m_sp_GSM,Eigen::ComputeFullV);
 
 		auto S = svd.singularValues();
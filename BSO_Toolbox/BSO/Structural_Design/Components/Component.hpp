@@ -15,11 +15,16 @@
 #include <vector>
 #include <map>
 
-namespace BSO { namespace Structural_Design {  namespace Components {
+namespace BSO { namespace Structural_Design {
+
+    class SD_Analysis; // friend of the components, see SD_Analysis::write_snapshot()
+
+namespace Components {
 
     class Component
     {
     protected:
+        friend class Structural_Design::SD_Analysis; // restores the mesh from a snapshot
         std::vector<Point*> m_points; // original points
         std::vector<Point*> m_point_list; // meshed + original points
         std::vector<std::vector<Point*> > m_elements; // each set forms one element of the component (after meshing)
@@ -70,6 +75,8 @@ namespace BSO { namespace Structural_Design {  namespace Components {
 
         virtual unsigned int get_element_count();
         virtual std::vector<unsigned long> get_node_IDs(unsigned int n) = 0;
+        std::vector<Point*> get_point_list();
+        virtual void merge_points(std::vector<Point*>& point_store);
         virtual unsigned int get_space_ptr_count();
         virtual Spatial_Design::Geometry::Space* get_space_ptr(unsigned int n);
 
@@ -83,6 +90,7 @@ namespace BSO { namespace Structural_Design {  namespace Components {
         virtual void add_line_constraint(Constraint line_constraint, Point* p1, Point* p2);
 		
 		virtual bool find_points(Point*, Point*);
+        virtual bool same_as(Component* comp_ptr); // true if comp_ptr adds the same elements, loads and constraints to a model
 
     }; // class Component
 
@@ -112,6 +120,7 @@ namespace BSO { namespace Structural_Design {  namespace Components {
     class Quadri_Lateral : public Component
     {
     protected:
+        friend class Structural_Design::SD_Analysis; // restores the mesh from a snapshot
         std::vector<std::pair<Point*, Point*> > m_lines; // pairs of pointers Point objects that form an edge of the quadrilateral
         std::vector<std::vector<Point*> > m_line_point_list; // lists the nodes for each of the quadrilaterals edges
         std::map<unsigned int, std::vector<Load> > m_line_loads; // key values are indices of m_lines
@@ -125,6 +134,8 @@ namespace BSO { namespace Structural_Design {  namespace Components {
         virtual void mesh(unsigned int n, std::vector<Point*>& point_store);
         virtual void add_line_load(Load line_load, Point* p1, Point* p2);
         virtual void add_line_constraint(Constraint line_constraint, Point* p1, Point* p2);
+        virtual void merge_points(std::vector<Point*>& point_store);
+        virtual bool same_as(Component* comp_ptr);
 
         virtual std::vector<unsigned long> get_node_IDs(unsigned int n);
 
@@ -295,6 +306,35 @@ namespace BSO { namespace Structural_Design {  namespace Components {
         return m_elements.size();
     } // get_element_count()
 
+    std::vector<Point*> Component::get_point_list()
+    { // returns the meshed and original points of this component
+        return m_point_list;
+    } // get_point_list()
+
+    void Component::merge_points(std::vector<Point*>& point_store)
+    { // replaces the original points of this (unmeshed) component by the points at the same coordinates in point_store, e.g. to move it to another model
+      // points that are not in the point store yet are added to it as new points (without loads and constraints)
+        for (unsigned int i = 0; i < m_points.size(); i++)
+        {
+            Point* new_point = nullptr;
+            for (unsigned int j = 0; j < point_store.size(); j++)
+            {
+                if (*(point_store[j]) == m_points[i]->get_coords())
+                {
+                    new_point = point_store[j];
+                    break;
+                }
+            }
+            if (new_point == nullptr)
+            {
+                Eigen::Vector3d coords = m_points[i]->get_coords();
+                point_store.push_back(new Point(coords(0), coords(1), coords(2)));
+                new_point = point_store.back();
+            }
+            m_points[i] = new_point;
+        }
+    } // merge_points()
+
     unsigned int Component::get_space_ptr_count()
     {
         return m_space_ptrs.size();
@@ -353,6 +393,71 @@ namespace BSO { namespace Structural_Design {  namespace Components {
 			return false;
 	}
 
+    bool same_loads(const std::vector<Load>& loads_1, const std::vector<Load>& loads_2)
+    {
+        if (loads_1.size() != loads_2.size())
+        {
+            return false;
+        }
+        for (unsigned int i = 0; i < loads_1.size(); i++)
+        {
+            if (loads_1[i].m_lc != loads_2[i].m_lc || loads_1[i].m_dof != loads_2[i].m_dof || loads_1[i].m_value != loads_2[i].m_value)
+            {
+                return false;
+            }
+        }
+        return true;
+    } // same_loads()
+
+    bool same_constraints(const std::vector<Constraint>& constraints_1, const std::vector<Constraint>& constraints_2)
+    {
+        if (constraints_1.size() != constraints_2.size())
+        {
+            return false;
+        }
+        for (unsigned int i = 0; i < constraints_1.size(); i++)
+        {
+            if (constraints_1[i].m_dof != constraints_2[i].m_dof)
+            {
+                return false;
+            }
+        }
+        return true;
+    } // same_constraints()
+
+    bool Component::same_as(Component* comp_ptr)
+    { // the same type, points at the same coordinates (in the same order), and the same properties, loads and constraints,
+      // e.g. to mesh a component that is part of several models only once, see Zoned_Design::screen_zoned_designs_shared()
+        if (m_is_truss != comp_ptr->m_is_truss || m_is_beam != comp_ptr->m_is_beam || m_is_flat_shell != comp_ptr->m_is_flat_shell ||
+            m_is_line_load != comp_ptr->m_is_line_load || m_is_quadri_load != comp_ptr->m_is_quadri_load ||
+            m_is_line_constraint != comp_ptr->m_is_line_constraint || m_is_ghost != comp_ptr->m_is_ghost ||
+            m_mesh_switch != comp_ptr->m_mesh_switch || m_points.size() != comp_ptr->m_points.size())
+        {
+            return false;
+        }
+
+        for (unsigned int i = 0; i < m_points.size(); i++)
+        {
+            if (!(*(comp_ptr->m_points[i]) == m_points[i]->get_coords()))
+            {
+                return false;
+            }
+        }
+
+        // load and constraint components have no properties
+        unsigned int property_count = (m_is_flat_shell) ? 3 : (m_is_beam) ? 4 : (m_is_truss) ? 2 : 0;
+        for (unsigned int i = 0; i < property_count; i++)
+        {
+            if (get_property(i) != comp_ptr->get_property(i))
+            {
+                return false;
+            }
+        }
+
+        return same_loads(m_loads, comp_ptr->m_loads) && same_constraints(m_constraints, comp_ptr->m_constraints) &&
+               m_space_ptrs == comp_ptr->m_space_ptrs;
+    } // same_as()
+
 
 
 
@@ -757,6 +862,21 @@ namespace BSO { namespace Structural_Design {  namespace Components {
 
     } // mesh()
 
+    void Quadri_Lateral::merge_points(std::vector<Point*>& point_store)
+    {
+        std::vector<Point*> old_points = m_points;
+        Component::merge_points(point_store);
+
+        for (unsigned int i = 0; i < m_lines.size(); i++)
+        { // let the edges refer to the merged points as well
+            for (unsigned int j = 0; j < old_points.size(); j++)
+            {
+                if (m_lines[i].first == old_points[j]) m_lines[i].first = m_points[j];
+                if (m_lines[i].second == old_points[j]) m_lines[i].second = m_points[j];
+            }
+        }
+    } // merge_points()
+
     void Quadri_Lateral::add_line_load(Load line_load, Point* p1, Point* p2)
     {
         for (unsigned int i = 0; i < m_lines.size(); i++)
@@ -800,6 +920,35 @@ namespace BSO { namespace Structural_Design {  namespace Components {
     } // add_line_constraint()
 
 
+    bool Quadri_Lateral::same_as(Component* comp_ptr)
+    { // see Component::same_as(), the loads and constraints on the edges are compared as well
+        Quadri_Lateral* quad_ptr = dynamic_cast<Quadri_Lateral*>(comp_ptr);
+        if (quad_ptr == nullptr || !Component::same_as(comp_ptr) ||
+            m_line_loads.size() != quad_ptr->m_line_loads.size() || m_line_constraints.size() != quad_ptr->m_line_constraints.size())
+        {
+            return false;
+        }
+
+        // the points, and so the edges, are in the same order
+        for (auto ite = m_line_loads.begin(); ite != m_line_loads.end(); ite++)
+        {
+            if (quad_ptr->m_line_loads.find(ite->first) == quad_ptr->m_line_loads.end() ||
+                !same_loads(ite->second, quad_ptr->m_line_loads[ite->first]))
+            {
+                return false;
+            }
+        }
+        for (auto ite = m_line_constraints.begin(); ite != m_line_constraints.end(); ite++)
+        {
+            if (quad_ptr->m_line_constraints.find(ite->first) == quad_ptr->m_line_constraints.end() ||
+                !same_constraints(ite->second, quad_ptr->m_line_constraints[ite->first]))
+            {
+                return false;
+            }
+        }
+        return true;
+    } // same_as()
+
     std::vector<unsigned long> Quadri_Lateral::get_node_IDs(unsigned int n)
     {
         std::vector<unsigned long> temp;
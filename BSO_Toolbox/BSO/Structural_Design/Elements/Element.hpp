@@ -7,6 +7,7 @@
 #include <Eigen/Sparse>
 
 #include <iostream>
+#include <atomic>
 
 namespace Eigen {typedef Matrix<int, 6, 1> Vector6i;}
 
@@ -26,7 +27,7 @@ namespace BSO { namespace Structural_Design {  namespace Elements {
     private:
 
     protected:
-        static unsigned long m_count; // counter of number of instances of this class
+        static std::atomic<unsigned long> m_count; // counter of number of instances of this class (atomic, models can be analysed concurrently)
 
         double m_vol; // element volume [m]
         double m_x; // element density [-]
@@ -60,6 +61,7 @@ namespace BSO { namespace Structural_Design {  namespace Elements {
         virtual ~Element();
 
         virtual void generate_EFT();
+        virtual void update_NFS(); // passes the element freedom signature to its nodes again, e.g. after Node::reset_settings()
         virtual std::vector<Triplet> get_SM_triplets();
         virtual void calc_energies(const std::vector<unsigned int>& load_cases);
         virtual void get_displacements(const std::vector<unsigned int>& load_cases);
@@ -103,7 +105,7 @@ namespace BSO { namespace Structural_Design {  namespace Elements {
     }; // Element
 
     // initialisation of static variables
-    unsigned long Element::m_count = 0;
+    std::atomic<unsigned long> Element::m_count(0);
 
     Element::Element()
     {
@@ -149,6 +151,14 @@ namespace BSO { namespace Structural_Design {  namespace Elements {
         }
     } // generate_EFT()
 
+    void Element::update_NFS()
+    {
+        for (unsigned int i = 0; i < m_nodes.size(); i++)
+        {
+            m_nodes[i].m_node_ptr->update_NFS(m_nodes[i].m_EFS);
+        }
+    } // update_NFS()
+
     std::vector<Triplet> Element::get_SM_triplets()
     {
 
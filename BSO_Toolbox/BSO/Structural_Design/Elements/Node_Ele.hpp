@@ -8,6 +8,7 @@
 #include <iostream>
 #include <map>
 #include <stdexcept>
+#include <atomic>
 
 namespace Eigen {typedef Matrix<int, 6, 1> Vector6i;}
 namespace Eigen {typedef Matrix<double, 6, 1> Vector6d;}
@@ -18,7 +19,7 @@ namespace BSO { namespace Structural_Design { namespace Elements {
     class Node
     {
     private:
-        static unsigned long m_count;
+        static std::atomic<unsigned long> m_count;
         unsigned long m_ID; // node ID
         unsigned long m_NFM; // node freedom mapping (the number of dof's counted before this node's dof's)
         std::map<int, unsigned long> m_NFT; // node freedom table, keyvariable corresponds with node freedom arrangement
@@ -41,6 +42,7 @@ namespace BSO { namespace Structural_Design { namespace Elements {
         void add_load(unsigned int lc, unsigned int dir, double load);
         void add_displacements(std::map<unsigned int, Eigen::VectorXd> displacements);
         void set_NFT(unsigned long NFM);
+        void reset_settings();
 
         Eigen::Vector6i get_NFS();
         Eigen::Vector6i get_constraints();
@@ -60,7 +62,7 @@ namespace BSO { namespace Structural_Design { namespace Elements {
     }; // Node
 
     // initialisation of static variables
-    unsigned long Node::m_count = 0;
+    std::atomic<unsigned long> Node::m_count(0);
 
 
     Node::Node(unsigned long ID, double x, double y, double z)
@@ -189,6 +191,15 @@ namespace BSO { namespace Structural_Design { namespace Elements {
         }
     } // set_NFM()
 
+    void Node::reset_settings()
+    { // clears the freedom signature, constraints and loads, so they can be assigned again (e.g. when other elements become active)
+        m_NFS.setZero();
+        m_NFT.clear();
+        m_constraints.setZero();
+        m_loads.clear();
+        m_displacements.clear();
+    } // reset_settings()
+
 
     Eigen::Vector6i Node::get_NFS()
     {
@@ -23,7 +23,7 @@ namespace BSO { namespace Structural_Design {
             m_element_clusters[i] = (i+1)*(1.0/n_clusters);
         }
 
-        std::ifstream input(file_name.c_str()); // initialize input stream from file: file_name
+        Field_Scanner input(file_name, ","); // reads the file, fields are separated by a ','
 
         if (!input.is_open())
         {
@@ -31,37 +31,25 @@ namespace BSO { namespace Structural_Design {
             exit(1);
         }
 
-        std::string line;
-        boost::char_separator<char> sep(","); // defines what separates tokens in a string
-        typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
         std::string type_ID; // holds information about what type of information is described by the line currently read
 
         std::map<unsigned long, Components::Point*>  temp_point_map;
 
-        while (!input.eof())
+        while (input.next_line()) // empty lines are skipped
         {
-            getline(input,line); // get next line from the file
-            boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
-            if (line == "") //skip empty lines (tokenizer does not like it)
-            {
-                continue; // continue to next line
-            }
-
-            t_tokenizer tok(line, sep); // tokenize the line
-            t_tokenizer::iterator token = tok.begin(); // set iterator to first token
-            type_ID = *token; // interpret first token as type ID
-            boost::algorithm::trim(type_ID);
+            unsigned int token = 0; // index of the current token
+            type_ID = input.get_string(token); // interpret first token as type ID
 
             if (type_ID == "K")
             {
                 token++; // ID
-                unsigned long ID = trim_and_cast_ulong(*token);
+                unsigned long ID = input.get_ulong(token);
                 token++; // x
-                double x = trim_and_cast_double(*token);
+                double x = input.get_double(token);
                 token++; // y
-                double y = trim_and_cast_double(*token);
+                double y = input.get_double(token);
                 token++; // z
-                double z = trim_and_cast_double(*token);
+                double z = input.get_double(token);
 
                 m_points.push_back(new Components::Point(x, y, z));
                 m_all_points.push_back(m_points.back());
@@ -71,16 +59,16 @@ namespace BSO { namespace Structural_Design {
             {
                 unsigned long ID;
                 token++; // node ID 1
-                ID = trim_and_cast_uint(*token);
+                ID = input.get_uint(token);
                 Components::Point* p_1 = temp_point_map[ID];
                 token++; // node ID 2
-                ID = trim_and_cast_uint(*token);
+                ID = input.get_uint(token);
                 Components::Point* p_2 = temp_point_map[ID];
                 token++; // node ID 3
-                ID = trim_and_cast_uint(*token);
+                ID = input.get_uint(token);
                 Components::Point* p_3 = temp_point_map[ID];
                 token++; // node ID 4
-                ID = trim_and_cast_uint(*token);
+                ID = input.get_uint(token);
                 Components::Point* p_4 = temp_point_map[ID];
 
                 double t = 150;
@@ -94,23 +82,23 @@ namespace BSO { namespace Structural_Design {
             {
                 unsigned long ID;
                 token++; // value
-                double value = trim_and_cast_double(*token);
+                double value = input.get_double(token);
                 token++; // switch for line load on surface or volume
-                int line_load = trim_and_cast_uint(*token);
+                int line_load = input.get_uint(token);
                 token++; // switch for surface load on volume
-                int surface_load = trim_and_cast_uint(*token);
+                int surface_load = input.get_uint(token);
                 token++; // dir
-                unsigned int dir = trim_and_cast_uint(*token);
+                unsigned int dir = input.get_uint(token);
                 token++; // lc
-                unsigned int lc = trim_and_cast_uint(*token);
+                unsigned int lc = input.get_uint(token);
 
                 if (line_load == 1)
                 {
                     token++; // point ID 1
-                    ID = trim_and_cast_uint(*token);
+                    ID = input.get_uint(token);
                     Components::Point* p_1 = temp_point_map[ID];
                     token++; // point ID 2
-                    ID = trim_and_cast_uint(*token);
+                    ID = input.get_uint(token);
                     Components::Point* p_2 = temp_point_map[ID];
 
                     m_components.back()->add_line_load(Components::Load(lc, dir-1, value), p_1, p_2);
@@ -128,19 +116,19 @@ namespace BSO { namespace Structural_Design {
             {
                 unsigned long ID;
                 token++; // switch for line constraint on surface or volume
-                unsigned int line_constr = trim_and_cast_uint(*token);
+                unsigned int line_constr = input.get_uint(token);
                 token++; // switch for surface constraint on volume
-                unsigned int surface_constr = trim_and_cast_uint(*token);
+                unsigned int surface_constr = input.get_uint(token);
                 token++; // direction in which movement is constrained
-                unsigned int dir = trim_and_cast_uint(*token);
+                unsigned int dir = input.get_uint(token);
 
                 if (line_constr == 1)
                 {
                     token++; // point ID 1
-                    ID = trim_and_cast_uint(*token);
+                    ID = input.get_uint(token);
                     Components::Point* p_1 = temp_point_map[ID];
                     token++; // point ID 2
-                    ID = trim_and_cast_uint(*token);
+                    ID = input.get_uint(token);
                     Components::Point* p_2 = temp_point_map[ID];
 
                     m_components.back()->add_line_constraint(Components::Constraint(dir-1), p_1, p_2);
@@ -157,33 +145,37 @@ namespace BSO { namespace Structural_Design {
             else if (type_ID == "C")
             {
                 token++; // node ID
-                unsigned long ID = trim_and_cast_ulong(*token);
+                unsigned long ID = input.get_ulong(token);
                 token++; // dir
-                unsigned int dir = trim_and_cast_uint(*token);
+                unsigned int dir = input.get_uint(token);
 
                 temp_point_map[ID]->update_constraints(Components::Constraint(dir-1));
             }
             else if (type_ID == "F")
             {
                 token++; // node ID
-                unsigned long ID = trim_and_cast_ulong(*token);
+                unsigned long ID = input.get_ulong(token);
                 token++; // value
-                double value = trim_and_cast_double(*token);
+                double value = input.get_double(token);
                 token++; // direction
-                unsigned int dir = trim_and_cast_uint(*token);
+                unsigned int dir = input.get_uint(token);
                 token++; // load case
-                unsigned int lc = trim_and_cast_uint(*token);
+                unsigned int lc = input.get_uint(token);
 
                 temp_point_map[ID]->update_loads(Components::Load(lc, dir-1, value));
             }
         }
-        input.close();
         temp_point_map.clear();
 
     } // ctor
 
-    SD_Analysis::SD_Analysis(Spatial_Design::MS_Conformal& CF)
+    SD_Analysis::SD_Analysis(Spatial_Design::MS_Conformal& CF) : SD_Analysis(CF, false)
     {
+
+    } // ctor
+
+    SD_Analysis::SD_Analysis(Spatial_Design::MS_Conformal& CF, bool shared_mesh)
+    { // if shared_mesh is true, all components are meshed once and can be (de)activated afterwards, see activate_components()
         std::cout<< "Initialising SD_Analysis..." << std::endl;
         m_fea_init = false;
         m_FEA = new FEA;
@@ -209,7 +201,14 @@ namespace BSO { namespace Structural_Design {
         }
         CF.request_SD_grammar()(&CF, this); // Assuming this returns a function pointer or functor
         std::cout<< "Meshing..." << std::endl;
-        mesh(m_mesh_division);
+        if (shared_mesh)
+        {
+            mesh_shared(m_mesh_division);
+        }
+        else
+        {
+            mesh(m_mesh_division);
+        }
     } // ctor
 
     /*
@@ -275,7 +274,12 @@ namespace BSO { namespace Structural_Design {
 
     SD_Analysis::~SD_Analysis()
     {
-        for (unsigned int i = 0; i < m_all_points.size(); i++)
+        // the input points are owned through m_points, the points made by meshing are the entries of m_all_points after them (see clear_mesh())
+        for (unsigned int i = 0; i < m_points.size(); i++)
+        {
+            delete m_points[i];
+        }
+        for (unsigned int i = m_points.size(); i < m_all_points.size(); i++)
         {
             delete m_all_points[i];
         }
@@ -315,6 +319,7 @@ namespace BSO { namespace Structural_Design {
         new_model.m_beam_props = m_beam_props;
         new_model.m_flat_shell_props = m_flat_shell_props;
         new_model.m_mesh_division = m_mesh_division;
+        new_model.m_mesh_ghost = m_mesh_ghost;
 		new_model.m_FEA = m_FEA;
 		new_model.m_FEA->clear_system();
         new_model.m_fea_init = false;
@@ -333,6 +338,11 @@ namespace BSO { namespace Structural_Design {
         m_FEA = new FEA;
         m_fea_init = false;
         m_building_results = SD_Building_Results();
+
+        m_shared_mesh = false;
+        m_active_components.clear();
+        m_base_point_settings.clear();
+        m_component_point_settings.clear();
     } // transfer_model()
 
 	void SD_Analysis::remesh()
@@ -347,11 +357,13 @@ namespace BSO { namespace Structural_Design {
 
     void SD_Analysis::mesh(unsigned int x, bool ghost)
     { // mesh the components
+        BSO_PROFILE_SCOPE("SD_Analysis::mesh");
         // clear any mesh that may exist already
 		if (m_FEA == nullptr) m_FEA = new FEA;
         clear_mesh();
 		m_FEA->clear_system();
 		m_mesh_division = x;
+		m_mesh_ghost = ghost;
 
         for (unsigned int i = 0; i < m_components.size(); i++)
         {
@@ -366,6 +378,11 @@ namespace BSO { namespace Structural_Design {
             }
         }
 
+        generate_FEA(ghost);
+    } // mesh()
+
+    void SD_Analysis::generate_FEA(bool ghost)
+    { // adds the nodes and elements of the meshed components to the finite element model and generates its system
         // give an ID to each point in the meshed structural design
         for (unsigned long i = 0; i < m_all_points.size(); i++)
         { // for each point in the meshed structural design
@@ -393,10 +410,24 @@ namespace BSO { namespace Structural_Design {
         }
         m_FEA->generate_system();
 		m_fea_init = true;
-    } // mesh()
+    } // generate_FEA()
 
     void SD_Analysis::clear_mesh()
     {
+        if (m_shared_mesh)
+        { // put back the loads and constraints that acted on the input points before meshing
+            for (unsigned int i = 0; i < m_points.size(); i++)
+            {
+                m_points[i]->reset_settings();
+            }
+            apply_point_settings(m_base_point_settings);
+
+            m_shared_mesh = false;
+            m_active_components.clear();
+            m_base_point_settings.clear();
+            m_component_point_settings.clear();
+        }
+
         // clear mesh in components
         for (unsigned int i = 0; i < m_components.size(); i++)
         {
@@ -429,104 +460,193 @@ namespace BSO { namespace Structural_Design {
 
     }
 
-    void SD_Analysis::analyse()
-    {
-        if (!m_fea_init)
-        { // if the FEA has not been initialised yet
-            m_FEA->generate_system();
-            std::cout << "System generated" << std::endl;
-            m_fea_init = true;
+    void SD_Analysis::mesh_shared(unsigned int x)
+    { // meshes all components (ghosts included) once and records which loads and constraints each component puts on its points,
+      // afterwards any selection of components can be analysed on this mesh, see activate_components()
+		if (m_FEA == nullptr) m_FEA = new FEA;
+        clear_mesh();
+		m_mesh_division = x;
+
+        m_base_point_settings.clear();
+        m_component_point_settings.clear();
+        m_component_point_settings.resize(m_components.size());
+
+        for (unsigned int i = 0; i < m_all_points.size(); i++)
+        { // store (and remove) the loads and constraints on the input points
+            record_point_settings(m_all_points[i], m_base_point_settings);
         }
-        std::cout << "Solving..." << std::endl;
 
-        std::cout<< m_FEA->get_element_count() << std::endl;
-        m_FEA->solve();
-        std::cout << "Done solving" << std::endl;
-    }
+        for (unsigned int i = 0; i < m_components.size(); i++)
+        { // mesh each component, the loads and constraints on its points are then the ones it added itself
+            if (!m_components[i]->get_mesh_switch())
+            { // if the component should be meshed in one element
+                m_components[i]->mesh(1, m_all_points);
+            }
+            else
+            { // if it should be meshed
+                m_components[i]->mesh(x, m_all_points);
+            }
 
-    void SD_Analysis::cluster_element_densities(unsigned int n)
-    {
-        // obtain the vector with all element pointers
-        std::vector<double> densities;
-        for (unsigned int i = 0; i < m_FEA->m_elements.size(); i++)
+            std::vector<Components::Point*> point_list = m_components[i]->get_point_list();
+            for (unsigned int j = 0; j < point_list.size(); j++)
+            {
+                record_point_settings(point_list[j], m_component_point_settings[i]);
+            }
+        }
+
+        // give an ID to each point in the meshed structural design and add the nodes and elements of all components
+        for (unsigned long i = 0; i < m_all_points.size(); i++)
         {
-            densities.push_back(m_FEA->m_elements[i]->get_density());
+            m_all_points[i]->set_ID(i+1);
+        }
+        for (unsigned int i = 0; i < m_all_points.size(); i++)
+        {
+            m_FEA->add_node(m_all_points[i], false); // loads, constraints and freedoms are assigned by activate_components()
+        }
+        for (unsigned int i = 0; i < m_components.size(); i++)
+        {
+            m_FEA->add_elements(m_components[i]);
         }
 
-        std::sort(densities.begin(), densities.end());
-        m_element_clusters.clear();
-        m_element_clusters.resize(n);
-        std::vector<double> new_centroids(n), centroids(n);
+        m_shared_mesh = true;
+        activate_components(std::vector<bool>(m_components.size(), true));
+    } // mesh_shared()
 
-        /*for (unsigned int i = 0; i < n; i++)
+    void SD_Analysis::activate_components(const std::vector<bool>& active_components)
+    { // only the active components are assembled into the system and take part in the results, no remeshing is required
+        if (!m_shared_mesh)
         {
-            unsigned int l_index, u_index;
-            l_index = (i/(double)n) * densities.size();
-            u_index = ((i+1)/(double)n) * densities.size();
+            std::cerr << "Error, components can only be (de)activated on a shared mesh (SD_Analysis.cpp), exiting now..." << std::endl;
+            exit(1);
+        }
+        if (active_components.size() != m_components.size())
+        {
+            std::cerr << "Error, size of component activation mask does not match the component count (SD_Analysis.cpp), exiting now..." << std::endl;
+            exit(1);
+        }
+        m_active_components = active_components;
 
-            double sum = 0;
-            unsigned int count = 0;
-            for (unsigned int j = l_index; j < u_index; j++)
+        // put the loads and constraints of the active components on the points
+        for (unsigned int i = 0; i < m_all_points.size(); i++)
+        {
+            m_all_points[i]->reset_settings();
+        }
+        apply_point_settings(m_base_point_settings);
+        for (unsigned int i = 0; i < m_components.size(); i++)
+        {
+            if (m_active_components[i])
             {
-                sum += densities[j];
-                count++;
+                apply_point_settings(m_component_point_settings[i]);
             }
-            new_centroids[i] = sum / count;
-        }*/
+        }
 
-        /*for (unsigned int i = 0; i < n; i++)
+        // pass the settings to the nodes, their freedoms follow from the active elements only
+        m_FEA->m_load_cases.clear();
+        for (unsigned int i = 0; i < m_all_points.size(); i++)
         {
-            new_centroids[i] = (1/16.0)+(i/8.0);
-        }*/
-
-        unsigned int pos = densities.size()/n;
+            m_FEA->update_node(m_all_points[i], false);
+        }
 
-        new_centroids[0] = densities[0];
-        new_centroids[1] = densities[pos];
-        new_centroids[2] = densities[pos*2];
-        new_centroids[3] = densities[pos*3];
-        new_centroids[4] = densities[pos*4];
-        new_centroids[5] = densities[pos*5];
-        new_centroids[6] = densities[pos*6];
-        new_centroids[7] = densities.back();
-
-        int switcher = 0;
-        while (switcher < 1 /*new_centroids == centroids */) //new_centroids != centroids)
+        std::vector<bool> active_elements;
+        for (unsigned int i = 0; i < m_components.size(); i++)
         {
-            switcher++;
-            centroids = new_centroids;
-
-            m_element_clusters[n-1] = densities.back();
-            for (unsigned int i = 0; i < n-1; i++)
+            active_elements.insert(active_elements.end(), m_components[i]->get_element_ptr_count(), m_active_components[i]);
+        }
+        m_FEA->set_active_elements(active_elements);
+
+        Eigen::Vector6i init_NFS;
+        init_NFS << 1,1,1,0,0,0;
+        for (unsigned int i = 0; i < m_points.size(); i++)
+        { // input points that are used by an active element get their initial freedoms, see mesh()
+            Elements::Node* node_ptr = m_FEA->get_node(m_points[i]->get_ID());
+            if (node_ptr->get_NFS().sum() > 0)
             {
-               m_element_clusters[i] = (centroids[i] + centroids[i+1]) / 2.0;
+                node_ptr->update_NFS(init_NFS);
             }
+        }
 
-            double sum = 0;
-            unsigned int count = 0;
-            unsigned int index_track = 0;
+        m_FEA->generate_system();
+        m_fea_init = true;
+    } // activate_components()
+
+    void SD_Analysis::record_point_settings(Components::Point* point, std::map<Components::Point*, Point_Settings>& settings)
+    { // moves the loads and constraints on the point (if there are any) to 'settings'
+        std::map<unsigned int, Eigen::Vector6d> loads = point->get_loads();
+        std::vector<bool> constraints = point->get_constraints();
+        if (loads.empty() && std::find(constraints.begin(), constraints.end(), true) == constraints.end())
+        {
+            return;
+        }
+
+        settings[point].m_loads = loads;
+        settings[point].m_constraints = constraints;
+        point->reset_settings();
+    } // record_point_settings()
 
-            for (unsigned int i = 0; i < densities.size(); i ++)
+    void SD_Analysis::apply_point_settings(const std::map<Components::Point*, Point_Settings>& settings)
+    {
+        for (auto ite = settings.begin(); ite != settings.end(); ite++)
+        {
+            for (auto lc_ite = ite->second.m_loads.begin(); lc_ite != ite->second.m_loads.end(); lc_ite++)
             {
-                if (densities[i] > m_element_clusters[index_track])
-                {
-                    new_centroids[index_track] = sum / count;
-                    index_track++;
-                    sum = count = 0;
-                }
-                else if (i == densities.size() - 1)
+                for (unsigned int j = 0; j < 6; j++)
                 {
-                    sum += densities[i];
-                    count++;
-                    new_centroids[index_track] = sum / count;
+                    ite->first->update_loads(Components::Load(lc_ite->first, j, lc_ite->second(j)));
                 }
-                else
+            }
+            for (unsigned int j = 0; j < 6; j++)
+            {
+                if (ite->second.m_constraints[j])
                 {
-                    sum += densities[i];
-                    count++;
+                    ite->first->update_constraints(Components::Constraint(j));
                 }
             }
         }
+    } // apply_point_settings()
+
+    void SD_Analysis::analyse()
+    {
+        BSO_PROFILE_SCOPE("SD_Analysis::analyse");
+        if (!m_fea_init)
+        { // if the FEA has not been initialised yet
+            m_FEA->generate_system();
+            m_fea_init = true;
+        }
+
+        BSO_PROFILE_SAMPLE("SD_Analysis elements", m_FEA->get_element_count());
+        m_FEA->solve();
+    }
+
+    void SD_Analysis::cluster_element_densities(unsigned int n)
+    { // clusters the element densities in n clusters (k-means, starting from the quantiles), m_element_clusters holds the upper bound of each cluster
+        std::vector<double> densities;
+        for (unsigned int i = 0; i < m_FEA->m_elements.size(); i++)
+        {
+            densities.push_back(m_FEA->m_elements[i]->get_density());
+        }
+
+        std::sort(densities.begin(), densities.end());
+        Eigen::Map<Eigen::MatrixXd> points(densities.data(), 1, densities.size());
+
+        unsigned int pos = densities.size()/n;
+        Eigen::MatrixXd centroids(1, n);
+        for (unsigned int i = 0; i < n-1; i++)
+        {
+            centroids(0, i) = densities[pos*i];
+        }
+        centroids(0, n-1) = densities.back();
+
+        std::vector<unsigned int> assignment, sizes;
+        k_means_lloyd(points, centroids, assignment, sizes);
+        std::sort(centroids.data(), centroids.data() + n);
+
+        m_element_clusters.clear();
+        m_element_clusters.resize(n);
+        m_element_clusters[n-1] = densities.back();
+        for (unsigned int i = 0; i < n-1; i++)
+        { // the boundary between two clusters lies halfway their centroids
+            m_element_clusters[i] = (centroids(0, i) + centroids(0, i+1)) / 2.0;
+        }
     } // cluster_element_densities()
 
 	void SD_Analysis::scale_dimensions(double x)
@@ -674,6 +794,7 @@ namespace BSO { namespace Structural_Design {
 
         for (unsigned int i = 0; i < m_components.size(); i++)
         {
+            if (m_shared_mesh && !m_active_components[i]) continue; // not part of the current design
             m_building_results.add_component(m_components[i]);
         }
         m_building_results.obtain_results();
@@ -14,6 +14,8 @@
 #endif
 
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Clustering.hpp>
+#include <BSO/Profiler.hpp>
 #include <BSO/Spatial_Design/Conformation.hpp>
 #include <BSO/Structural_Design/Analysis_Tools/SD_Props_Vars.hpp>
 #include <BSO/Structural_Design/Analysis_Tools/FEA.hpp>
@@ -22,28 +24,50 @@
 
 namespace BSO { namespace Structural_Design {
 
+    struct Point_Settings
+    { // loads and constraints acting on a point, see SD_Analysis::mesh_shared()
+        std::map<unsigned int, Eigen::Vector6d> m_loads;
+        std::vector<bool> m_constraints;
+    }; // Point_Settings
+
     class SD_Analysis : public SD_Analysis_Vars
     {
     private:
         bool m_fea_init; // switch to see if the finite element analysis has been initialised already
+        bool m_mesh_ghost = true; // false if the ghost components were left out of the mesh, see mesh(x, ghost)
         FEA* m_FEA;
         Spatial_Design::MS_Conformal* m_spatial_design;
 
         std::vector<double> m_element_clusters;
 
         SD_Building_Results m_building_results;
+
+        // shared mesh: all components are meshed once and each design is a selection of active components
+        bool m_shared_mesh = false;
+        std::vector<bool> m_active_components;
+        std::map<Components::Point*, Point_Settings> m_base_point_settings; // settings of the points before meshing
+        std::vector<std::map<Components::Point*, Point_Settings> > m_component_point_settings; // settings that each component added to its points
+
+        void record_point_settings(Components::Point* point, std::map<Components::Point*, Point_Settings>& settings);
+        void apply_point_settings(const std::map<Components::Point*, Point_Settings>& settings);
+        void generate_FEA(bool ghost); // the nodes and elements of the meshed components
     public:
         SD_Analysis(std::string file_name);
         SD_Analysis(Spatial_Design::MS_Conformal&);
+        SD_Analysis(Spatial_Design::MS_Conformal&, bool shared_mesh);
+        SD_Analysis(Snapshot_Reader&, Spatial_Design::MS_Conformal&); // restores a meshed model written by write_snapshot()
         SD_Analysis();
         ~SD_Analysis();
 
         void transfer_model(SD_Analysis& new_model);
+        void write_snapshot(Snapshot_Writer&, Spatial_Design::MS_Conformal&);
 
 		void remesh();
         void mesh(unsigned int x);
 		void mesh(unsigned int x, bool ghost);
         void clear_mesh();
+        void mesh_shared(unsigned int x);
+        void activate_components(const std::vector<bool>& active_components);
         void analyse();
         void cluster_element_densities(unsigned int n);
 		void scale_dimensions(double x);
@@ -76,5 +100,10 @@ namespace BSO { namespace Structural_Design {
 } // namespace BSO
 
 #include <BSO/Structural_Design/SD_Analysis.cpp>
+#include <BSO/Structural_Design/SD_Analysis_Snapshot.cpp>
+
+#ifdef ZONING_HPP
+#include <BSO/Spatial_Design/Zoning/Zoned_SD_Analysis.cpp>
+#endif // ZONING_HPP
 
 #endif // SD_ANALYSIS_HPP
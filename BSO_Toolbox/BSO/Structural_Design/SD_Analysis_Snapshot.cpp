@@ -0,0 +1,386 @@
+#ifndef SD_ANALYSIS_SNAPSHOT_CPP
+#define SD_ANALYSIS_SNAPSHOT_CPP
+
+/*
+ * Writing and restoring a meshed structural model in a snapshot (see BSO/Snapshot.hpp).
+ * The section follows the section of the conformal model it was made from, it holds
+ * the points (input points first), the components with their mesh, and the settings
+ * of the model. When it is restored the grammar and the meshing of the components are
+ * skipped, only the finite element model is generated again. Included by SD_Analysis.hpp.
+ */
+
+namespace BSO { namespace Structural_Design {
+
+    enum snapshot_component {SNAPSHOT_TRUSS, SNAPSHOT_BEAM, SNAPSHOT_FLAT_SHELL, SNAPSHOT_LINE_LOAD, SNAPSHOT_QUADRI_LOAD, SNAPSHOT_LINE_CONSTRAINT};
+
+    void write_snapshot_loads(Snapshot_Writer& snapshot, const std::vector<Components::Load>& loads)
+    {
+        snapshot.write((uint32_t)loads.size());
+        for (auto l : loads)
+        {
+            snapshot.write(l.m_lc);
+            snapshot.write(l.m_dof);
+            snapshot.write(l.m_value);
+        }
+    } // write_snapshot_loads()
+
+    std::vector<Components::Load> read_snapshot_loads(Snapshot_Reader& snapshot)
+    {
+        std::vector<Components::Load> loads;
+        uint32_t n = snapshot.read<uint32_t>();
+        for (unsigned int i = 0; i < n; i++)
+        {
+            unsigned int lc = snapshot.read<unsigned int>();
+            unsigned int dof = snapshot.read<unsigned int>();
+            loads.push_back(Components::Load(lc, dof, snapshot.read<double>()));
+        }
+        return loads;
+    } // read_snapshot_loads()
+
+    void write_snapshot_constraints(Snapshot_Writer& snapshot, const std::vector<Components::Constraint>& constraints)
+    {
+        snapshot.write((uint32_t)constraints.size());
+        for (auto c : constraints)
+        {
+            snapshot.write(c.m_dof);
+        }
+    } // write_snapshot_constraints()
+
+    std::vector<Components::Constraint> read_snapshot_constraints(Snapshot_Reader& snapshot)
+    {
+        std::vector<Components::Constraint> constraints;
+        uint32_t n = snapshot.read<uint32_t>();
+        for (unsigned int i = 0; i < n; i++)
+        {
+            constraints.push_back(Components::Constraint(snapshot.read<unsigned int>()));
+        }
+        return constraints;
+    } // read_snapshot_constraints()
+
+    template<typename T>
+    void write_snapshot_props(Snapshot_Writer& snapshot, const std::vector<T>& props, std::vector<double T::*> values)
+    {
+        snapshot.write((uint32_t)props.size());
+        for (auto& p : props)
+        {
+            snapshot.write_string(p.m_ID);
+            for (auto v : values)
+            {
+                snapshot.write(p.*v);
+            }
+        }
+    } // write_snapshot_props()
+
+    template<typename T>
+    std::vector<T> read_snapshot_props(Snapshot_Reader& snapshot, std::vector<double T::*> values)
+    {
+        std::vector<T> props(snapshot.read_count(sizeof(uint32_t)));
+        for (auto& p : props)
+        {
+            p.m_ID = snapshot.read_string();
+            for (auto v : values)
+            {
+                p.*v = snapshot.read<double>();
+            }
+        }
+        return props;
+    } // read_snapshot_props()
+
+    void SD_Analysis::write_snapshot(Snapshot_Writer& snapshot, Spatial_Design::MS_Conformal& CF)
+    { // CF is the conformal model this model was made from, it is written in the snapshot before this model
+      // the dimensions of the components are written as they are, i.e. after scale_dimensions()
+        if (m_shared_mesh)
+        {
+            std::cerr << "Error, cannot write a snapshot of a shared mesh (see SD_Analysis::mesh_shared()), exiting now... (SD_Analysis_Snapshot.cpp)" << std::endl;
+            exit(1);
+        }
+        // m_all_points is empty if the model has not been meshed yet, see clear_mesh()
+        const std::vector<Components::Point*>& all_points = (m_all_points.size() < m_points.size()) ? m_points : m_all_points;
+
+        std::map<Components::Point*, uint32_t> point_indices = snapshot_indices(all_points);
+        std::vector<Spatial_Design::Geometry::Space*> spaces;
+        for (unsigned int i = 0; i < CF.get_space_count(); i++)
+        {
+            spaces.push_back(CF.get_space(i));
+        }
+        std::map<Spatial_Design::Geometry::Space*, uint32_t> space_indices = snapshot_indices(spaces);
+
+        snapshot.write_tag("SDAN");
+        snapshot.write(m_mesh_division);
+        snapshot.write(m_mesh_ghost);
+        snapshot.write_vector(m_element_clusters);
+
+        // the points, and the loads and constraints that act on them
+        snapshot.write((uint32_t)m_points.size());
+        snapshot.write((uint32_t)all_points.size());
+        for (auto p : all_points)
+        {
+            Spatial_Design::write_snapshot_coords(snapshot, p->get_coords());
+            std::map<unsigned int, Eigen::Vector6d> loads = p->get_loads();
+            snapshot.write((uint32_t)loads.size());
+            for (auto& l : loads)
+            {
+                snapshot.write(l.first);
+                for (int i = 0; i < 6; i++)
+                {
+                    snapshot.write(l.second(i));
+                }
+            }
+            std::vector<bool> constraints = p->get_constraints();
+            for (int i = 0; i < 6; i++)
+            {
+                snapshot.write((bool)constraints[i]);
+            }
+        }
+
+        // the components and their mesh
+        snapshot.write((uint32_t)m_components.size());
+        for (auto c : m_components)
+        {
+            std::vector<double> props;
+            if (c->is_truss())
+            {
+                snapshot.write((uint8_t)SNAPSHOT_TRUSS);
+                for (int i = 0; i < 2; i++) props.push_back(c->get_property(i));
+            }
+            else if (c->is_beam())
+            {
+                snapshot.write((uint8_t)SNAPSHOT_BEAM);
+                for (int i = 0; i < 4; i++) props.push_back(c->get_property(i));
+            }
+            else if (c->is_flat_shell())
+            {
+                snapshot.write((uint8_t)SNAPSHOT_FLAT_SHELL);
+                for (int i = 0; i < 3; i++) props.push_back(c->get_property(i));
+            }
+            else if (c->is_line_load()) snapshot.write((uint8_t)SNAPSHOT_LINE_LOAD);
+            else if (c->is_quadri_load()) snapshot.write((uint8_t)SNAPSHOT_QUADRI_LOAD);
+            else if (c->is_line_constraint()) snapshot.write((uint8_t)SNAPSHOT_LINE_CONSTRAINT);
+            else
+            {
+                std::cerr << "Error, cannot write a snapshot of an unknown component, exiting now... (SD_Analysis_Snapshot.cpp)" << std::endl;
+                exit(1);
+            }
+            snapshot.write_vector(props);
+            write_snapshot_pointers(snapshot, point_indices, c->m_points);
+            write_snapshot_loads(snapshot, c->m_loads);
+            write_snapshot_constraints(snapshot, c->m_constraints);
+            snapshot.write(c->m_mesh_switch);
+            snapshot.write(c->m_is_ghost);
+            snapshot.write(c->m_visualisation_transparancy);
+            write_snapshot_pointers(snapshot, space_indices, c->m_space_ptrs);
+
+            write_snapshot_pointers(snapshot, point_indices, c->m_point_list);
+            snapshot.write((uint32_t)c->m_elements.size());
+            for (auto& e : c->m_elements)
+            {
+                write_snapshot_pointers(snapshot, point_indices, e);
+            }
+
+            if (c->is_flat_shell() || c->is_quadri_load())
+            {
+                Components::Quadri_Lateral* q = static_cast<Components::Quadri_Lateral*>(c);
+                snapshot.write((uint32_t)q->m_lines.size());
+                for (auto& l : q->m_lines)
+                {
+                    write_snapshot_pointers(snapshot, point_indices, &l.first, 1);
+                    write_snapshot_pointers(snapshot, point_indices, &l.second, 1);
+                }
+                snapshot.write((uint32_t)q->m_line_point_list.size());
+                for (auto& l : q->m_line_point_list)
+                {
+                    write_snapshot_pointers(snapshot, point_indices, l);
+                }
+                snapshot.write((uint32_t)q->m_line_loads.size());
+                for (auto& l : q->m_line_loads)
+                {
+                    snapshot.write(l.first);
+                    write_snapshot_loads(snapshot, l.second);
+                }
+                snapshot.write((uint32_t)q->m_line_constraints.size());
+                for (auto& l : q->m_line_constraints)
+                {
+                    snapshot.write(l.first);
+                    write_snapshot_constraints(snapshot, l.second);
+                }
+            }
+        }
+
+        // the settings of the model
+        write_snapshot_props(snapshot, m_truss_props, {&Truss_Props::m_A, &Truss_Props::m_E});
+        write_snapshot_props(snapshot, m_beam_props, {&Beam_Props::m_b, &Beam_Props::m_h, &Beam_Props::m_E, &Beam_Props::m_v});
+        write_snapshot_props(snapshot, m_flat_shell_props, {&Flat_Shell_Props::m_t, &Flat_Shell_Props::m_E, &Flat_Shell_Props::m_v});
+        write_snapshot_props(snapshot, m_ghost_flat_shell_props, {&Flat_Shell_Props::m_t, &Flat_Shell_Props::m_E, &Flat_Shell_Props::m_v});
+
+        snapshot.write((uint32_t)m_abstract_loads.size());
+        for (auto& l : m_abstract_loads)
+        {
+            snapshot.write(l.first);
+            snapshot.write(l.second.m_magnitude);
+            snapshot.write(l.second.m_azimuth);
+            snapshot.write(l.second.m_altitude);
+            snapshot.write_string(l.second.m_type);
+            Spatial_Design::write_snapshot_coords(snapshot, l.second.m_direction);
+            snapshot.write(l.second.m_lc);
+        }
+    } // write_snapshot()
+
+    SD_Analysis::SD_Analysis(Snapshot_Reader& snapshot, Spatial_Design::MS_Conformal& CF)
+    { // CF is the conformal model restored from the same snapshot
+        m_fea_init = false;
+        m_FEA = new FEA;
+        m_spatial_design = &CF;
+
+        std::vector<Spatial_Design::Geometry::Space*> spaces;
+        for (unsigned int i = 0; i < CF.get_space_count(); i++)
+        {
+            spaces.push_back(CF.get_space(i));
+        }
+
+        snapshot.expect_tag("SDAN");
+        m_mesh_division = snapshot.read<unsigned int>();
+        m_mesh_ghost = snapshot.read<bool>();
+        m_element_clusters = snapshot.read_vector<double>();
+
+        // the points, and the loads and constraints that act on them
+        uint32_t n_points = snapshot.read<uint32_t>();
+        m_all_points.resize(snapshot.read_count(1));
+        if (n_points > m_all_points.size())
+        {
+            std::cerr << "Error, snapshot has more input points than points, exiting now... (SD_Analysis_Snapshot.cpp)" << std::endl;
+            exit(1);
+        }
+        for (auto& p : m_all_points)
+        {
+            p = new Components::Point(Spatial_Design::read_snapshot_coords(snapshot));
+            uint32_t n_load_cases = snapshot.read<uint32_t>();
+            for (unsigned int i = 0; i < n_load_cases; i++)
+            {
+                unsigned int lc = snapshot.read<unsigned int>();
+                for (unsigned int j = 0; j < 6; j++)
+                {
+                    p->update_loads(Components::Load(lc, j, snapshot.read<double>()));
+                }
+            }
+            for (unsigned int i = 0; i < 6; i++)
+            {
+                if (snapshot.read<bool>()) p->update_constraints(Components::Constraint(i));
+            }
+        }
+        m_points.assign(m_all_points.begin(), m_all_points.begin() + n_points);
+
+        // the components and their mesh
+        m_components.resize(snapshot.read_count(1));
+        for (auto& c : m_components)
+        {
+            uint8_t type = snapshot.read<uint8_t>();
+            std::vector<double> props = snapshot.read_vector<double>();
+            std::vector<Components::Point*> points = read_snapshot_pointers(snapshot, m_all_points);
+            std::vector<Components::Load> loads = read_snapshot_loads(snapshot);
+            std::vector<Components::Constraint> constraints = read_snapshot_constraints(snapshot);
+
+            unsigned int n_props[] = {2, 4, 3, 0, 0, 0};
+            unsigned int n_corners = (type == SNAPSHOT_FLAT_SHELL || type == SNAPSHOT_QUADRI_LOAD) ? 4 : 2;
+            if (type > SNAPSHOT_LINE_CONSTRAINT || props.size() != n_props[type] || points.size() != n_corners ||
+                (type == SNAPSHOT_LINE_LOAD && loads.empty()) || (type == SNAPSHOT_QUADRI_LOAD && loads.empty()) ||
+                (type == SNAPSHOT_LINE_CONSTRAINT && constraints.empty()))
+            {
+                std::cerr << "Error, snapshot holds an invalid component, exiting now... (SD_Analysis_Snapshot.cpp)" << std::endl;
+                exit(1);
+            }
+
+            switch (type)
+            {
+            case SNAPSHOT_TRUSS:
+                c = new Components::Truss(props[1], props[0], points[0], points[1]);
+                m_trusses.push_back(c);
+                break;
+            case SNAPSHOT_BEAM:
+                c = new Components::Beam(props[0], props[1], props[2], props[3], points[0], points[1]);
+                m_beams.push_back(c);
+                break;
+            case SNAPSHOT_FLAT_SHELL:
+                c = new Components::Flat_Shell(props[0], props[1], props[2], points[0], points[1], points[2], points[3]);
+                m_flat_shells.push_back(c);
+                break;
+            case SNAPSHOT_LINE_LOAD:
+                c = new Components::Line_Load(loads[0], points[0], points[1]);
+                break;
+            case SNAPSHOT_QUADRI_LOAD:
+                c = new Components::Quadrilateral_Load(loads[0], points[0], points[1], points[2], points[3]);
+                break;
+            default:
+                c = new Components::Line_Constraint(constraints[0], points[0], points[1]);
+                break;
+            }
+
+            c->m_points = points; // the order in which they were sorted
+            c->m_loads = loads;
+            c->m_constraints = constraints;
+            c->m_mesh_switch = snapshot.read<bool>();
+            c->m_is_ghost = snapshot.read<bool>();
+            c->m_visualisation_transparancy = snapshot.read<bool>();
+            c->m_space_ptrs = read_snapshot_pointers(snapshot, spaces);
+
+            c->m_point_list = read_snapshot_pointers(snapshot, m_all_points);
+            c->m_elements.resize(snapshot.read_count(sizeof(uint32_t)));
+            for (auto& e : c->m_elements)
+            {
+                e = read_snapshot_pointers(snapshot, m_all_points);
+            }
+
+            if (type == SNAPSHOT_FLAT_SHELL || type == SNAPSHOT_QUADRI_LOAD)
+            {
+                Components::Quadri_Lateral* q = static_cast<Components::Quadri_Lateral*>(c);
+                q->m_lines.resize(snapshot.read_count(2*sizeof(uint32_t)));
+                for (auto& l : q->m_lines)
+                {
+                    l.first = read_snapshot_pointer(snapshot, m_all_points);
+                    l.second = read_snapshot_pointer(snapshot, m_all_points);
+                }
+                q->m_line_point_list.resize(snapshot.read_count(sizeof(uint32_t)));
+                for (auto& l : q->m_line_point_list)
+                {
+                    l = read_snapshot_pointers(snapshot, m_all_points);
+                }
+                uint32_t n_line_loads = snapshot.read<uint32_t>();
+                for (unsigned int i = 0; i < n_line_loads; i++)
+                {
+                    unsigned int line = snapshot.read<unsigned int>();
+                    q->m_line_loads[line] = read_snapshot_loads(snapshot);
+                }
+                uint32_t n_line_constraints = snapshot.read<uint32_t>();
+                for (unsigned int i = 0; i < n_line_constraints; i++)
+                {
+                    unsigned int line = snapshot.read<unsigned int>();
+                    q->m_line_constraints[line] = read_snapshot_constraints(snapshot);
+                }
+            }
+        }
+
+        // the settings of the model
+        m_truss_props = read_snapshot_props(snapshot, std::vector<double Truss_Props::*>{&Truss_Props::m_A, &Truss_Props::m_E});
+        m_beam_props = read_snapshot_props(snapshot, std::vector<double Beam_Props::*>{&Beam_Props::m_b, &Beam_Props::m_h, &Beam_Props::m_E, &Beam_Props::m_v});
+        m_flat_shell_props = read_snapshot_props(snapshot, std::vector<double Flat_Shell_Props::*>{&Flat_Shell_Props::m_t, &Flat_Shell_Props::m_E, &Flat_Shell_Props::m_v});
+        m_ghost_flat_shell_props = read_snapshot_props(snapshot, std::vector<double Flat_Shell_Props::*>{&Flat_Shell_Props::m_t, &Flat_Shell_Props::m_E, &Flat_Shell_Props::m_v});
+
+        uint32_t n_abstract_loads = snapshot.read<uint32_t>();
+        for (unsigned int i = 0; i < n_abstract_loads; i++)
+        {
+            Abstract_Load& l = m_abstract_loads[snapshot.read<unsigned int>()];
+            l.m_magnitude = snapshot.read<double>();
+            l.m_azimuth = snapshot.read<double>();
+            l.m_altitude = snapshot.read<double>();
+            l.m_type = snapshot.read_string();
+            l.m_direction = Spatial_Design::read_snapshot_coords(snapshot);
+            l.m_lc = snapshot.read<unsigned int>();
+        }
+
+        // the components are meshed already, only the finite element model is generated (with the ghost components if they were meshed)
+        generate_FEA(m_mesh_ghost);
+    } // ctor
+
+} // namespace Structural_Design
+} // namespace BSO
+
+#endif // SD_ANALYSIS_SNAPSHOT_CPP
@@ -88,6 +88,7 @@ namespace BSO { namespace Structural_Design
         double m_struct_volume; // total structural volume of components
         double m_struct_ghost_volume; // structural volume of ghost components
         std::map<unsigned int, double> m_compliances; // compliances for each load case of non ghost components
+        bool m_partial; // true if only the building and space results are given, not the component and element results (e.g. results from an Evaluation_Cache)
 
         int* m_number_copies; // number of copies of this structure currently out there (required to track memory release, see destructor)
 
@@ -247,6 +248,7 @@ namespace BSO { namespace Structural_Design
 
     void SD_Building_Results::obtain_results()
     {
+        m_partial = false;
         m_total_compliance = 0;
         m_total_ghost_compliance = 0;
         m_struct_volume = 0;
@@ -366,6 +368,7 @@ namespace BSO { namespace Structural_Design
     {
         m_number_copies = new int;
         *m_number_copies = 1;
+        m_partial = false;
     }
 
     SD_Building_Results::SD_Building_Results(const SD_Building_Results& rhs)
@@ -382,6 +385,7 @@ namespace BSO { namespace Structural_Design
         m_total_compliance = rhs.m_total_compliance;
         m_total_ghost_compliance = rhs.m_total_ghost_compliance;
         m_compliances = rhs.m_compliances;
+        m_partial = rhs.m_partial;
 
         m_element_clusters = rhs.m_element_clusters;
     }
@@ -403,6 +407,7 @@ namespace BSO { namespace Structural_Design
         m_total_ghost_compliance = rhs.m_total_ghost_compliance;
         m_compliances = rhs.m_compliances;
 		m_struct_volume = rhs.m_struct_volume;
+        m_partial = rhs.m_partial;
 
         m_element_clusters = rhs.m_element_clusters;
 
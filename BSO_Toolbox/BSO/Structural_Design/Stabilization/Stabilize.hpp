@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <iostream>
 #include <map>
+#include <BSO/Profiler.hpp>
 #include <BSO/Structural_Design/SD_Analysis.hpp>
 #include <BSO/Structural_Design/Components/Point_Comp.hpp>
 #include <BSO/Structural_Design/Stabilization/Grid.hpp>
@@ -296,6 +297,9 @@ namespace BSO { namespace Structural_Design { namespace Stabilization
 
 	void Stabilize::stabilize_free_dofs_zoned(unsigned int method)
 	{
+		BSO_PROFILE_SCOPE("Stabilize::stabilize_free_dofs_zoned");
+		BSO_PROFILE_COUNT("Stabilize rounds", 1);
+		BSO_PROFILE_SAMPLE("Stabilize points with free dofs", free_dofs.size());
 
 		std::map<std::vector<unsigned int>, Components::Point*>::iterator it_1; // grid_points
 		std::map<Components::Point*, std::vector<unsigned int> >::iterator it_2; // free_dofs
@@ -1456,6 +1460,9 @@ namespace BSO { namespace Structural_Design { namespace Stabilization
 
 	bool Stabilize::stabilize_free_dofs(unsigned int method)
 	{
+		BSO_PROFILE_SCOPE("Stabilize::stabilize_free_dofs");
+		BSO_PROFILE_COUNT("Stabilize rounds", 1);
+		BSO_PROFILE_SAMPLE("Stabilize points with free dofs", free_dofs.size());
 		bool stabilization_possible = true;
 
 		std::vector<vector<vector<coord*>>>::iterator it_x; // grid-location x
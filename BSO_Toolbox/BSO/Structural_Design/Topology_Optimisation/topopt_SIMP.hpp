@@ -17,8 +17,8 @@
 
 namespace BSO { namespace Structural_Design {
 
-    void topopt_SIMP(FEA* fea_ptr, double f, double r_min, double penal, double x_move, double tol)
-    {
+    void topopt_SIMP(FEA* fea_ptr, double f, double r_min, double penal, double x_move, double tol, unsigned int max_loops = 0)
+    { // stops when the largest change of a density is below tol, or after max_loops iterations (0: no limit)
         unsigned int num_el = fea_ptr->get_element_count();
         double total_volume = 0; // initialised at 0, before each element volumes are added
         double c; // sum of all the elements compliances (objective value)
@@ -67,7 +67,7 @@ namespace BSO { namespace Structural_Design {
         double loop_start = clock(), iteration_start, time_end = 0.0;
 
         // start iteration
-        while (change > tol)
+        while (change > tol && (max_loops == 0 || loop < (int)max_loops))
         {
             iteration_start = clock();
             if (loop%20 == 0)
@@ -3,126 +3,94 @@
 
 #include <BSO/Vectors.hpp>
 
+#include <algorithm>
+#include <climits>
+
 namespace BSO { namespace XML {
 
+enum xml_tag {MODEL, VERSION, NAME, CONSTRUCTIONS, CONSTRUCTION, CONSTRUCTION_NAME, GEOMETRY, PLANE,
+              SPACES, SPACE, SPACE_NAME, CONSTRUCTION_IDS, XML_TAG_COUNT};
+
+const char* const xml_tags[2][XML_TAG_COUNT] = {
+    {"building_model", "version", "name", "constructions", "construction", "rectangle_", "geometry", "plane",
+     "spaces", "space", "simple", "construction_ids"}, // language 1
+    {"gebouwmodel", "versie", "naam", "constructies", "constructie", "rechthoek_", "geometrie", "vlak",
+     "ruimtes", "ruimte", "simpel", "constructieids"}}; // language 2
+
+bool is_xml_tag(const std::string& name, unsigned int n)
+{ // whether name is tag n in any of the languages
+    return (name == xml_tags[0][n] || name == xml_tags[1][n]);
+} // is_xml_tag()
+
+class XML_Model_Reader : public XML_Handler
+{ // stores the elements of an XML file in an XML_Model
+private:
+    XML_Model& m_model;
+    std::string m_file_name;
+    unsigned int m_depth;
+    std::vector<double> m_values;
+
+    unsigned int read_ID(const XML_Attributes& attributes);
+public:
+    XML_Model_Reader(XML_Model& model, std::string file_name);
+
+    void start_element(const std::string& name, const XML_Attributes& attributes);
+    void text(const std::string& name, const char* first, const char* last);
+    void end_element(const std::string& name);
+}; // XML_Model_Reader
+
 XML_Model::XML_Model(Spatial_Design::MS_Conformal& CF, std::string version, int language)
 {
     // constructor to initialise the XML data model with a conformal spatial design
     unsigned int space_count = CF.get_space_count(); // number of spaces in the conformal design
     unsigned int rectangle_count = CF.get_rectangle_count(); // number of rectangles in the design
-    m_pt.clear();
-    if (language == 1)
+    if (language != 1 && language != 2)
     {
-
-        using boost::property_tree::ptree;
-        m_pt.put("building_model.<xmlattr>.version", version);
-        m_pt.put("building_model.<xmlattr>.name", "");
-
-        // initialise every construction including its geometry
-        for (unsigned int i = 0; i < rectangle_count; i++)
-        { // for each rectangle in the conformal design
-            if (CF.get_rectangle(i)->get_surface_count() > 0)
-            { // if the rectangle belongs to a surface
-                m_rectangle_ptrs[CF.get_rectangle(i)] = i+1; // add an ID to that rectangle and link it to the pointer of the rectangle
-                ptree& constr_node = m_pt.add("building_model.constructions.construction", "");
-                constr_node.put("<xmlattr>.name", "rectangle_" + std::to_string(i+1));
-                constr_node.put("<xmlattr>.id", i+1);
-
-                std::vector<double> coordinates;
-
-                for (int j = 0; j < 4; j++)
-                { // for each vertex of the rectangle
-                    Vectors::Point temp_coords = CF.get_rectangle(i)->get_vertex_ptr(j)->get_coords(); // get the coordinates of vertex j
-                    coordinates.push_back(temp_coords(0)); // x-coordinate of vertex j temp_coords(0)
-                    coordinates.push_back(temp_coords(1)); // y-coordinate of vertex j
-                    coordinates.push_back(temp_coords(2)); // z-coordinate of vertex j
-                } // end all vertices of rectangle i
-
-
-                ptree& geo_node = constr_node.put("geometry", coordinates);
-                geo_node.put("<xmlattr>.type", "plane");
-            }
-        } // end for each rectangle
-
-        // add the construction ids for each space
-        for (unsigned int i = 0; i < space_count; i++)
-        { // for each space in the conformal design
-            m_space_ptrs[CF.get_space(i)] = i+1; // add an ID to that space and link it to the pointer of the space
-            ptree& space_node = m_pt.add("building_model.spaces.space", "");
-            space_node.put("<xmlattr>.name", "simple");
-            space_node.put("<xmlattr>.id", i+1);
-
-            std::vector<int> construction_id_list;
-
-            for (unsigned int j = 0; j < 6; j++)
-            { // for each surface
-                for (unsigned int k = 0; k < CF.get_space(i)->get_surface_ptr(j)->get_rectangle_count(); k++)
-                { // and for each rectangle in that surface
-                    Spatial_Design::Geometry::Rectangle* temp_ptr = CF.get_space(i)->get_surface_ptr(j)->get_rectangle_ptr(k);
-                    construction_id_list.push_back(m_rectangle_ptrs[temp_ptr]); // check if it exists first!
-                }
-            }
-
-            space_node.put("construction_ids", construction_id_list);
-
-        } // end for each space
+        std::cerr << "Error, XML language " << language << " does not exist (1: English, 2: Dutch), exiting now... (XML_Model.cpp)" << std::endl;
+        exit(1);
     }
-    else if (language == 2)
-    {
-                using boost::property_tree::ptree;
-        m_pt.put("gebouwmodel.<xmlattr>.versie", version);
-        m_pt.put("gebouwmodel.<xmlattr>.naam", "");
-
-        // initialise every construction including its geometry
-        for (unsigned int i = 0; i < rectangle_count; i++)
-        { // for each rectangle in the conformal design
-            if (CF.get_rectangle(i)->get_surface_count() > 0)
-            { // if the rectangle belongs to a surface
-                m_rectangle_ptrs[CF.get_rectangle(i)] = i+1; // add an ID to that rectangle and link it to the pointer of the rectangle
-                ptree& constr_node = m_pt.add("gebouwmodel.constructies.constructie", "");
-                constr_node.put("<xmlattr>.naam", "rechthoek_" + std::to_string(i+1));
-                constr_node.put("<xmlattr>.id", i+1);
-
-                std::vector<double> coordinates;
-
-                for (int j = 0; j < 4; j++)
-                { // for each vertex of the rectangle
-                    Vectors::Point temp_coords = CF.get_rectangle(i)->get_vertex_ptr(j)->get_coords(); // get the coordinates of vertex j
-                    coordinates.push_back(temp_coords(0)); // x-coordinate of vertex j temp_coords(0)
-                    coordinates.push_back(temp_coords(1)); // y-coordinate of vertex j
-                    coordinates.push_back(temp_coords(2)); // z-coordinate of vertex j
-                } // end all vertices of rectangle i
-
-
-                ptree& geo_node = constr_node.put("geometrie", coordinates);
-                geo_node.put("<xmlattr>.type", "vlak");
-            }
-        } // end for each rectangle
-
-        // add the construction ids for each space
-        for (unsigned int i = 0; i < space_count; i++)
-        { // for each space in the conformal design
-            m_space_ptrs[CF.get_space(i)] = i+1; // add an ID to that space and link it to the pointer of the space
-            ptree& space_node = m_pt.add("gebouwmodel.ruimtes.ruimte", "");
-            space_node.put("<xmlattr>.naam", "simpel");
-            space_node.put("<xmlattr>.id", i+1);
-
-            std::vector<int> construction_id_list;
-
-            for (unsigned int j = 0; j < 6; j++)
-            { // for each surface
-                for (unsigned int k = 0; k < CF.get_space(i)->get_surface_ptr(j)->get_rectangle_count(); k++)
-                { // and for each rectangle in that surface
-                    Spatial_Design::Geometry::Rectangle* temp_ptr = CF.get_space(i)->get_surface_ptr(j)->get_rectangle_ptr(k);
-                    construction_id_list.push_back(m_rectangle_ptrs[temp_ptr]); // check if it exists first!
+    m_language = language;
+    m_version = version;
+    m_name = "";
+    m_structural_design = false;
+
+    // initialise every construction including its geometry
+    std::vector<std::pair<Spatial_Design::Geometry::Rectangle*, unsigned int> > rectangle_IDs; // sorted, to find the ID of a rectangle
+    for (unsigned int i = 0; i < rectangle_count; i++)
+    { // for each rectangle in the conformal design
+        Spatial_Design::Geometry::Rectangle* rec_ptr = CF.get_rectangle(i);
+        if (rec_ptr->get_surface_count() > 0)
+        { // if the rectangle belongs to a surface
+            rectangle_IDs.push_back(std::make_pair(rec_ptr, i+1)); // add an ID to that rectangle
+            m_construction_IDs.push_back(i+1);
+            for (int j = 0; j < 4; j++)
+            { // for each vertex of the rectangle
+                Vectors::Point temp_coords = rec_ptr->get_vertex_ptr(j)->get_coords(); // get the coordinates of vertex j
+                for (int k = 0; k < 3; k++)
+                {
+                    m_construction_coords.push_back(temp_coords(k));
                 }
             }
-
-            space_node.put("constructieids", construction_id_list);
-
-        } // end for each space
-
-    }
+        }
+    } // end for each rectangle
+    std::sort(rectangle_IDs.begin(), rectangle_IDs.end());
+
+    // add the construction ids for each space
+    m_space_begin.push_back(0);
+    for (unsigned int i = 0; i < space_count; i++)
+    { // for each space in the conformal design
+        m_space_IDs.push_back(i+1);
+        for (unsigned int j = 0; j < 6; j++)
+        { // for each surface
+            for (unsigned int k = 0; k < CF.get_space(i)->get_surface_ptr(j)->get_rectangle_count(); k++)
+            { // and for each rectangle in that surface
+                Spatial_Design::Geometry::Rectangle* temp_ptr = CF.get_space(i)->get_surface_ptr(j)->get_rectangle_ptr(k);
+                auto ite = std::lower_bound(rectangle_IDs.begin(), rectangle_IDs.end(), std::make_pair(temp_ptr, 0u));
+                m_space_construction_IDs.push_back((ite != rectangle_IDs.end() && ite->first == temp_ptr) ? ite->second : 0);
+            }
+        }
+        m_space_begin.push_back(m_space_construction_IDs.size());
+    } // end for each space
 } // ctor
 
 XML_Model::XML_Model(std::string file_name)
@@ -135,50 +103,33 @@ XML_Model::~XML_Model()
 
 } // dtor
 
+const char* XML_Model::tag(unsigned int n)
+{
+    return xml_tags[m_language - 1][n];
+} // tag()
+
 #ifdef SD_ANALYSIS_HPP
 void XML_Model::add_structural_design(Structural_Design::SD_Analysis& SD)
 {
-    // check if this SD_model has been initiated with the same conformal design
-    unsigned int n_components = SD.get_component_count();
-    for (unsigned int i = 0; i < n_components; i++)
-    {
-        //Structural_Design::Components::Component* temp_ptr = SD.get_component_ptr(i);
-        //if (temp_ptr->is_flat_shell())
-    }
-
-    using boost::property_tree::ptree;
-    ptree& SD_node = m_pt.put("building_model.structural_design", "");
-
-    for (unsigned int i = 0; i < SD.get_flat_shell_props().size(); i++)
+    m_structural_design = true;
+    m_structural_properties.clear();
+    for (auto& p : SD.get_flat_shell_props())
     { // for each structural property set
-        ptree& SD_prop_node = SD_node.add("structural_property", "");
-        SD_prop_node.put("<xmlattr>.id", SD.get_flat_shell_props()[i].m_ID);
-        SD_prop_node.put("<xmlattr>.type", "flat_shell_props");
-        SD_prop_node.put("thickness", SD.get_flat_shell_props()[i].m_t);
-        SD_prop_node.put("youngs_modulus", SD.get_flat_shell_props()[i].m_E);
-        SD_prop_node.put("poisson_ratio", SD.get_flat_shell_props()[i].m_v);
-
-        std::vector<int> construction_ids;
-        for (unsigned int j = 0; j < 3; j++)
-        { // for each construction id to which this property set is assigned
-            //construction_ids.push_back(1); // add this
-        }
-
-        if(construction_ids.size() != 0)
-        {
-            SD_prop_node.add("construction_ids", construction_ids);
-        }
-
+        XML_Structural_Property temp_prop;
+        temp_prop.m_ID = p.m_ID;
+        temp_prop.m_type = "flat_shell_props";
+        temp_prop.m_t = p.m_t;
+        temp_prop.m_E = p.m_E;
+        temp_prop.m_v = p.m_v;
+        m_structural_properties.push_back(temp_prop);
     }
-
-
 } // add_structural_design()
 #endif // SD_ANALYSIS_HPP
 
 #ifdef BP_SIMULATION_HPP
 void XML_Model::add_building_physics_design(Building_Physics::BP_Simulation& BP)
 {
-    // check if this SD_model has been initiated with the same conformal design
+    // the building physics design has no elements in the XML model yet
 
 } // add_building_physics_design()
 #endif // BP_SIMULATION_HPP
@@ -194,64 +145,54 @@ void XML_Model::init_MS_building(Spatial_Design::MS_Building& MS)
     // initialise the MS building design to an empty design
     MS.clear_design();
 
-    // for every space that is listed in the ptree
-    using boost::property_tree::ptree;
-    BOOST_FOREACH(ptree::value_type const&v, m_pt.get_child("gebouwmodel.ruimtes"))
-    { // for each space
-
-        std::vector<std::string> construction_ids;
-        if (v.first == "ruimte")
-        {
-            construction_ids = v.second.get<std::vector<std::string> >("constructieids");
-        }
-        else
+    // the index of each construction, by its ID
+    std::vector<unsigned int> construction_index;
+    for (unsigned int i = 0; i < m_construction_IDs.size(); i++)
+    {
+        if (m_construction_IDs[i] >= construction_index.size())
         {
-            continue;
+            construction_index.resize(m_construction_IDs[i] + 1, UINT_MAX);
         }
-        // get the minimum and maximum coordinates
-        // store the coordinates of each construction
-        std::map<std::string, std::vector<double> > construction_coords;
-        BOOST_FOREACH(ptree::value_type const&w, m_pt.get_child("gebouwmodel.constructies"))
-        { // for each construction
-            if (w.first == "constructie")
+        construction_index[m_construction_IDs[i]] = i;
+    }
+
+    for (unsigned int i = 0; i < m_space_IDs.size(); i++)
+    { // for each space
+        // get the minimum and maximum coordinates of the constructions of the space
+        Vectors::Point min, max;
+        for (unsigned int j = m_space_begin[i]; j < m_space_begin[i+1]; j++)
+        { // for each construction belonging to the space
+            unsigned int ID = m_space_construction_IDs[j];
+            if (ID >= construction_index.size() || construction_index[ID] == UINT_MAX)
             {
-                construction_coords[w.second.get<std::string>("<xmlattr>.id")] = w.second.get<std::vector<double> >("geometrie");
+                std::cerr << "Error, space " << m_space_IDs[i] << " refers to construction " << ID
+                          << " which does not exist, exiting now... (XML_Model.cpp)" << std::endl;
+                exit(1);
             }
-        }
-
-        Vectors::Point min;
-        min(0) = construction_coords.begin()->second[0];
-        min(1) = construction_coords.begin()->second[1];
-        min(2) = construction_coords.begin()->second[2];
-        Vectors::Point max = min;
-
-        for (auto w : construction_ids)
-        { // for each construction belonging to the space w
-
-            std::vector<double> temp_coords = construction_coords[w];
-
-            for (unsigned int i = 0; i*3 < temp_coords.size(); i += 3)
-            { // for each coordinate that is present
-                for (unsigned int j = 0; j < 3; j++)
-                { // for each dof of that coordinate
-                    if (min(j) > temp_coords[i*3+j])
+            const double* temp_coords = &m_construction_coords[12*construction_index[ID]];
+            for (unsigned int k = 0; k < 4; k++)
+            { // for each vertex of the construction
+                for (unsigned int l = 0; l < 3; l++)
+                { // for each dof of that vertex
+                    if (j == m_space_begin[i] && k == 0)
                     {
-                        min(j) = temp_coords[i*3+j];
-                    }
-
-                    if (max(j) < temp_coords[i*3+j])
-                    {
-                        max(j) = temp_coords[i*3+j];
+                        min(l) = max(l) = temp_coords[l];
                     }
+                    min(l) = std::min(min(l), temp_coords[3*k+l]);
+                    max(l) = std::max(max(l), temp_coords[3*k+l]);
                 }
             }
         }
+        if (m_space_begin[i] == m_space_begin[i+1])
+        {
+            continue; // a space without constructions
+        }
 
         // use the coordinates to initialise a space
         max -= min;
         Spatial_Design::MS_Space temp_space;
 
-        temp_space.ID = 1;//v.second.get<std::string>("<xmlattr>.id");
+        temp_space.ID = 1;//m_space_IDs[i];
         temp_space.width = max(0);
         temp_space.depth = max(1);
         temp_space.height = max(2);
@@ -269,19 +210,185 @@ void XML_Model::init_MS_building(Spatial_Design::MS_Building& MS)
 void XML_Model::write_xml_file(std::string file_name)
 {
     std::ofstream os(file_name.c_str());
-    boost::property_tree::write_xml(os, m_pt, boost::property_tree::xml_writer_settings<std::string>(' ', 2));
-    os.close();
+    XML_Writer xml(os);
+    if (m_language != 0)
+    {
+        xml.start_element(tag(MODEL), {{tag(VERSION), m_version}, {tag(NAME), m_name}});
+
+        if (!m_construction_IDs.empty())
+        {
+            xml.start_element(tag(CONSTRUCTIONS));
+            for (unsigned int i = 0; i < m_construction_IDs.size(); i++)
+            { // for each construction
+                std::string ID = std::to_string(m_construction_IDs[i]);
+                xml.start_element(tag(CONSTRUCTION), {{tag(NAME), tag(CONSTRUCTION_NAME) + ID}, {"id", ID}});
+                xml.text_element(tag(GEOMETRY), xml_list(&m_construction_coords[12*i], 12), {{"type", tag(PLANE)}});
+                xml.end_element();
+            }
+            xml.end_element();
+        }
+
+        if (!m_space_IDs.empty())
+        {
+            xml.start_element(tag(SPACES));
+            for (unsigned int i = 0; i < m_space_IDs.size(); i++)
+            { // for each space
+                xml.start_element(tag(SPACE), {{tag(NAME), tag(SPACE_NAME)}, {"id", std::to_string(m_space_IDs[i])}});
+                xml.text_element(tag(CONSTRUCTION_IDS), xml_list(m_space_construction_IDs.data() + m_space_begin[i], m_space_begin[i+1] - m_space_begin[i]));
+                xml.end_element();
+            }
+            xml.end_element();
+        }
+
+        if (m_language == 2)
+        { // the structural design has no Dutch element names, it is written in a building_model element
+            xml.end_element();
+        }
+    }
+
+    if (m_structural_design)
+    {
+        if (m_language != 1) xml.start_element("building_model");
+        xml.start_element("structural_design");
+        for (auto& p : m_structural_properties)
+        { // for each structural property set
+            xml.start_element("structural_property", {{"id", p.m_ID}, {"type", p.m_type}});
+            xml.text_element("thickness", xml_value(p.m_t));
+            xml.text_element("youngs_modulus", xml_value(p.m_E));
+            xml.text_element("poisson_ratio", xml_value(p.m_v));
+            xml.end_element();
+        }
+        xml.end_element();
+        if (m_language != 1) xml.end_element();
+    }
+
+    if (m_language == 1)
+    {
+        xml.end_element();
+    }
 } //write_xml()
 
 void XML_Model::read_xml_file(std::string file_name)
 {
-    m_pt.clear();
-    std::ifstream is(file_name.c_str());
-    boost::property_tree::read_xml(is, m_pt);
-    is.close();
-
+    m_language = 0;
+    m_version.clear();
+    m_name.clear();
+    m_construction_IDs.clear();
+    m_construction_coords.clear();
+    m_space_IDs.clear();
+    m_space_begin.assign(1, 0);
+    m_space_construction_IDs.clear();
+    m_structural_design = false;
+    m_structural_properties.clear();
+
+    XML_Reader reader(file_name);
+    XML_Model_Reader handler(*this, file_name);
+    reader.parse(handler);
 } // read_xml()
 
+XML_Model_Reader::XML_Model_Reader(XML_Model& model, std::string file_name) : m_model(model)
+{
+    m_file_name = file_name;
+    m_depth = 0;
+} // ctor
+
+unsigned int XML_Model_Reader::read_ID(const XML_Attributes& attributes)
+{
+    std::string ID = get_xml_attribute(attributes, "id");
+    unsigned long value;
+    if (!parse_number(ID.data(), ID.data() + ID.size(), value) || value > UINT_MAX)
+    {
+        std::cerr << "Error in XML file \"" << m_file_name << "\": expected an unsigned integer as id but found \""
+                  << ID << "\", exiting now... (XML_Model.cpp)" << std::endl;
+        exit(1);
+    }
+    return value;
+} // read_ID()
+
+void XML_Model_Reader::start_element(const std::string& name, const XML_Attributes& attributes)
+{
+    m_depth++;
+    if (m_depth == 1 && m_model.m_language == 0)
+    { // the first building model, the structural design may follow in a second one
+        for (int i = 0; i < 2; i++)
+        {
+            if (name == xml_tags[i][MODEL])
+            {
+                m_model.m_language = i + 1;
+                m_model.m_version = get_xml_attribute(attributes, xml_tags[i][VERSION]);
+                m_model.m_name = get_xml_attribute(attributes, xml_tags[i][NAME]);
+            }
+        }
+    }
+    else if (is_xml_tag(name, CONSTRUCTION))
+    {
+        m_model.m_construction_IDs.push_back(read_ID(attributes));
+        m_model.m_construction_coords.resize(m_model.m_construction_coords.size() + 12, 0.0);
+    }
+    else if (is_xml_tag(name, SPACE))
+    {
+        m_model.m_space_IDs.push_back(read_ID(attributes));
+        m_model.m_space_begin.push_back(m_model.m_space_construction_IDs.size());
+    }
+    else if (name == "structural_design")
+    {
+        m_model.m_structural_design = true;
+    }
+    else if (name == "structural_property")
+    {
+        XML_Structural_Property temp_prop;
+        temp_prop.m_ID = get_xml_attribute(attributes, "id");
+        temp_prop.m_type = get_xml_attribute(attributes, "type");
+        temp_prop.m_t = temp_prop.m_E = temp_prop.m_v = 0;
+        m_model.m_structural_properties.push_back(temp_prop);
+    }
+} // start_element()
+
+void XML_Model_Reader::text(const std::string& name, const char* first, const char* last)
+{
+    if (is_xml_tag(name, GEOMETRY) && !m_model.m_construction_IDs.empty())
+    {
+        if (!parse_xml_list(first, last, m_values) || m_values.size() != 12)
+        {
+            std::cerr << "Error in XML file \"" << m_file_name << "\": expected the 12 coordinates of the vertices of construction "
+                      << m_model.m_construction_IDs.back() << " but found \"" << std::string(first, last) << "\", exiting now... (XML_Model.cpp)" << std::endl;
+            exit(1);
+        }
+        std::copy(m_values.begin(), m_values.end(), m_model.m_construction_coords.end() - 12);
+    }
+    else if (is_xml_tag(name, CONSTRUCTION_IDS) && !m_model.m_space_IDs.empty())
+    {
+        std::vector<unsigned int> IDs;
+        if (!parse_xml_list(first, last, IDs))
+        {
+            std::cerr << "Error in XML file \"" << m_file_name << "\": expected the construction IDs of space "
+                      << m_model.m_space_IDs.back() << " but found \"" << std::string(first, last) << "\", exiting now... (XML_Model.cpp)" << std::endl;
+            exit(1);
+        }
+        m_model.m_space_construction_IDs.insert(m_model.m_space_construction_IDs.end(), IDs.begin(), IDs.end());
+        m_model.m_space_begin.back() = m_model.m_space_construction_IDs.size();
+    }
+    else if ((name == "thickness" || name == "youngs_modulus" || name == "poisson_ratio") && !m_model.m_structural_properties.empty())
+    {
+        double value;
+        if (!parse_number(first, last, value))
+        {
+            std::cerr << "Error in XML file \"" << m_file_name << "\": expected a number as " << name
+                      << " but found \"" << std::string(first, last) << "\", exiting now... (XML_Model.cpp)" << std::endl;
+            exit(1);
+        }
+        XML_Structural_Property& p = m_model.m_structural_properties.back();
+        if (name == "thickness") p.m_t = value;
+        else if (name == "youngs_modulus") p.m_E = value;
+        else p.m_v = value;
+    }
+} // text()
+
+void XML_Model_Reader::end_element(const std::string& name)
+{
+    m_depth--;
+} // end_element()
+
 } // namespace XML
 } // namespace BSO
 
@@ -11,22 +11,51 @@
 #include <BSO/Building_Physics/BP_Simulation.hpp>
 #endif // BP_SIMULATION_HPP
 
-#include <BSO/XML/XML_Vector_Translator.hpp>
+#include <BSO/XML/XML_Stream.hpp>
 
-#include <map>
-#include <boost/foreach.hpp>
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/xml_parser.hpp>
+#include <vector>
 
 namespace BSO { namespace XML {
 
+/*
+ * XML_Model holds a building model in the form in which it is exchanged as XML:
+ * constructions (each a rectangle of four vertices), spaces (each a list of construction
+ * IDs) and the structural properties. The data is kept in dense arrays, from which the
+ * XML file is written element by element, and in which it is read (see XML_Stream.hpp).
+ * language 1 gives English element names, language 2 Dutch element names.
+ */
+
+struct XML_Structural_Property
+{
+    std::string m_ID;
+    std::string m_type;
+    double m_t;
+    double m_E;
+    double m_v;
+}; // XML_Structural_Property
+
+class XML_Model_Reader;
+
 class XML_Model
 {
 private:
-    std::map<Spatial_Design::Geometry::Rectangle*, unsigned int> m_rectangle_ptrs;
-    std::map<Spatial_Design::Geometry::Space*, unsigned int> m_space_ptrs;
+    friend class XML_Model_Reader;
+
+    int m_language; // 0 if no building model has been initialised or read
+    std::string m_version;
+    std::string m_name;
+
+    std::vector<unsigned int> m_construction_IDs;
+    std::vector<double> m_construction_coords; // 12 coordinates for each construction, the vertices of its rectangle
+
+    std::vector<unsigned int> m_space_IDs;
+    std::vector<unsigned int> m_space_begin; // the construction IDs of space i are m_space_construction_IDs[m_space_begin[i]] up to [m_space_begin[i+1]]
+    std::vector<unsigned int> m_space_construction_IDs;
+
+    bool m_structural_design;
+    std::vector<XML_Structural_Property> m_structural_properties;
 
-    boost::property_tree::ptree m_pt;
+    const char* tag(unsigned int n); // the element or attribute name n in the language of the model
 public:
     XML_Model(Spatial_Design::MS_Conformal&, std::string, int);
     XML_Model(std::string);
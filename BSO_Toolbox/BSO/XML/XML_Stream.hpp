@@ -0,0 +1,445 @@
+#ifndef XML_STREAM_HPP
+#define XML_STREAM_HPP
+
+#include <BSO/Field_Scanner.hpp>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+namespace BSO { namespace XML {
+
+    /*
+     * XML_Writer writes an XML document element by element to a stream, with the same
+     * layout as boost::property_tree::write_xml() with an indentation of two spaces, so
+     * that a document does not have to be built in memory before it is written.
+     *
+     * XML_Reader reads an XML document in one block and passes its elements to an
+     * XML_Handler (SAX-style): the start of an element with its attributes, its text
+     * (trimmed, entities decoded) and its end. The reader covers the XML that is written
+     * by XML_Writer and by hand: declarations, comments, CDATA and DOCTYPE are skipped.
+     */
+
+    typedef std::vector<std::pair<std::string, std::string> > XML_Attributes;
+
+    // Function declarations
+
+    std::string encode_xml_entities(const std::string& s);
+    std::string get_xml_attribute(const XML_Attributes& attributes, const char* name); // an empty string if the attribute is not present
+
+    template<typename T>
+    std::string xml_list(const T* values, unsigned int n); // space separated values, like XML_Vector_Translator.hpp
+    template<typename T>
+    std::string xml_value(const T& value); // one value, like boost::property_tree::ptree::put()
+
+    bool parse_xml_list(const char* first, const char* last, std::vector<double>& values);
+    bool parse_xml_list(const char* first, const char* last, std::vector<unsigned int>& values);
+
+    // Class definitions
+
+    class XML_Writer
+    {
+    private:
+        std::ostream& m_stream;
+        std::vector<std::string> m_open_elements;
+        bool m_start_tag_open; // the '>' of the start tag of the last element has not been written yet
+    public:
+        XML_Writer(std::ostream& stream);
+        ~XML_Writer();
+
+        void start_element(const std::string& name, const XML_Attributes& attributes = XML_Attributes());
+        void end_element();
+        void text_element(const std::string& name, const std::string& text, const XML_Attributes& attributes = XML_Attributes()); // an element that holds text only
+    }; // XML_Writer
+
+    class XML_Handler
+    {
+    public:
+        virtual ~XML_Handler() {}
+        virtual void start_element(const std::string& name, const XML_Attributes& attributes) = 0;
+        virtual void text(const std::string& name, const char* first, const char* last) = 0; // the text of element name, [first, last) holds no entities
+        virtual void end_element(const std::string& name) = 0;
+    }; // XML_Handler
+
+    class XML_Reader
+    {
+    private:
+        std::string m_file_name;
+        std::string m_buffer;
+        std::size_t m_position;
+
+        void error(const std::string& message);
+        bool starts_with(const char* s);
+        void skip_past(const char* s);
+        void skip_white_space();
+        std::string read_name();
+        std::string decode(const char* first, const char* last);
+    public:
+        XML_Reader(std::string file_name);
+        void parse(XML_Handler& handler);
+    }; // XML_Reader
+
+
+    // Implementation of functions:
+
+    std::string encode_xml_entities(const std::string& s)
+    { // like boost::property_tree::xml_parser::encode_char_entities()
+        if (s.empty())
+        {
+            return s;
+        }
+        if (s.find_first_not_of(' ') == std::string::npos)
+        { // text with only spaces is kept by encoding the first one
+            return "&#32;" + std::string(s.size() - 1, ' ');
+        }
+        std::string r;
+        for (char c : s)
+        {
+            switch (c)
+            {
+                case '<': r += "&lt;"; break;
+                case '>': r += "&gt;"; break;
+                case '&': r += "&amp;"; break;
+                case '"': r += "&quot;"; break;
+                case '\'': r += "&apos;"; break;
+                default: r += c; break;
+            }
+        }
+        return r;
+    } // encode_xml_entities()
+
+    std::string get_xml_attribute(const XML_Attributes& attributes, const char* name)
+    {
+        for (auto& a : attributes)
+        {
+            if (a.first == name)
+            {
+                return a.second;
+            }
+        }
+        return "";
+    } // get_xml_attribute()
+
+    template<typename T>
+    std::string xml_list(const T* values, unsigned int n)
+    {
+        std::stringstream ss;
+        for (unsigned int i = 0; i < n; i++)
+        {
+            ss << (i?" ":"") << values[i];
+        }
+        return ss.str();
+    } // xml_list()
+
+    template<typename T>
+    std::string xml_value(const T& value)
+    {
+        std::stringstream ss;
+        if (!std::numeric_limits<T>::is_exact)
+        {
+            ss.precision(std::numeric_limits<T>::max_digits10);
+        }
+        ss << value;
+        return ss.str();
+    } // xml_value()
+
+    bool parse_xml_list(const char* first, const char* last, std::vector<double>& values)
+    {
+        values.clear();
+        while (first != last)
+        {
+            const char* end = first;
+            while (end != last && !std::isspace((unsigned char)*end)) end++;
+            if (end != first)
+            {
+                double value;
+                if (!parse_number(first, end, value))
+                {
+                    return false;
+                }
+                values.push_back(value);
+            }
+            first = (end == last) ? last : end + 1;
+        }
+        return true;
+    } // parse_xml_list()
+
+    bool parse_xml_list(const char* first, const char* last, std::vector<unsigned int>& values)
+    {
+        values.clear();
+        while (first != last)
+        {
+            const char* end = first;
+            while (end != last && !std::isspace((unsigned char)*end)) end++;
+            if (end != first)
+            {
+                unsigned long value;
+                if (!parse_number(first, end, value) || value > UINT_MAX)
+                {
+                    return false;
+                }
+                values.push_back((unsigned int)value);
+            }
+            first = (end == last) ? last : end + 1;
+        }
+        return true;
+    } // parse_xml_list()
+
+    XML_Writer::XML_Writer(std::ostream& stream) : m_stream(stream)
+    {
+        m_start_tag_open = false;
+        m_stream << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+    } // ctor
+
+    XML_Writer::~XML_Writer()
+    {
+        while (!m_open_elements.empty())
+        {
+            end_element();
+        }
+    } // dtor
+
+    void XML_Writer::start_element(const std::string& name, const XML_Attributes& attributes)
+    { // the start tag is completed when it is known whether the element is empty
+        if (m_start_tag_open)
+        { // the parent element holds elements
+            m_stream << ">\n";
+        }
+        m_stream << std::string(2*m_open_elements.size(), ' ') << "<" << name;
+        for (auto& a : attributes)
+        {
+            m_stream << " " << a.first << "=\"" << encode_xml_entities(a.second) << "\"";
+        }
+        m_open_elements.push_back(name);
+        m_start_tag_open = true;
+    } // start_element()
+
+    void XML_Writer::end_element()
+    {
+        std::string name = m_open_elements.back();
+        m_open_elements.pop_back();
+        if (m_start_tag_open)
+        { // an element without elements and text
+            m_stream << "/>\n";
+            m_start_tag_open = false;
+        }
+        else
+        {
+            m_stream << std::string(2*m_open_elements.size(), ' ') << "</" << name << ">\n";
+        }
+    } // end_element()
+
+    void XML_Writer::text_element(const std::string& name, const std::string& text, const XML_Attributes& attributes)
+    {
+        start_element(name, attributes);
+        if (text.empty())
+        {
+            end_element();
+            return;
+        }
+        m_stream << ">" << encode_xml_entities(text) << "</" << name << ">\n";
+        m_open_elements.pop_back();
+        m_start_tag_open = false;
+    } // text_element()
+
+    XML_Reader::XML_Reader(std::string file_name)
+    {
+        m_file_name = file_name;
+        m_position = 0;
+        std::ifstream input(file_name.c_str(), std::ios::binary);
+        if (!input.is_open())
+        {
+            std::cerr << "Error, could not open XML file \"" << file_name << "\", exiting now... (XML_Stream.hpp)" << std::endl;
+            exit(1);
+        }
+        input.seekg(0, std::ios::end);
+        m_buffer.resize((std::size_t)input.tellg());
+        input.seekg(0, std::ios::beg);
+        input.read(&m_buffer[0], m_buffer.size());
+    } // ctor
+
+    void XML_Reader::error(const std::string& message)
+    {
+        unsigned int line = 1 + std::count(m_buffer.begin(), m_buffer.begin() + std::min(m_position, m_buffer.size()), '\n');
+        std::cerr << "Error in XML file \"" << m_file_name << "\", line " << line << ": " << message << ", exiting now... (XML_Stream.hpp)" << std::endl;
+        exit(1);
+    } // error()
+
+    bool XML_Reader::starts_with(const char* s)
+    {
+        return m_buffer.compare(m_position, std::strlen(s), s) == 0;
+    } // starts_with()
+
+    void XML_Reader::skip_past(const char* s)
+    {
+        std::size_t end = m_buffer.find(s, m_position);
+        if (end == std::string::npos)
+        {
+            error(std::string("expected \"") + s + "\"");
+        }
+        m_position = end + std::strlen(s);
+    } // skip_past()
+
+    void XML_Reader::skip_white_space()
+    {
+        while (m_position < m_buffer.size() && std::isspace((unsigned char)m_buffer[m_position])) m_position++;
+    } // skip_white_space()
+
+    std::string XML_Reader::read_name()
+    {
+        std::size_t begin = m_position;
+        while (m_position < m_buffer.size() && !std::isspace((unsigned char)m_buffer[m_position]) &&
+               std::strchr("/>=", m_buffer[m_position]) == nullptr)
+        {
+            m_position++;
+        }
+        if (m_position == begin)
+        {
+            error("expected a name");
+        }
+        return m_buffer.substr(begin, m_position - begin);
+    } // read_name()
+
+    std::string XML_Reader::decode(const char* first, const char* last)
+    {
+        std::string s;
+        while (first != last)
+        {
+            const char* amp = std::find(first, last, '&');
+            s.append(first, amp);
+            if (amp == last)
+            {
+                break;
+            }
+            const char* semicolon = std::find(amp, last, ';');
+            if (semicolon == last)
+            {
+                error("unterminated entity");
+            }
+            std::string entity(amp + 1, semicolon);
+            if (entity == "lt") s += '<';
+            else if (entity == "gt") s += '>';
+            else if (entity == "amp") s += '&';
+            else if (entity == "quot") s += '"';
+            else if (entity == "apos") s += '\'';
+            else if (entity.size() > 1 && entity[0] == '#')
+            {
+                unsigned long code = std::strtoul(entity.c_str() + ((entity[1] == 'x') ? 2 : 1), nullptr, (entity[1] == 'x') ? 16 : 10);
+                if (code == 0 || code > 127)
+                {
+                    error("only character references to ASCII characters are supported");
+                }
+                s += (char)code;
+            }
+            else
+            {
+                error("unknown entity \"&" + entity + ";\"");
+            }
+            first = semicolon + 1;
+        }
+        return s;
+    } // decode()
+
+    void XML_Reader::parse(XML_Handler& handler)
+    {
+        std::vector<std::string> open_elements;
+        std::string text; // the text of the innermost open element
+        m_position = 0;
+        while (m_position < m_buffer.size())
+        {
+            std::size_t tag = m_buffer.find('<', m_position);
+            if (tag == std::string::npos) tag = m_buffer.size();
+            if (!open_elements.empty())
+            {
+                text += decode(m_buffer.data() + m_position, m_buffer.data() + tag);
+            }
+            m_position = tag;
+            if (m_position == m_buffer.size())
+            {
+                break;
+            }
+
+            if (starts_with("<?")) skip_past("?>");
+            else if (starts_with("<!--")) skip_past("-->");
+            else if (starts_with("<![CDATA["))
+            {
+                m_position += 9;
+                std::size_t end = m_buffer.find("]]>", m_position);
+                if (end == std::string::npos) error("unterminated CDATA section");
+                text.append(m_buffer, m_position, end - m_position);
+                m_position = end + 3;
+            }
+            else if (starts_with("<!")) skip_past(">");
+            else if (starts_with("</"))
+            {
+                m_position += 2;
+                std::string name = read_name();
+                skip_white_space();
+                if (!starts_with(">")) error("expected \">\"");
+                m_position++;
+                if (open_elements.empty() || open_elements.back() != name)
+                {
+                    error("unexpected end tag \"" + name + "\"");
+                }
+                std::size_t first = text.find_first_not_of(" \t\r\n");
+                if (first != std::string::npos)
+                {
+                    std::size_t last = text.find_last_not_of(" \t\r\n") + 1;
+                    handler.text(name, text.data() + first, text.data() + last);
+                }
+                text.clear();
+                handler.end_element(name);
+                open_elements.pop_back();
+            }
+            else
+            {
+                m_position++;
+                std::string name = read_name();
+                XML_Attributes attributes;
+                while (true)
+                {
+                    skip_white_space();
+                    if (m_position == m_buffer.size()) error("unterminated start tag");
+                    if (starts_with(">") || starts_with("/>")) break;
+                    std::string attribute = read_name();
+                    skip_white_space();
+                    if (!starts_with("=")) error("expected \"=\" after attribute \"" + attribute + "\"");
+                    m_position++;
+                    skip_white_space();
+                    char quote = (m_position < m_buffer.size()) ? m_buffer[m_position] : '\0';
+                    if (quote != '"' && quote != '\'') error("expected a quoted value of attribute \"" + attribute + "\"");
+                    std::size_t end = m_buffer.find(quote, m_position + 1);
+                    if (end == std::string::npos) error("unterminated value of attribute \"" + attribute + "\"");
+                    attributes.push_back(std::make_pair(attribute, decode(m_buffer.data() + m_position + 1, m_buffer.data() + end)));
+                    m_position = end + 1;
+                }
+                text.clear(); // text before a child element is not kept
+                handler.start_element(name, attributes);
+                if (starts_with("/>"))
+                {
+                    m_position += 2;
+                    handler.end_element(name);
+                }
+                else
+                {
+                    m_position++;
+                    open_elements.push_back(name);
+                }
+            }
+        }
+        if (!open_elements.empty())
+        {
+            error("element \"" + open_elements.back() + "\" is not closed");
+        }
+    } // parse()
+
+} // namespace XML
+} // namespace BSO
+
+#endif // XML_STREAM_HPP
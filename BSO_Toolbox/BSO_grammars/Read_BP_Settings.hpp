@@ -9,6 +9,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Field_Scanner.hpp>
 
 namespace BSO { namespace Building_Physics {
 
@@ -17,30 +18,20 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
 
     Building_Physics::BP_Simulation* BP_ptr = static_cast<Building_Physics::BP_Simulation*>(BPS); // to be ble to call functions of the child class
 
-    std::fstream input(input_file.c_str()); // open a file stream
-    if (!input)
+    Field_Scanner input(input_file, ","); // reads the file, fields are separated by a ','
+    if (!input.is_open())
     {
         std::cerr << "Error, could not open file "
                   << "\"" << input_file << "\""
                   << ", exiting..." << std::endl;
         exit(1);
     }
-    std::string line; // initialise a string to hold lines being read from file
-    boost::char_separator<char> sep(","); // defines what separates tokens in a string
-    typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
     char type_ID; // holds information about what type of information is described by the line currently read
 
-    while(!input.eof())
-    {
-        getline(input, line); // get the next line from the file
-        boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
-        if (line == "") //skip empty lines (tokenizer does not like it)
-        {
-            continue; // continue to next line
-        }
-        t_tokenizer tok(line, sep); // tokenize the line
-        t_tokenizer::iterator token = tok.begin(); // set iterator to first token
-        type_ID = trim_and_cast_char(*token); // interpret first token as type ID
+    while (input.next_line())
+    { // empty lines are skipped
+        unsigned int token = 0; // index of the current token
+        type_ID = input.get_char(token); // interpret first token as type ID
 
         switch (type_ID)
         {
@@ -53,31 +44,30 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         case 'B':
         { // add the number of warm up days
             token++; // next token holds number of warm up days
-            BPS->m_warm_up_days = trim_and_cast_int(*token);
+            BPS->m_warm_up_days = input.get_int(token);
             break;
         }
         case 'C':
         { // add the number of time steps per hour
             token++; //next token holds number of time steps per hour
-            BPS->m_time_step_hour = trim_and_cast_int(*token);
+            BPS->m_time_step_hour = input.get_int(token);
             break;
         }
         case 'D':
         { // add space settings
             Building_Physics::BP_Space_Settings space_settings;
             token++; // space_set_ID
-            space_settings.m_space_set_ID = *token;
-            boost::algorithm::trim(space_settings.m_space_set_ID);
+            space_settings.m_space_set_ID = input.get_string(token);
             token++; // heating capacity
-            space_settings.m_heating_capacity = trim_and_cast_double(*token);
+            space_settings.m_heating_capacity = input.get_double(token);
             token++; // cooling capacity
-            space_settings.m_cooling_capacity = trim_and_cast_double(*token);
+            space_settings.m_cooling_capacity = input.get_double(token);
             token++; // heating set point
-            space_settings.m_heat_set_point = trim_and_cast_double(*token);
+            space_settings.m_heat_set_point = input.get_double(token);
             token++; // cooling set point
-            space_settings.m_cool_set_point = trim_and_cast_double(*token);
+            space_settings.m_cool_set_point = input.get_double(token);
             token++; // air changes per hour
-            space_settings.m_ACH = trim_and_cast_double(*token);
+            space_settings.m_ACH = input.get_double(token);
 
             BPS->m_space_settings.push_back(space_settings);
             break;
@@ -87,11 +77,9 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
             std::string file_format, file_location; // initialize string to temporarily hold day name
 
 			token++; // file format (unused)
-			file_format =*token;
-			boost::algorithm::trim(file_format); // remove white space in front and at end of string
+			file_format = input.get_string(token);
 			token++; // file location
-			file_location =*token;
-			boost::algorithm::trim(file_location); // remove white space in front and at end of string
+			file_location = input.get_string(token);
 
 			BPS->m_weather_profile = new Building_Physics::BP_Weather_Profile(BP_ptr, file_location); // it is important that the nr of warm up days is declared before the weather profile (consider change in future)
 			BPS->m_indep_states.push_back(BPS->m_weather_profile);
@@ -107,30 +95,28 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
 			boost::posix_time::ptime begin, end;
 			
 			token++; // simulation ID
-			sim_ID = *token;
-			boost::algorithm::trim(sim_ID);
+			sim_ID = input.get_string(token);
 
             token++; // start year
-            year = trim_and_cast_int(*token);
+            year = input.get_int(token);
             token++; // start month
-            month = trim_and_cast_int(*token);
+            month = input.get_int(token);
             token++; // start day
-            day = trim_and_cast_int(*token);
+            day = input.get_int(token);
             token++; // start day name
-            day_name = *token;
-            boost::algorithm::trim(day_name); // remove white space in front and at end of string
+            day_name = input.get_string(token);
             token++; // start hour
-            hour = trim_and_cast_int(*token);
+            hour = input.get_int(token);
             begin = boost::posix_time::ptime(boost::gregorian::date(year, month, day), boost::posix_time::hours(hour));
 
             token++; // finish year
-            year = trim_and_cast_int(*token);
+            year = input.get_int(token);
             token++; // finish month
-            month = trim_and_cast_int(*token);
+            month = input.get_int(token);
             token++; // finish day
-            day = trim_and_cast_int(*token);
+            day = input.get_int(token);
             token++; // finish hour
-            hour = trim_and_cast_int(*token);
+            hour = input.get_int(token);
             end = boost::posix_time::ptime(boost::gregorian::date(year, month, day), boost::posix_time::hours(hour));
 
 			BPS->m_simulation_periods[sim_ID] = std::make_pair(begin, end);
@@ -142,7 +128,7 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         { // add a ground temperature profile (constant here)
             double temperature;
             token++; // Constant ground temperature
-            temperature = trim_and_cast_double(*token);
+            temperature = input.get_double(token);
             BPS->m_ground_profile = new Building_Physics::BP_Ground_Profile(BP_ptr, temperature);
             BPS->m_indep_states.push_back(BPS->m_ground_profile);
             BPS->m_states.push_back(BPS->m_ground_profile);
@@ -152,17 +138,15 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         { // add material properties
             Building_Physics::BP_Material material; // initialize to temporarily hold data
             token++; // Material_ID
-            material.m_material_ID = *token;
-            boost::algorithm::trim(material.m_material_ID);
+            material.m_material_ID = input.get_string(token);
             token++; // material name
-            material.m_name = *token;
-            boost::algorithm::trim(material.m_name);
+            material.m_name = input.get_string(token);
             token++; // specific weight
-            material.m_spec_weight = trim_and_cast_double(*token);
+            material.m_spec_weight = input.get_double(token);
             token++; // specific heat
-            material.m_spec_heat = trim_and_cast_double(*token);
+            material.m_spec_heat = input.get_double(token);
             token++; // thermal conductivity
-            material.m_therm_conductivity = trim_and_cast_double(*token);
+            material.m_therm_conductivity = input.get_double(token);
             BPS->m_materials.push_back(material);
             break;
         }
@@ -170,22 +154,19 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         { // add construction properties
             Building_Physics::BP_Construction construction; // initialize to temporarily hold data
             token++; // Construction_ID
-            construction.m_construction_ID = *token;
-            boost::algorithm::trim(construction.m_construction_ID); // remove white space at front and end of string
+            construction.m_construction_ID = input.get_string(token);
             std::vector<std::string> layer_mat_ID; // will hold material ID of all layers
             std::vector<double> layer_thicknesses; // will hold thicknesses of all layers
             token++; // visualisation ID
-            construction.m_vis_ID = *token;
-            boost::algorithm::trim(construction.m_vis_ID);
+            construction.m_vis_ID = input.get_string(token);
             token++; // material ID
 
-            while (token != tok.end()) // read indefinite number of layers into the construction
+            while (token < input.field_count()) // read indefinite number of layers into the construction
             {
-                std::string mat_ID = *token;
-                boost::algorithm::trim(mat_ID);
+                std::string mat_ID = input.get_string(token);
                 layer_mat_ID.push_back(mat_ID);
                 token++; // layer thickness
-                layer_thicknesses.push_back(trim_and_cast_double(*token));
+                layer_thicknesses.push_back(input.get_double(token));
                 token++; // Material ID or final token
             }
 
@@ -266,15 +247,13 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         { // add glazing properties
             Building_Physics::BP_Glazing glazing;
             token++; // glazing_ID
-            glazing.m_glazing_ID = *token;
-            boost::algorithm::trim(glazing.m_glazing_ID);
+            glazing.m_glazing_ID = input.get_string(token);
             token++; // U-value
-            glazing.m_U_value = trim_and_cast_double(*token);
+            glazing.m_U_value = input.get_double(token);
             token++; // Capacitance per area
-            glazing.m_capacitance_per_area = trim_and_cast_double(*token);
+            glazing.m_capacitance_per_area = input.get_double(token);
             token++; // visualisation ID
-            glazing.m_vis_ID = *token;
-            boost::algorithm::trim(glazing.m_vis_ID);
+            glazing.m_vis_ID = input.get_string(token);
 
             BPS->m_glazings.push_back(glazing);
             break;
@@ -284,16 +263,15 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
             BP_Vis_Setting temp;
 
             token++; // vis_ID
-            temp.m_ID = *token;
-            boost::algorithm::trim(temp.m_ID);
+            temp.m_ID = input.get_string(token);
             token++; // red
-            temp.m_r = trim_and_cast_double(*token);
+            temp.m_r = input.get_double(token);
             token++; // green
-            temp.m_g = trim_and_cast_double(*token);
+            temp.m_g = input.get_double(token);
             token++; // blue
-            temp.m_b = trim_and_cast_double(*token);
+            temp.m_b = input.get_double(token);
             token++; // alpha
-            temp.m_alpha = trim_and_cast_double(*token);
+            temp.m_alpha = input.get_double(token);
 
             BPS->m_vis_settings.push_back(temp);
             break;
@@ -302,13 +280,11 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         { // add a space
             BP_Space_Settings space_settings;
             token++; //space_ID
-            std::string space_ID = *token;
-            boost::algorithm::trim(space_ID);
+            std::string space_ID = input.get_string(token);
             token++; //volume
-            double volume = trim_and_cast_double(*token);
+            double volume = input.get_double(token);
             token++; // Space_Set_ID
-            std::string space_set_ID = *token;
-            boost::algorithm::trim(space_set_ID);
+            std::string space_set_ID = input.get_string(token);
 
             for (unsigned int i = 0; i < BPS->m_space_settings.size(); i++)
             {
@@ -329,11 +305,9 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         case 'M':
         { // add a wall
             token++; // Wall_ID
-            std::string wall_ID = *token;
-            boost::algorithm::trim(wall_ID);
+            std::string wall_ID = input.get_string(token);
             token++; // Construction_ID
-            std::string construction_ID = *token;
-            boost::algorithm::trim(construction_ID);
+            std::string construction_ID = input.get_string(token);
             BP_Construction construction;
             for (unsigned int i = 0; i < BPS->m_constructions.size(); i++)
             {
@@ -343,14 +317,12 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
                 }
             }
             token++; // Surface area
-            double area = trim_and_cast_double(*token);
+            double area = input.get_double(token);
             token++; // Surface Orientation, skipped for now
             token++; // Space ID side one
-            std::string space_ID_1 = *token;
-            boost::algorithm::trim(space_ID_1);
+            std::string space_ID_1 = input.get_string(token);
             token++; // SPace Id side two
-            std::string space_ID_2 = *token;
-            boost::algorithm::trim(space_ID_2);
+            std::string space_ID_2 = input.get_string(token);
 
             BP_State* state_ptr_side_1 = nullptr;
             BP_State* state_ptr_side_2 = nullptr;
@@ -406,13 +378,11 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         case 'N':
         { // add a window
             token++; // window_ID
-            std::string window_ID = *token;
-            boost::algorithm::trim(window_ID);
+            std::string window_ID = input.get_string(token);
             token++; // area
-            double area = trim_and_cast_double(*token);
+            double area = input.get_double(token);
             token++; // glazing_ID
-            std::string glazing_id = *token;
-            boost::algorithm::trim(glazing_id);
+            std::string glazing_id = input.get_string(token);
             BP_Glazing glazing;
             for (unsigned int i = 0; i < BPS->m_glazings.size(); i++)
             {
@@ -423,11 +393,9 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
             }
             token++; // Orientation, skipped for now
             token++; // Space ID side one
-            std::string space_ID_1 = *token;
-            boost::algorithm::trim(space_ID_1);
+            std::string space_ID_1 = input.get_string(token);
             token++; // SPace Id side two
-            std::string space_ID_2 = *token;
-            boost::algorithm::trim(space_ID_2);
+            std::string space_ID_2 = input.get_string(token);
 
             BP_State* state_ptr_side_1 = nullptr;
             BP_State* state_ptr_side_2 = nullptr;
@@ -484,11 +452,9 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
         case 'O':
         { // add a floor
             token++; // floor_ID
-            std::string floor_ID = *token;
-            boost::algorithm::trim(floor_ID);
+            std::string floor_ID = input.get_string(token);
             token++; // Construction_ID
-            std::string construction_ID = *token;
-            boost::algorithm::trim(construction_ID);
+            std::string construction_ID = input.get_string(token);
             BP_Construction construction;
             for (unsigned int i = 0; i < BPS->m_constructions.size(); i++)
             {
@@ -498,13 +464,11 @@ void read_BP_settings(std::string input_file, Building_Physics::BP_Simulation_Va
                 }
             }
             token++; // Surface area
-            double area = trim_and_cast_double(*token);
+            double area = input.get_double(token);
             token++; // Space ID side one
-            std::string space_ID_1 = *token;
-            boost::algorithm::trim(space_ID_1);
+            std::string space_ID_1 = input.get_string(token);
             token++; // SPace Id side two
-            std::string space_ID_2 = *token;
-            boost::algorithm::trim(space_ID_2);
+            std::string space_ID_2 = input.get_string(token);
 
             BP_State* state_ptr_side_1 = nullptr;
             BP_State* state_ptr_side_2 = nullptr;
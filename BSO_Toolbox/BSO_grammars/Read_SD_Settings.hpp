@@ -9,61 +9,51 @@
 #include <boost/algorithm/string.hpp>
 
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Field_Scanner.hpp>
 
 
 namespace BSO { namespace Structural_Design{
 
 void read_SD_settings(std::string input_file, Structural_Design::SD_Analysis_Vars* SD)
 {
-    std::fstream input(input_file.c_str()); // open a file stream
-    if (!input)
+    Field_Scanner input(input_file, ","); // reads the file, fields are separated by a ','
+    if (!input.is_open())
     {
         std::cerr << "Error, could not open file "
                   << "\"" << input_file << "\""
                   << ", exiting..." << std::endl;
         exit(1);
     }
-    std::string line; // initialise a string to hold lines being read from file
-    boost::char_separator<char> sep(","); // defines what separates tokens in a string
-    typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
     char type_ID; // holds information about what type of information is described by the line currently read
 
-    while(!input.eof())
-    {
-        getline(input, line); // get the next line from the file
-        boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
-        if (line == "") //skip empty lines (tokenizer does not like it)
-        {
-            continue; // continue to next line
-        }
-        t_tokenizer tok(line, sep); // tokenize the line
-        t_tokenizer::iterator token = tok.begin(); // set iterator to first token
-        type_ID = trim_and_cast_char(*token); // interpret first token as type ID
+    while (input.next_line())
+    { // empty lines are skipped
+        unsigned int token = 0; // index of the current token
+        type_ID = input.get_char(token); // interpret first token as type ID
 
         switch (type_ID)
         {
         case 'A':
         { // number of divisions to be made by meshing
             token++;
-            SD->m_mesh_division = trim_and_cast_uint(*token);
+            SD->m_mesh_division = input.get_uint(token);
             break;
         }
         case 'B':
         { // defines an abstract loading
             Abstract_Load temp_load;
             token++; // load_ID
-            unsigned int load_ID = trim_and_cast_uint(*token);
+            unsigned int load_ID = input.get_uint(token);
             token++; // load case
-            temp_load.m_lc = trim_and_cast_uint(*token);
+            temp_load.m_lc = input.get_uint(token);
             token++; // load magnitude [N/mm]
-            temp_load.m_magnitude = trim_and_cast_double(*token);
+            temp_load.m_magnitude = input.get_double(token);
             token++; // azimuth [°]
-            temp_load.m_azimuth = trim_and_cast_double(*token);
+            temp_load.m_azimuth = input.get_double(token);
             token++; // altitude [°]
-            temp_load.m_altitude = trim_and_cast_double(*token);
+            temp_load.m_altitude = input.get_double(token);
             token++; // type (string)
-            temp_load.m_type = *token;
-            boost::algorithm::trim(temp_load.m_type);
+            temp_load.m_type = input.get_string(token);
 
             temp_load.calc_direction();
 
@@ -75,12 +65,11 @@ void read_SD_settings(std::string input_file, Structural_Design::SD_Analysis_Var
         { // truss element properties (ID, surface area, younbgs modulus)
             Truss_Props temp;
             token++;
-            temp.m_ID = *token;
-            boost::algorithm::trim(temp.m_ID);
+            temp.m_ID = input.get_string(token);
             token++;
-            temp.m_A = trim_and_cast_double(*token);
+            temp.m_A = input.get_double(token);
             token++;
-            temp.m_E = trim_and_cast_double(*token);
+            temp.m_E = input.get_double(token);
 
             SD->m_truss_props.push_back(temp);
             break;
@@ -89,16 +78,15 @@ void read_SD_settings(std::string input_file, Structural_Design::SD_Analysis_Var
         { // beam element properties (ID, width, height, youngs modulus, poissons ratio)
             Beam_Props temp;
             token++;
-            temp.m_ID = *token;
-            boost::algorithm::trim(temp.m_ID);
+            temp.m_ID = input.get_string(token);
             token++;
-            temp.m_b = trim_and_cast_double(*token);
+            temp.m_b = input.get_double(token);
             token++;
-            temp.m_h = trim_and_cast_double(*token);
+            temp.m_h = input.get_double(token);
             token++;
-            temp.m_E = trim_and_cast_double(*token);
+            temp.m_E = input.get_double(token);
             token++;
-            temp.m_v = trim_and_cast_double(*token);
+            temp.m_v = input.get_double(token);
 
             SD->m_beam_props.push_back(temp);
             break;
@@ -107,14 +95,13 @@ void read_SD_settings(std::string input_file, Structural_Design::SD_Analysis_Var
         { // flat shell element properties (ID, thickness, youngs modulus, poissons ratio)
             Flat_Shell_Props temp;
             token++;
-            temp.m_ID = *token;
-            boost::algorithm::trim(temp.m_ID);
+            temp.m_ID = input.get_string(token);
             token++;
-            temp.m_t = trim_and_cast_double(*token);
+            temp.m_t = input.get_double(token);
             token++;
-            temp.m_E = trim_and_cast_double(*token);
+            temp.m_E = input.get_double(token);
             token++;
-            temp.m_v = trim_and_cast_double(*token);
+            temp.m_v = input.get_double(token);
 
             SD->m_flat_shell_props.push_back(temp);
             break;
@@ -123,14 +110,13 @@ void read_SD_settings(std::string input_file, Structural_Design::SD_Analysis_Var
         { // flat shell element properties (ID, thickness, youngs modulus, poissons ratio)
             Flat_Shell_Props temp;
             token++;
-            temp.m_ID = *token;
-            boost::algorithm::trim(temp.m_ID);
+            temp.m_ID = input.get_string(token);
             token++;
-            temp.m_t = trim_and_cast_double(*token);
+            temp.m_t = input.get_double(token);
             token++;
-            temp.m_E = trim_and_cast_double(*token);
+            temp.m_E = input.get_double(token);
             token++;
-            temp.m_v = trim_and_cast_double(*token);
+            temp.m_v = input.get_double(token);
 
             SD->m_ghost_flat_shell_props.push_back(temp);
             break;
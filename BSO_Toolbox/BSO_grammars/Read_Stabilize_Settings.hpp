@@ -7,6 +7,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <BSO/Trim_And_Cast.hpp>
+#include <BSO/Field_Scanner.hpp>
 
 namespace BSO { namespace Grammar {
 
@@ -24,30 +25,20 @@ Stabilize_Settings read_stabilize_settings(std::string input_file)
 {
     Stabilize_Settings stabilize_settings;
 
-    std::fstream input(input_file.c_str()); // open a file stream
-    if (!input)
+    Field_Scanner input(input_file, ","); // reads the file, fields are separated by a ','
+    if (!input.is_open())
     {
         std::cerr << "Error, could not open file "
                   << "\"" << input_file << "\""
                   << ", exiting..." << std::endl;
         exit(1);
     }
-    std::string line; // initialise a string to hold lines being read from file
-    boost::char_separator<char> sep(","); // defines what separates tokens in a string
-    typedef boost::tokenizer< boost::char_separator<char> > t_tokenizer; // settings for the boost::tokenizer
     char type_ID; // holds information about what type of information is described by the line currently read
 
-    while(!input.eof())
-    {
-        getline(input, line); // get the next line from the file
-        boost::algorithm::trim(line); // remove white space from start and end of line (to see if it is an empty line, remove any incidental white space)
-        if (line == "") //skip empty lines (tokenizer does not like it)
-        {
-            continue; // continue to next line
-        }
-        t_tokenizer tok(line, sep); // tokenize the line
-        t_tokenizer::iterator token = tok.begin(); // set iterator to first token
-        type_ID = trim_and_cast_char(*token); // interpret first token as type ID
+    while (input.next_line())
+    { // empty lines are skipped
+        unsigned int token = 0; // index of the current token
+        type_ID = input.get_char(token); // interpret first token as type ID
 
         switch (type_ID)
         {
@@ -55,8 +46,7 @@ Stabilize_Settings read_stabilize_settings(std::string input_file)
         { // Method settings
             std::string temp_str;
             token++;
-            temp_str = *token;
-            boost::algorithm::trim(temp_str);
+            temp_str = input.get_string(token);
             if (temp_str == "Unzoned")
 				stabilize_settings.method = 0;
             else if (temp_str == "Partially_Zoned")
@@ -68,31 +58,31 @@ Stabilize_Settings read_stabilize_settings(std::string input_file)
         case 'B':
         { // SVD settings
             token++;
-            stabilize_settings.singular = trim_and_cast_double(*token);
+            stabilize_settings.singular = input.get_double(token);
             break;
         }
         case 'C':
         { // Point iteration unzoned
             token++;
-            stabilize_settings.point_it_unzoned = trim_and_cast_uint(*token);
+            stabilize_settings.point_it_unzoned = input.get_uint(token);
             break;
         }
         case 'D':
         { // Zone iteration
             token++;
-            stabilize_settings.zone_it = trim_and_cast_uint(*token);
+            stabilize_settings.zone_it = input.get_uint(token);
             break;
         }
         case 'E':
         { // Point iteration zoned
             token++;
-            stabilize_settings.point_it_zoned = trim_and_cast_uint(*token);
+            stabilize_settings.point_it_zoned = input.get_uint(token);
             break;
         }
         case 'F':
         { // Method settings
 			token++; // delete superfluous trusses?
-			if (trim_and_cast_char(*token) == 'Y')
+			if (input.get_char(token) == 'Y')
 				stabilize_settings.delete_superfluous_trusses = true;
 			else
 				stabilize_settings.delete_superfluous_trusses = false;
@@ -288,19 +288,13 @@ void retrieve_SD_results() {
 
     Zoned = std::make_shared<BSO::Spatial_Design::Zoning::Zoned_Design>(CF.get());
     (*Zoned).make_zoning();
-    for (unsigned int i = 0; i < Zoned->get_designs().size(); i++)
+    std::vector<BSO::Spatial_Design::Zoning::Zoned_SD_Results> zoned_results = Zoned->analyse_zoned_designs(); // also stores the compliances in Zoned
+    for (unsigned int i = 0; i < zoned_results.size(); i++)
     {
-        Zoned->reset_SD_model();
-        Zoned->prepare_zoned_SD_model(i);
-        SD_Building = std::make_shared<BSO::Structural_Design::SD_Analysis>(*CF);
-        (*SD_Building).analyse();
-        sd_results = (*SD_Building).get_results(); // Reuse existing sd_results object
-        BSO::SD_compliance_indexing(sd_results);
         std::cout << "Total compliance in zoned design " << i + 1 << ": "
-            << sd_results.m_total_compliance << std::endl << "Structural volume: " << sd_results.m_struct_volume << std::endl;
-        Zoned->add_compliance(sd_results.m_total_compliance, i);
-        m_compliance.push_back(sd_results.m_total_compliance);
-        m_volume.push_back(sd_results.m_struct_volume);
+            << zoned_results[i].m_total_compliance << std::endl << "Structural volume: " << zoned_results[i].m_struct_volume << std::endl;
+        m_compliance.push_back(zoned_results[i].m_total_compliance);
+        m_volume.push_back(zoned_results[i].m_struct_volume);
     }
     std::cout << std::endl << "Compliances:" << std::endl;
     for (unsigned int i = 0; i < m_compliance.size(); i++)